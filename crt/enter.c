@@ -27,6 +27,7 @@
 #include <myst/syscall.h>
 #include <myst/syscallext.h>
 #include <myst/tee.h>
+#include <myst/vdso.h>
 
 /* Locking functions used by MUSL to manage libc.threads_minus_1 */
 #include <pthread_impl.h>
@@ -53,11 +54,114 @@ static void _create_itimer_thread(void);
 
 static int myst_retrieve_wanted_secrets(void);
 
+/*
+**==============================================================================
+**
+** vDSO fast paths (see myst/vdso.h):
+**
+**==============================================================================
+*/
+
+/* holds the myst_vdso_t pointer of each thread */
+static pthread_key_t _vdso_key;
+static bool _vdso_enabled;
+
+static void _enable_vdso(void)
+{
+    if (pthread_key_create(&_vdso_key, NULL) == 0)
+        _vdso_enabled = true;
+}
+
+static const myst_vdso_t* _get_vdso(void)
+{
+    struct pthread* self = __pthread_self();
+    const myst_vdso_t* vdso = pthread_getspecific(_vdso_key);
+
+    /* fetch the page on first use or if this thread descriptor was reused */
+    if (!vdso || vdso->crt_td != self)
+    {
+        long params[6] = {0};
+        long ret = (*_syscall_callback)(SYS_myst_get_vdso, params);
+
+        /* the kernel declines when it needs to see every syscall */
+        if (ret < 0 && ret > -4096)
+        {
+            _vdso_enabled = false;
+            return NULL;
+        }
+
+        vdso = (const myst_vdso_t*)ret;
+        pthread_setspecific(_vdso_key, vdso);
+    }
+
+    return vdso;
+}
+
+/* called by fork on the copy of the parent's thread descriptor */
+hidden void myst_vdso_reset(struct pthread* thread)
+{
+    if (_vdso_enabled)
+        thread->tsd[_vdso_key] = NULL;
+}
+
+/* returns true if the syscall was answered from the page */
+static bool _vdso_syscall(long n, long* ret)
+{
+    const myst_vdso_t* vdso;
+
+    switch (n)
+    {
+        case SYS_getpid:
+        case SYS_getppid:
+        case SYS_gettid:
+        case SYS_getuid:
+        case SYS_geteuid:
+        case SYS_getgid:
+        case SYS_getegid:
+            break;
+        default:
+            return false;
+    }
+
+    if (!(vdso = _get_vdso()))
+        return false;
+
+    switch (n)
+    {
+        case SYS_getpid:
+            *ret = vdso->pid;
+            break;
+        case SYS_getppid:
+            *ret = vdso->ppid;
+            break;
+        case SYS_gettid:
+            *ret = vdso->tid;
+            break;
+        case SYS_getuid:
+            *ret = vdso->uid;
+            break;
+        case SYS_geteuid:
+            *ret = vdso->euid;
+            break;
+        case SYS_getgid:
+            *ret = vdso->gid;
+            break;
+        case SYS_getegid:
+            *ret = vdso->egid;
+            break;
+    }
+
+    return true;
+}
+
 int myst_pre_launch_hook()
 {
     int ret = 0;
     myst_retrieve_wanted_secrets();
 
+    /* answer trivial syscalls in user space from now on */
+    _enable_vdso();
+
     /* notify the kernel that main() is about to be called */
     {
         long params[6] = {0};
@@ -69,6 +173,14 @@ int myst_pre_launch_hook()
 
 long myst_syscall(long n, long params[6])
 {
+    if (_vdso_enabled)
+    {
+        long ret;
+
+        if (_vdso_syscall(n, &ret))
+            return ret;
+    }
+
     if ((n == SYS_setitimer) || (n == SYS_getitimer))
     {
         /* itimer is requested by SYS_settimer returning EAGAIN. If this happens
@@ -29,6 +29,9 @@
 void __tl_lock(void);
 void __tl_unlock(void);
 
+/* defined in enter.c */
+hidden void myst_vdso_reset(struct pthread* thread);
+
 static void _set_fsbase(void* p)
 {
     if (syscall(SYS_set_thread_area, p) < 0)
@@ -145,6 +148,7 @@ struct pthread* _create_child_pthread_and_copy_stack(
     new->self = new;
     new->tsd = (void*)tsd;
     memcpy(new->tsd, self->tsd, __pthread_tsd_size);
+    myst_vdso_reset(new);
 
     new->detach_state = DT_DETACHED;
     new->robust_list.head = &new->robust_list.head;
@@ -365,12 +365,18 @@ static ssize_t _fs_readv(
 {
     hostfs_t* hostfs = (hostfs_t*)fs;
     ssize_t ret = 0;
+    long tret;
+
+    if (!_hostfs_valid(hostfs) || !_file_valid(file))
+        ERAISE(-EINVAL);
 
-    if (!_hostfs_valid(hostfs) || !file)
+    if (!iov && iovcnt)
         ERAISE(-EINVAL);
 
-    ret = myst_fdops_readv(&fs->fdops, file, iov, iovcnt);
-    ECHECK(ret);
+    /* pass the iovecs to the host rather than reading into a flat buffer */
+    ECHECK((tret = myst_tcall_readv(file->fd, iov, iovcnt)));
+
+    ret = tret;
 
 done:
     return ret;
@@ -384,12 +390,67 @@ static ssize_t _fs_writev(
 {
     hostfs_t* hostfs = (hostfs_t*)fs;
     ssize_t ret = 0;
+    long tret;
+
+    if (!_hostfs_valid(hostfs) || !_file_valid(file))
+        ERAISE(-EINVAL);
+
+    if (!iov && iovcnt)
+        ERAISE(-EINVAL);
+
+    ECHECK((tret = myst_tcall_writev(file->fd, iov, iovcnt)));
+
+    ret = tret;
+
+done:
+    return ret;
+}
+
+static ssize_t _fs_preadv(
+    myst_fs_t* fs,
+    myst_file_t* file,
+    const struct iovec* iov,
+    int iovcnt,
+    off_t offset)
+{
+    hostfs_t* hostfs = (hostfs_t*)fs;
+    ssize_t ret = 0;
+    long tret;
+
+    if (!_hostfs_valid(hostfs) || !_file_valid(file))
+        ERAISE(-EINVAL);
 
-    if (!_hostfs_valid(hostfs) || !file)
+    if (!iov && iovcnt)
         ERAISE(-EINVAL);
 
-    ret = myst_fdops_writev(&fs->fdops, file, iov, iovcnt);
-    ECHECK(ret);
+    ECHECK((tret = myst_tcall_preadv(file->fd, iov, iovcnt, offset)));
+
+    ret = tret;
+
+done:
+    return ret;
+}
+
+static ssize_t _fs_pwritev(
+    myst_fs_t* fs,
+    myst_file_t* file,
+    const struct iovec* iov,
+    int iovcnt,
+    off_t offset)
+{
+    hostfs_t* hostfs = (hostfs_t*)fs;
+    ssize_t ret = 0;
+    long tret;
+
+    if (!_hostfs_valid(hostfs) || !_file_valid(file))
+        ERAISE(-EINVAL);
+
+    if (!iov && iovcnt)
+        ERAISE(-EINVAL);
+
+    ECHECK((tret = myst_tcall_pwritev(file->fd, iov, iovcnt, offset)));
+
+    ret = tret;
 
 done:
     return ret;
@@ -1423,6 +1484,8 @@ int myst_init_hostfs(myst_fs_t** fs_out)
         .fs_pwrite = _fs_pwrite,
         .fs_readv = _fs_readv,
         .fs_writev = _fs_writev,
+        .fs_preadv = _fs_preadv,
+        .fs_pwritev = _fs_pwritev,
         .fs_close = _fs_close,
         .fs_access = _fs_access,
         .fs_stat = _fs_stat,
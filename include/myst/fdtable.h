@@ -15,8 +15,8 @@
 #include <myst/fs.h>
 #include <myst/inotifydev.h>
 #include <myst/pipedev.h>
+#include <myst/rwspinlock.h>
 #include <myst/sockdev.h>
-#include <myst/spinlock.h>
 #include <myst/ttydev.h>
 
 #define MYST_FDTABLE_SIZE 2048
@@ -43,7 +43,7 @@ typedef struct myst_fdtable_entry
 typedef struct myst_fdtable
 {
     myst_fdtable_entry_t entries[MYST_FDTABLE_SIZE];
-    myst_spinlock_t lock;
+    myst_rwspinlock_t lock;
 } myst_fdtable_t;
 
 int myst_fdtable_create(myst_fdtable_t** fdtable_out);
@@ -99,6 +99,22 @@ struct myst_fs
         const struct iovec* iov,
         int iovcnt);
 
+    /* optional: without these, preadv() and pwritev() copy the iovecs to or
+     * from a flat buffer and call fs_pread() or fs_pwrite() */
+    ssize_t (*fs_preadv)(
+        myst_fs_t* fs,
+        myst_file_t* file,
+        const struct iovec* iov,
+        int iovcnt,
+        off_t offset);
+
+    ssize_t (*fs_pwritev)(
+        myst_fs_t* fs,
+        myst_file_t* file,
+        const struct iovec* iov,
+        int iovcnt,
+        off_t offset);
+
     int (*fs_close)(myst_fs_t* fs, myst_file_t* file);
 
     int (*fs_access)(myst_fs_t* fs, const char* pathname, int mode);
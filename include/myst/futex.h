@@ -5,6 +5,7 @@
 #define _MYST_FUTEX_H
 
 #include <myst/types.h>
+#include <sys/syscall.h>
 #include <time.h>
 
 // clang-format off
@@ -19,11 +20,37 @@
 #define FUTEX_TRYLOCK_PI     8
 #define FUTEX_WAIT_BITSET    9
 #define FUTEX_WAKE_BITSET    10
+#define FUTEX_WAIT_MULTIPLE  31
 #define FUTEX_PRIVATE        128
 #define FUTEX_CLOCK_REALTIME 256
 #define FUTEX_BITSET_MATCH_ANY 0xffffffff
+#define FUTEX_32             2
+#define FUTEX_WAITV_MAX      128
 // clang-format on
 
+/* not defined by older C-runtime headers */
+#ifndef SYS_futex_waitv
+#define SYS_futex_waitv 449
+#endif
+
+/* element of the array passed to SYS_futex_waitv (struct futex_waitv) */
+typedef struct myst_futex_waitv
+{
+    uint64_t val;
+    uint64_t uaddr;
+    uint32_t flags;
+    uint32_t __reserved;
+} myst_futex_waitv_t;
+
+/* element of the array passed to FUTEX_WAIT_MULTIPLE (struct futex_wait_block)
+ */
+typedef struct myst_futex_wait_block
+{
+    int* uaddr;
+    int val;
+    int bitset;
+} myst_futex_wait_block_t;
+
 int myst_futex_wait(
     int* uaddr,
     int val,
@@ -32,4 +59,11 @@ int myst_futex_wait(
 
 int myst_futex_wake(int* uaddr, int val, uint32_t bitset);
 
+/* wait on up to FUTEX_WAITV_MAX futexes; returns the index of the futex that
+ * woke the caller or -errno */
+int myst_futex_waitv(
+    const myst_futex_waitv_t* waiters,
+    size_t nwaiters,
+    const struct timespec* to);
+
 #endif /* _MYST_FUTEX_H */
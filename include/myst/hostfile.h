@@ -12,4 +12,7 @@
 // not include the terminator in the size)
 int myst_load_host_file(const char* path, void** data, size_t* size);
 
+// Create (or truncate) a file on the host file system and write data to it
+int myst_write_host_file(const char* path, const void* data, size_t size);
+
 #endif /* _MYST_HOSTFILE_H */
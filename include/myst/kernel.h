@@ -12,6 +12,9 @@
 #include <myst/uid_gid.h>
 #include <signal.h>
 
+/* the largest value of the --console-buffer-size option */
+#define MYST_MAX_CONSOLE_BUFFER_SIZE (1024 * 1024)
+
 /* Information used for a specific automatic mount point that is mounted on
  * start. flags, public_keys and roothash are currently not used, but are
  * available in the configuration parser for when we start using them. Target is
@@ -74,6 +77,12 @@ typedef struct _myst_strace_config
     /* Is filtering enabled or not */
     bool filter;
 
+    /* Record syscalls in binary form (see myst/stracebin.h) */
+    bool binary;
+
+    /* Host file that the binary records are written to at shutdown */
+    char binary_path[PATH_MAX];
+
     /*
         If filter is enabled, should the given syscall be traced or not.
         Note: ausyscall --dump shows that maximum syscall value on Ubuntu 18.04
@@ -193,12 +202,19 @@ typedef struct myst_kernel_args
     myst_strace_config_t strace_config;
     bool trace_times;
 
+    /* Record spans and write them to this host file (see myst/spantrace.h) */
+    bool trace_spans;
+    char trace_spans_path[PATH_MAX];
+
     /* Whether the target supports the SYSCALL instruction */
     bool have_syscall_instruction;
 
     /* Whether the target supports the WRFSBASE and WRGSBASE instructions */
     bool have_fsgsbase_instructions;
 
+    /* Whether the target can execute RDTSC without trapping */
+    bool have_rdtsc_instruction;
+
     /* The event object for the main thread */
     uint64_t event;
 
@@ -223,6 +239,12 @@ typedef struct myst_kernel_args
     /* true if --perf option present -- print performance statistics */
     bool perf;
 
+    /* true if --profile option present -- sample the running threads */
+    bool profile;
+
+    /* Host file that the folded stacks are written to at shutdown */
+    char profile_path[PATH_MAX];
+
     /* true if --report-native-tids is present */
     bool report_native_tids;
 
@@ -239,6 +261,19 @@ typedef struct myst_kernel_args
     // CPUs reported by sched_getaffinity().
     size_t max_affinity_cpus;
 
+    // From the --mn-threads=<num> option. If non-zero, threads are
+    // multiplexed onto at most this many host threads (see myst/mnsched.h).
+    size_t mn_threads;
+
+    // From the --console-buffer-size=<size> option. If non-zero, output to
+    // the standard output and standard error is buffered in the kernel (see
+    // myst/ttydev.h). At most MYST_MAX_CONSOLE_BUFFER_SIZE bytes.
+    size_t console_buffer_size;
+
+    // Whether the standard output of the host is a terminal, in which case
+    // buffered console output is flushed at the end of each line.
+    bool console_isatty;
+
     // mode the fork implementation uses.
     // selection between a fork/exec model,
     // or a more traditional fork model with limits
@@ -253,6 +288,9 @@ typedef struct myst_kernel_args
     /* pointer to myst_handle_host_signal(). Set by myst_enter_kernel */
     void (*myst_handle_host_signal)(siginfo_t* siginfo, mcontext_t* context);
 
+    /* pointer to myst_profile_sample(). Set by myst_enter_kernel */
+    void (*myst_profile_sample)(const mcontext_t* mcontext, pid_t tid);
+
     /* pointer to myst_signal_restore_mask(). Set by myst_enter_kernel */
     void (*myst_signal_restore_mask)(void);
 
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef _MYST_MMSGBUF_H
+#define _MYST_MMSGBUF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <myst/defs.h>
+
+/*
+**==============================================================================
+**
+** flattened message vectors:
+**
+**     The messages of a sendmmsg() or recvmmsg() cross the enclave boundary
+**     in one OCALL as an array of headers plus one data buffer. The data
+**     buffer holds the name, the control data and the payload of each
+**     message in turn, each starting on an 8-byte boundary (as required by
+**     cmsg headers). For recvmmsg(), the lengths of a header are capacities
+**     on input and what was received on output; the enclave never derives
+**     the layout from the output.
+**
+**==============================================================================
+*/
+
+/* the most messages per OCALL (UIO_MAXIOV, which also caps vlen on Linux) */
+#define MYST_MMSGBUF_MAX_VLEN 1024
+
+struct myst_mmsgbuf_hdr
+{
+    uint64_t len; /* payload length (msg_len on output) */
+    uint32_t namelen;
+    uint32_t controllen;
+    int32_t flags; /* msg_flags (recvmmsg() only) */
+    uint32_t padding;
+};
+
+MYST_INLINE size_t myst_mmsgbuf_align(size_t n)
+{
+    return (n + 7) & ~(size_t)7;
+}
+
+/* Take the next region of len bytes from a data buffer of the given size.
+ * Return its offset or -1 if it does not fit.
+ */
+MYST_INLINE long myst_mmsgbuf_take(size_t size, size_t* offset, uint64_t len)
+{
+    const size_t off = *offset;
+
+    if (off > size || len > size - off)
+        return -1;
+
+    *offset = off + myst_mmsgbuf_align(len);
+
+    if (*offset > size)
+        *offset = size;
+
+    return (long)off;
+}
+
+#endif /* _MYST_MMSGBUF_H */
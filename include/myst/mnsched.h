@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef _MYST_MNSCHED_H
+#define _MYST_MNSCHED_H
+
+#include <time.h>
+
+#include <myst/defs.h>
+#include <myst/setjmp.h>
+#include <myst/types.h>
+
+/*
+**==============================================================================
+**
+** M:N scheduling:
+**
+**     When the --mn-threads=<n> option is given, threads created by clone()
+**     are multiplexed onto at most <n> host threads (carriers) rather than
+**     each being backed by its own host thread. A multiplexed thread that
+**     waits on its event (futexes, mutexes, condition variables, nanosleep)
+**     switches to its carrier, which runs the next runnable thread instead
+**     of parking the host thread. Scheduling is cooperative: a thread keeps
+**     its carrier until it waits, yields, or exits.
+**
+**     The events of multiplexed threads are tagged with MYST_MN_EVENT_TAG,
+**     which lets myst_tcall_wait() and myst_tcall_wake() tell them apart from
+**     host events.
+**
+**==============================================================================
+*/
+
+struct myst_thread;
+struct myst_mn_carrier;
+
+/* low bit of the event of a multiplexed thread (host events are aligned) */
+#define MYST_MN_EVENT_TAG 0x1UL
+
+typedef enum myst_mn_state
+{
+    MYST_MN_RUNNING = 0,
+    MYST_MN_RUNNABLE,
+    MYST_MN_WAITING,
+} myst_mn_state_t;
+
+/* the M:N scheduling state of a thread (see myst_thread_t.mn) */
+typedef struct myst_mn_thread
+{
+    /* true if this thread is multiplexed onto the carriers */
+    bool enabled;
+
+    /* true once the thread has been started on a carrier */
+    bool started;
+
+    /* true once the carrier has switched away from this thread */
+    bool parked;
+
+    /* true if the last wait was ended by its timeout */
+    bool timed_out;
+
+    myst_mn_state_t state;
+
+    /* number of wakeups that have not been consumed by a wait */
+    uint32_t tokens;
+
+    /* index of this thread in the slot table (encoded into the event) */
+    uint32_t slot;
+
+    /* when the current wait times out (monotonic nanoseconds) or zero */
+    uint64_t deadline;
+
+    /* links for the run queue and the timer list */
+    struct myst_thread* run_next;
+    struct myst_thread* timer_prev;
+    struct myst_thread* timer_next;
+
+    /* the carrier that is running (or last ran) this thread */
+    struct myst_mn_carrier* carrier;
+
+    /* the context saved while the thread is switched out */
+    myst_jmp_buf_t ctx;
+} myst_mn_thread_t;
+
+MYST_INLINE bool myst_mn_is_event(uint64_t event)
+{
+    return (event & MYST_MN_EVENT_TAG) ? true : false;
+}
+
+/* true if the --mn-threads option is in effect */
+bool myst_mn_enabled(void);
+
+/* make a new thread multiplexed and queue it; sets *need_carrier if the
+ * caller must create a host thread (myst_tcall_create_thread) to run it */
+long myst_mn_start_thread(struct myst_thread* thread, bool* need_carrier);
+
+/* called by myst_run_thread() to turn the calling host thread into a carrier
+ * whose first thread is the given one; returns once no threads are left */
+long myst_mn_run_carrier(
+    struct myst_thread* thread,
+    uint64_t event,
+    pid_t target_tid);
+
+/* called by an exiting thread to have its carrier free it (does not return) */
+MYST_NORETURN void myst_mn_exit_thread(struct myst_thread* thread);
+
+/* implementations of myst_tcall_wait() and myst_tcall_wake() for events of
+ * multiplexed threads */
+long myst_mn_wait(uint64_t event, const struct timespec* timeout);
+long myst_mn_wake(uint64_t event);
+
+/* let other runnable threads use the carrier of the calling thread */
+long myst_mn_yield(struct myst_thread* thread);
+
+/* nanosleep() that releases the carrier while sleeping */
+long myst_mn_sleep(const struct timespec* req, struct timespec* rem);
+
+#endif /* _MYST_MNSCHED_H */
@@ -15,19 +15,30 @@ typedef struct myst_options
 {
     bool have_syscall_instruction;
     bool have_fsgsbase_instructions;
+    bool have_rdtsc_instruction;
     bool trace_errors;
     bool trace_times;
+    bool trace_spans;
     bool debug_symbols;
     bool memcheck;
     bool nobrk;
     bool exec_stack;
     bool perf;
+    bool profile;
     bool report_native_tids;
     bool unhandled_syscall_enosys;
     bool host_uds;
+    bool console_isatty;
     size_t main_stack_size;
     size_t thread_stack_size;
     size_t max_affinity_cpus;
+    size_t mn_threads;
+    size_t console_buffer_size;
+    size_t profile_hz;
+    size_t tcall_workers;
+    size_t tcall_spin;
+    char profile_path[PATH_MAX];
+    char trace_spans_path[PATH_MAX];
     char rootfs[PATH_MAX];
     myst_fork_mode_t fork_mode;
     myst_host_enc_uid_gid_mappings host_enc_uid_gid_mappings;
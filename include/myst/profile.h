@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef _MYST_PROFILE_H
+#define _MYST_PROFILE_H
+
+#include <signal.h>
+#include <sys/types.h>
+
+#include <myst/types.h>
+
+/*
+**==============================================================================
+**
+** sampling profiler:
+**
+**     With the --profile=<host-path> option, the target interrupts the
+**     running threads with a periodic timer and passes the interrupted
+**     context to myst_profile_sample(), which records the RIP and the
+**     frame-pointer chain above it into a fixed array of samples. The
+**     sampler takes no locks and does not touch thread-local storage, so it
+**     is safe to call from a host signal handler that interrupted either
+**     kernel or application code. Samples that do not fit are counted and
+**     dropped.
+**
+**     At shutdown the samples are symbolized against the kernel symbol
+**     tables and against the files registered with myst_add_symbol_file()
+**     and written to the host file as folded stacks, one per line:
+**
+**         thread-<tid>;<outermost-frame>;...;<innermost-frame> <count>
+**
+**     which is the input format of flamegraph.pl. Kernel frames carry a
+**     "_[k]" suffix. Only the Linux target supports sampling since SGX hides
+**     the interrupted context of enclave threads.
+**
+**==============================================================================
+*/
+
+/* maximum number of samples kept */
+#define MYST_PROFILE_MAX_SAMPLES 16384
+
+/* maximum number of frames recorded per sample */
+#define MYST_PROFILE_MAX_DEPTH 32
+
+/* default sampling frequency (samples per second of CPU time) */
+#define MYST_PROFILE_DEFAULT_HZ 997
+
+/* allocate the samples if the --profile option was given */
+int myst_profile_init(void);
+
+/* record the context interrupted by the profiling timer */
+void myst_profile_sample(const mcontext_t* mcontext, pid_t tid);
+
+/* keep the function symbols of a file loaded at [text, text+text_size) */
+int myst_profile_add_symbol_file(
+    const char* path,
+    const void* file_data,
+    size_t file_size,
+    const void* text,
+    size_t text_size);
+
+/* stop sampling and write the folded stacks to the --profile host file */
+int myst_profile_dump(void);
+
+#endif /* _MYST_PROFILE_H */
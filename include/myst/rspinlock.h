@@ -8,6 +8,7 @@
 
 #include <myst/spinlock.h>
 #include <myst/thread.h>
+#include <myst/ticketlock.h>
 
 // clang-format off
 #define MYST_RSPINLOCK_INITIALIZER { 0 }
@@ -19,7 +20,7 @@ typedef struct myst_rspinlock
     myst_spinlock_t owner_lock;
     void* owner;
     _Atomic(size_t) count;
-    myst_spinlock_t lock;
+    myst_ticketlock_t lock;
 } myst_rspinlock_t;
 
 MYST_INLINE void* __myst_rspin_self(void)
@@ -46,7 +47,7 @@ MYST_INLINE void myst_rspin_lock(myst_rspinlock_t* s)
     myst_spin_unlock(&s->owner_lock);
 
     /* wait on the lock */
-    myst_spin_lock(&s->lock);
+    myst_ticket_lock(&s->lock);
     s->owner = __myst_rspin_self();
     s->count = 1;
 }
@@ -59,7 +60,7 @@ MYST_INLINE void myst_rspin_unlock(myst_rspinlock_t* s)
     if (--s->count == 0)
     {
         s->owner = NULL;
-        myst_spin_unlock(&s->lock);
+        myst_ticket_unlock(&s->lock);
     }
 }
 
@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef _MYST_RWSPINLOCK_H
+#define _MYST_RWSPINLOCK_H
+
+#include <myst/defs.h>
+#include <myst/types.h>
+
+// clang-format off
+#define MYST_RWSPINLOCK_INITIALIZER { 0 }
+// clang-format on
+
+/* state bits: writer holds the lock, writer is waiting for the lock */
+#define __MYST_RWSPIN_WRITER 0x1U
+#define __MYST_RWSPIN_PENDING 0x2U
+#define __MYST_RWSPIN_WMASK 0x3U
+
+/* each reader adds this amount to the state */
+#define __MYST_RWSPIN_READER 0x4U
+
+/* reader-writer spinlock type (writers are given preference over readers) */
+typedef struct myst_rwspinlock
+{
+    volatile uint32_t state;
+} myst_rwspinlock_t;
+
+MYST_INLINE void myst_rw_read_lock(myst_rwspinlock_t* s)
+{
+    for (;;)
+    {
+        uint32_t state = s->state;
+
+        /* new readers hold off while a writer is active or pending */
+        if (!(state & __MYST_RWSPIN_WMASK))
+        {
+            const uint32_t new_state = state + __MYST_RWSPIN_READER;
+
+            if (__sync_bool_compare_and_swap(&s->state, state, new_state))
+                break;
+        }
+
+        __asm__ __volatile__("pause" : : : "memory");
+    }
+}
+
+MYST_INLINE void myst_rw_read_unlock(myst_rwspinlock_t* s)
+{
+    __sync_fetch_and_sub(&s->state, __MYST_RWSPIN_READER);
+}
+
+MYST_INLINE void myst_rw_write_lock(myst_rwspinlock_t* s)
+{
+    for (;;)
+    {
+        uint32_t state = s->state;
+
+        /* acquire once the readers have drained and no writer is active */
+        if ((state & ~__MYST_RWSPIN_PENDING) == 0)
+        {
+            if (__sync_bool_compare_and_swap(
+                    &s->state, state, __MYST_RWSPIN_WRITER))
+                break;
+        }
+        else if (!(state & __MYST_RWSPIN_PENDING))
+        {
+            /* block new readers until this writer gets in */
+            __sync_fetch_and_or(&s->state, __MYST_RWSPIN_PENDING);
+        }
+
+        __asm__ __volatile__("pause" : : : "memory");
+    }
+}
+
+MYST_INLINE void myst_rw_write_unlock(myst_rwspinlock_t* s)
+{
+    __sync_fetch_and_and(&s->state, ~__MYST_RWSPIN_WRITER);
+}
+
+#endif /* _MYST_RWSPINLOCK_H */
@@ -6,10 +6,14 @@
 
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <time.h>
 
 #include <myst/defs.h>
 #include <myst/fdops.h>
 
+/* defined by <sys/socket.h> only when _GNU_SOURCE is defined */
+struct mmsghdr;
+
 typedef struct myst_sockdev myst_sockdev_t;
 
 typedef struct myst_sock myst_sock_t;
@@ -84,6 +88,23 @@ struct myst_sockdev
         struct msghdr* msg,
         int flags);
 
+    /* optional: without these, sendmmsg() and recvmmsg() call sd_sendmsg()
+     * or sd_recvmsg() once per message */
+    int (*sd_sendmmsg)(
+        myst_sockdev_t* sd,
+        myst_sock_t* sock,
+        struct mmsghdr* msgvec,
+        unsigned int vlen,
+        int flags);
+
+    int (*sd_recvmmsg)(
+        myst_sockdev_t* sd,
+        myst_sock_t* sock,
+        struct mmsghdr* msgvec,
+        unsigned int vlen,
+        int flags,
+        const struct timespec* timeout);
+
     int (*sd_shutdown)(myst_sockdev_t* sd, myst_sock_t* sock, int how);
 
     int (*sd_getsockopt)(
@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef _MYST_SPANTRACE_H
+#define _MYST_SPANTRACE_H
+
+#include <myst/types.h>
+
+/*
+**==============================================================================
+**
+** span tracing:
+**
+**     With the --trace-spans=<host-path> option, the kernel records a span
+**     (a category, a name, a start and an end time) for each boot phase,
+**     each exec, each tcall, each path-based file system operation and each
+**     syscall. Spans are appended to a fixed array without locking; once it
+**     is full later spans are counted and dropped, which keeps the start-up
+**     spans that the option is mostly meant for. At shutdown the spans are
+**     written to the host file in the Chrome trace event format, which can
+**     be loaded into chrome://tracing or https://ui.perfetto.dev.
+**
+**     The names must be string literals since they are only formatted at
+**     shutdown. Spans of the "syscall" and "tcall" categories may pass a
+**     NULL name, in which case the name is derived from the number given by
+**     the arg parameter.
+**
+**==============================================================================
+*/
+
+/* maximum number of spans kept */
+#define MYST_SPANTRACE_MAX_SPANS 65536
+
+/* allocate the spans if the --trace-spans option was given */
+int myst_spantrace_init(void);
+
+/* return the start time of a span (zero if span tracing is off) */
+uint64_t myst_span_begin(void);
+
+/* record a span that started at the time returned by myst_span_begin() */
+void myst_span_end(const char* cat, const char* name, long arg, uint64_t start);
+
+/* record a span with the given start and end times (in ticks) */
+void myst_span_record(
+    const char* cat,
+    const char* name,
+    long arg,
+    uint64_t start,
+    uint64_t end);
+
+/* write the spans to the --trace-spans host file */
+int myst_spantrace_dump(void);
+
+#endif /* _MYST_SPANTRACE_H */
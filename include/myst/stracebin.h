@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef _MYST_STRACEBIN_H
+#define _MYST_STRACEBIN_H
+
+#include <sys/types.h>
+
+#include <myst/types.h>
+
+/*
+**==============================================================================
+**
+** binary strace:
+**
+**     With the --strace-binary=<host-path> option, the kernel records every
+**     syscall that returns as a fixed-size myst_strace_record_t in a ring
+**     instead of formatting text. Threads claim slots with an atomic
+**     increment, so recording takes no lock; once the ring is full the
+**     oldest records are overwritten. At shutdown the ring is written to the
+**     host file as a myst_strace_header_t followed by the records, oldest
+**     first, and tools/strace-decode renders them as strace-style text.
+**
+**==============================================================================
+*/
+
+#define MYST_STRACE_MAGIC 0x4543415254535953 /* "SYSTRACE" */
+#define MYST_STRACE_VERSION 1
+
+/* number of records kept by the ring */
+#define MYST_STRACE_RING_SIZE 65536
+
+typedef struct myst_strace_header
+{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t record_size;
+
+    /* number of records that follow the header */
+    uint64_t num_records;
+
+    /* number of records that were overwritten before the ring was dumped */
+    uint64_t num_dropped;
+
+    /* nanoseconds per tick as a 32.32 fixed-point number (zero when the
+     * ticks are nanoseconds; see myst/times.h) */
+    uint64_t ticks_mult;
+} myst_strace_header_t;
+
+typedef struct myst_strace_record
+{
+    /* one more than the index of the record (zero while being written) */
+    uint64_t seq;
+
+    /* when the thread entered and left the kernel (in ticks) */
+    uint64_t enter_ticks;
+    uint64_t leave_ticks;
+
+    long n;
+    long params[6];
+    long ret;
+
+    pid_t pid;
+    pid_t tid;
+} myst_strace_record_t;
+
+/* allocate the ring if the --strace-binary option was given */
+int myst_strace_init(void);
+
+/* record a syscall of the calling thread that is about to return */
+void myst_strace_record(long n, const long params[6], long ret);
+
+/* write the ring to the host file given by --strace-binary */
+int myst_strace_dump(void);
+
+#endif /* _MYST_STRACEBIN_H */
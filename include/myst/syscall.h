@@ -233,6 +233,13 @@ long myst_syscall_futex(
     int* uaddr2,
     int val3);
 
+long myst_syscall_futex_waitv(
+    const myst_futex_waitv_t* waiters,
+    unsigned int nr_futexes,
+    unsigned int flags,
+    const struct timespec* timeout,
+    clockid_t clockid);
+
 long myst_syscall_sched_getparam(pid_t pid, struct sched_param* param);
 long myst_syscall_getrandom(void* buf, size_t buflen, unsigned int flags);
 
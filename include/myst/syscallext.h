@@ -30,6 +30,8 @@ typedef enum
     SYS_myst_get_exec_stack_option = 2018,
     SYS_myst_interrupt_thread = 2019,
     SYS_myst_pre_launch_hook = 2020,
+    SYS_myst_get_vdso = 2021,
+    SYS_myst_batch = 2022,
     /* ATTN: when removing any of these, scan for any hardcoded number usage */
 } myst_syscall_t;
 
@@ -55,4 +57,33 @@ typedef struct myst_fork_info
         myst_fork_none, false, false \
     }
 
+/* Used for SYS_myst_batch parameters:
+ *
+ *     long syscall(SYS_myst_batch, myst_batch_entry_t* entries, size_t count,
+ *         int flags);
+ *
+ * Runs the entries in order within a single kernel entry and stores the
+ * result of each in its ret field. Entries that were not run (because a
+ * linked entry failed or because of MYST_BATCH_STOP_ON_ERROR) are set to
+ * -ECANCELED. Returns the number of entries considered, which is less than
+ * count only when MYST_BATCH_STOP_ON_ERROR stopped the batch early.
+ */
+typedef struct myst_batch_entry
+{
+    long n;
+    long params[6];
+    long ret;
+    uint32_t flags;
+    uint32_t reserved;
+} myst_batch_entry_t;
+
+/* myst_batch_entry_t.flags: run the next entry only if this one succeeds */
+#define MYST_BATCH_LINK 0x1
+
+/* SYS_myst_batch flags: run no more entries once one fails */
+#define MYST_BATCH_STOP_ON_ERROR 0x1
+
+/* SYS_myst_batch fails with EINVAL if count exceeds this */
+#define MYST_BATCH_MAX 1024
+
 #endif /* _MYST_SYSCALLEXT_H */
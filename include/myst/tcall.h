@@ -11,6 +11,7 @@
 #include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -18,6 +19,9 @@
 #include <myst/defs.h>
 #include <myst/fssig.h>
 
+/* defined by <sys/socket.h> only when _GNU_SOURCE is defined */
+struct mmsghdr;
+
 typedef enum myst_tcall_number
 {
     MYST_TCALL_RANDOM = 2048,
@@ -69,6 +73,9 @@ typedef enum myst_tcall_number
     MYST_TCALL_TD_SET_EXCEPTION_HANDLER_STACK,
     MYST_TCALL_TD_REGISTER_EXCEPTION_HANDLER_STACK,
     MYST_TCALL_TD_UNREGISTER_EXCEPTION_HANDLER_STACK,
+    MYST_TCALL_WAKE_MANY,
+    MYST_TCALL_SENDMMSG_BLOCK,
+    MYST_TCALL_RECVMMSG_BLOCK,
 } myst_tcall_number_t;
 
 long myst_tcall(long n, long params[6]);
@@ -97,6 +104,14 @@ long myst_tcall_wait(uint64_t event, const struct timespec* timeout);
 /* returns the number of waiters that were woken up or -errno */
 long myst_tcall_wake(uint64_t event);
 
+/* the maximum number of events that callers pass to myst_tcall_wake_many() */
+#define MYST_TCALL_WAKE_BATCH_SIZE 32
+
+/* wakes several events with a single transition to the target; every event
+ * is woken even if waking an earlier one fails; returns the total number of
+ * waiters that were woken up or the first -errno */
+long myst_tcall_wake_many(const uint64_t* events, size_t count);
+
 /* returns zero or -errno */
 long myst_tcall_wake_wait(
     uint64_t waiter_event,
@@ -184,6 +199,22 @@ long myst_tcall_read(int fd, void* buf, size_t count);
 
 long myst_tcall_write(int fd, const void* buf, size_t count);
 
+long myst_tcall_readv(int fd, const struct iovec* iov, int iovcnt);
+
+long myst_tcall_writev(int fd, const struct iovec* iov, int iovcnt);
+
+long myst_tcall_preadv(
+    int fd,
+    const struct iovec* iov,
+    int iovcnt,
+    off_t offset);
+
+long myst_tcall_pwritev(
+    int fd,
+    const struct iovec* iov,
+    int iovcnt,
+    off_t offset);
+
 long myst_tcall_poll(struct pollfd* fds, nfds_t nfds, int timeout);
 
 long myst_tcall_pipe2(int pipefd[2], int flags);
@@ -229,6 +260,20 @@ ssize_t myst_tcall_sendmsg(int sockfd, const struct msghdr* msg, int flags);
 
 ssize_t myst_tcall_recvmsg(int sockfd, struct msghdr* msg, int flags);
 
+/* send or receive up to vlen messages with a single transition to the target;
+ * returns the number of messages that were transferred or -errno */
+long myst_tcall_sendmmsg(
+    int sockfd,
+    struct mmsghdr* msgvec,
+    unsigned int vlen,
+    int flags);
+
+long myst_tcall_recvmmsg(
+    int sockfd,
+    struct mmsghdr* msgvec,
+    unsigned int vlen,
+    int flags);
+
 long myst_tcall_read_block(int fd, void* buf, size_t count);
 
 long myst_tcall_write_block(int fd, const void* buf, size_t count);
@@ -267,6 +312,18 @@ ssize_t myst_tcall_sendmsg_block(
 
 ssize_t myst_tcall_recvmsg_block(int sockfd, struct msghdr* msg, int flags);
 
+long myst_tcall_sendmmsg_block(
+    int sockfd,
+    struct mmsghdr* msgvec,
+    unsigned int vlen,
+    int flags);
+
+long myst_tcall_recvmmsg_block(
+    int sockfd,
+    struct mmsghdr* msgvec,
+    unsigned int vlen,
+    int flags);
+
 long myst_tcall_td_set_exception_handler_stack(
     void* td,
     void* stack,
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef _MYST_TCALLRING_H
+#define _MYST_TCALLRING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <myst/defs.h>
+
+/*
+**==============================================================================
+**
+** switchless tcall ring:
+**
+**     A bounded multi-producer/multi-consumer queue of requests that host
+**     worker threads perform on behalf of their callers. On the linux target
+**     the callers are the kernel threads; on the SGX target they are enclave
+**     threads, which find the ring (and place their requests) in host memory
+**     and so submit tcalls without leaving the enclave. Each cell carries a
+**     sequence number that tells producers and consumers whose turn it is, so
+**     neither side takes a lock.
+**
+**==============================================================================
+*/
+
+/* the number of requests the ring holds; callers that find the ring full
+ * perform their tcall themselves */
+#define MYST_TCALL_RING_SIZE 1024
+
+#define MYST_TCALL_RING_MASK (MYST_TCALL_RING_SIZE - 1)
+
+enum
+{
+    MYST_TCALL_REQUEST_PENDING,
+    MYST_TCALL_REQUEST_DONE,
+    MYST_TCALL_REQUEST_WAITING,
+};
+
+typedef struct myst_tcall_request
+{
+    long n;
+    long params[6];
+    long ret;
+    int state;
+    bool declined; /* the worker left the tcall to the caller */
+} myst_tcall_request_t;
+
+typedef struct myst_tcall_ring_cell
+{
+    size_t seq;
+    myst_tcall_request_t* request;
+} myst_tcall_ring_cell_t;
+
+typedef struct myst_tcall_ring
+{
+    myst_tcall_ring_cell_t cells[MYST_TCALL_RING_SIZE];
+
+    /* keep the producer and consumer positions on separate cache lines */
+    size_t enqueue_pos __attribute__((aligned(64)));
+    size_t dequeue_pos __attribute__((aligned(64)));
+
+    /* the number of parked workers and the futex they wait on */
+    int num_sleeping __attribute__((aligned(64)));
+    int wake_seq;
+
+    /* how many times waiting callers and idle workers poll before parking */
+    size_t spin;
+} myst_tcall_ring_t;
+
+/* Add a request to the ring. Return false if the ring is full. */
+MYST_INLINE bool myst_tcall_ring_enqueue(
+    myst_tcall_ring_t* ring,
+    myst_tcall_request_t* request)
+{
+    size_t pos = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_RELAXED);
+    myst_tcall_ring_cell_t* cell;
+
+    for (;;)
+    {
+        cell = &ring->cells[pos & MYST_TCALL_RING_MASK];
+        size_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (diff == 0)
+        {
+            if (__atomic_compare_exchange_n(
+                    &ring->enqueue_pos,
+                    &pos,
+                    pos + 1,
+                    true,
+                    __ATOMIC_RELAXED,
+                    __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            /* the ring is full */
+            return false;
+        }
+        else
+        {
+            pos = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    cell->request = request;
+    __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+/* Whether a worker must be woken after a request was enqueued */
+MYST_INLINE bool myst_tcall_ring_has_sleepers(myst_tcall_ring_t* ring)
+{
+    /* pairs with the fence implied by the sleeper count increment */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    return __atomic_load_n(&ring->num_sleeping, __ATOMIC_RELAXED) != 0;
+}
+
+#endif /* _MYST_TCALLRING_H */
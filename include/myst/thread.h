@@ -18,10 +18,13 @@
 #include <myst/futex.h>
 #include <myst/kstack.h>
 #include <myst/limit.h>
+#include <myst/mnsched.h>
+#include <myst/rwspinlock.h>
 #include <myst/setjmp.h>
 #include <myst/spinlock.h>
 #include <myst/tcall.h>
 #include <myst/types.h>
+#include <myst/vdso.h>
 
 #define MYST_THREAD_MAGIC 0xc79c53d9ad134ad4
 #define MYST_MAX_MUNNAP_ON_EXIT 5
@@ -76,7 +79,7 @@ typedef struct myst_thread_sig_handler
 
 bool myst_valid_td(const void* td);
 
-extern myst_spinlock_t myst_process_list_lock;
+extern myst_rwspinlock_t myst_process_list_lock;
 
 typedef struct
 {
@@ -164,6 +167,19 @@ struct myst_process
     struct myst_process* zombie_next;
     struct myst_process* zombie_prev;
 
+    /* set once the process has been moved onto the zombie list */
+    bool is_zombie;
+
+    /* next process in the same pid hash bucket (live and zombie processes) */
+    struct myst_process* pid_hash_next;
+
+    /* parent-to-children index (live and zombie children). The parent link
+     * is cleared when the parent process is freed. */
+    struct myst_process* parent;
+    struct myst_process* children;
+    struct myst_process* sibling_prev;
+    struct myst_process* sibling_next;
+
     /* If the clone is vfork mode, we may need to signal the parents
      * initiation thread when an exec or exit is called from the child.
      *
@@ -237,11 +253,14 @@ struct myst_thread
     /* Timespec at process creation */
     struct timespec start_ts;
 
-    /* Timespec at when the thread last entered userspace */
-    struct timespec enter_kernel_ts;
+    /* Ticks (see myst/times.h) at thread creation */
+    uint64_t start_ticks;
 
-    /* Timespec at when the thread last crossed over to userspace */
-    struct timespec leave_kernel_ts;
+    /* Ticks at when the thread last entered the kernel */
+    uint64_t enter_kernel_ticks;
+
+    /* Ticks at when the thread last crossed over to userspace */
+    uint64_t leave_kernel_ticks;
 
     /* the C-runtime thread descriptor */
     myst_td_t* crt_td;
@@ -326,6 +345,12 @@ struct myst_thread
     struct myst_thread* group_prev;
     struct myst_thread* group_next;
 
+    /* next thread in the same tid hash bucket (see myst_tid_hash_lock) */
+    struct myst_thread* tid_hash_next;
+
+    /* references taken by myst_get_thread(); exit waits for them to drop */
+    size_t tid_hash_refs;
+
     /* robust list (see SYS_set_robust_list & SYS_get_robust_list) */
     struct myst_robust_list_head* robust_list_head;
     size_t robust_list_len;
@@ -360,6 +385,18 @@ struct myst_thread
     /* the kernel stack that were allocated to handle the exec system call */
     myst_kstack_t* exec_kstack;
 
+    /* kernel stack reused by this thread's syscalls (see myst_syscall()) */
+    myst_kstack_t* kstack_cache;
+
+    /* M:N scheduling state (see --mn-threads and myst/mnsched.h) */
+    myst_mn_thread_t mn;
+
+    /* syscall latency histograms of this thread (see myst/times.h) */
+    struct myst_syscall_stats* syscall_stats;
+
+    /* information published to the C-runtime (see myst/vdso.h) */
+    myst_vdso_t vdso;
+
     /* when fork needs to wait for child to call exec or exit, wait on this
      * fuxtex. Child set to 1 and signals futex. */
     int fork_exec_futex_wait;
@@ -555,10 +592,16 @@ MYST_INLINE myst_process_t* myst_find_process(myst_thread_t* thread)
 
 long myst_run_thread(uint64_t cookie, uint64_t event, pid_t target_tid);
 
+/* run a new thread on the caller's stack (used by the M:N scheduler) */
+long myst_enter_thread(myst_thread_t* thread, uint64_t event, pid_t target_tid);
+
 pid_t myst_generate_tid(void);
 
 pid_t myst_gettid(void);
 
+/* refresh the myst_thread_t.vdso of the given thread (see myst/vdso.h) */
+void myst_update_vdso(myst_thread_t* thread);
+
 long myst_wait(
     pid_t pid,
     int* wstatus,
@@ -570,14 +613,36 @@ void myst_wait_on_child_processes(myst_process_t* process);
 
 size_t myst_get_num_threads(void);
 
+/* Guards the kernel-wide tid hash. Callers of myst_find_thread() should hold
+ * the read lock for as long as they use the returned thread pointer, since
+ * exiting threads are removed from the hash (under the write lock) before
+ * being freed. */
+extern myst_rwspinlock_t myst_tid_hash_lock;
+
+void myst_tid_hash_insert(myst_thread_t* thread);
+
+void myst_tid_hash_remove(myst_thread_t* thread);
+
+/* Find a thread in the caller's thread group by tid */
 myst_thread_t* myst_find_thread(int tid);
 
+/* Like myst_find_thread() but without holding myst_tid_hash_lock: the thread
+ * is not freed until the reference is released with myst_put_thread(). Use
+ * this for operations that may block, such as signal delivery. */
+myst_thread_t* myst_get_thread(int tid);
+
+void myst_put_thread(myst_thread_t* thread);
+
 /* Caller should hold myst_process_list_lock before calling this function. And
  * release it once its done with its use of the process thread pointer.
  * This is done to protect from the process thread descriptor being cleaned up
  * by some other thread.*/
 myst_process_t* myst_find_process_from_pid(pid_t pid, bool include_zombies);
 
+/* Add a process to the pid hash and to its parent's children (if any).
+ * Caller should hold myst_process_list_lock for writing. */
+void myst_pid_hash_insert(myst_process_t* process, myst_process_t* parent);
+
 void myst_fork_exec_futex_wake(pid_t vfork_parent_pid, pid_t vfork_parent_tid);
 
 size_t myst_kill_thread_group();
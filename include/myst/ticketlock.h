@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef _MYST_TICKETLOCK_H
+#define _MYST_TICKETLOCK_H
+
+#include <myst/defs.h>
+#include <myst/types.h>
+
+// clang-format off
+#define MYST_TICKETLOCK_INITIALIZER { 0, 0 }
+// clang-format on
+
+/* FIFO spinlock: threads acquire the lock in the order they arrived */
+typedef struct myst_ticketlock
+{
+    /* the next ticket to be handed out */
+    volatile uint32_t next;
+
+    /* the ticket currently holding the lock */
+    volatile uint32_t owner;
+} myst_ticketlock_t;
+
+MYST_INLINE void myst_ticket_lock(myst_ticketlock_t* t)
+{
+    const uint32_t ticket = __sync_fetch_and_add(&t->next, 1);
+
+    /* waiters only read the owner field so the cache line stays shared */
+    while (t->owner != ticket)
+        __asm__ __volatile__("pause" : : : "memory");
+
+    __asm__ __volatile__("" : : : "memory");
+}
+
+MYST_INLINE bool myst_ticket_trylock(myst_ticketlock_t* t)
+{
+    const uint32_t owner = t->owner;
+
+    return __sync_bool_compare_and_swap(&t->next, owner, owner + 1);
+}
+
+MYST_INLINE void myst_ticket_unlock(myst_ticketlock_t* t)
+{
+    /* only the lock holder writes the owner field */
+    __asm__ __volatile__("" : : : "memory");
+    t->owner = t->owner + 1;
+}
+
+#endif /* _MYST_TICKETLOCK_H */
@@ -6,6 +6,7 @@
 
 #include <time.h>
 
+#include <myst/buf.h>
 #include <myst/clock.h>
 #include <myst/thread.h>
 
@@ -27,6 +28,18 @@ MYST_INLINE bool is_timespec_valid(const struct timespec* tp)
     return tp->tv_sec >= 0 && (unsigned long)tp->tv_nsec < NANO_IN_SECOND;
 }
 
+/* Calibrate the TSC used for kernel time accounting (called once at boot).
+ * Times are accounted in ticks, which are TSC cycles when the target can
+ * execute RDTSC and nanoseconds otherwise, and converted on read. */
+void myst_times_init(void);
+
+/* Return the current time in ticks */
+uint64_t myst_times_ticks(void);
+
+/* Return nanoseconds per tick as a 32.32 fixed-point number, or zero when
+ * ticks are nanoseconds */
+uint64_t myst_times_ticks_mult(void);
+
 /* Start tracking time for current thread */
 void myst_times_start();
 
@@ -58,6 +71,12 @@ void myst_times_add_child_times_to_parent_times(
 
 void myst_print_syscall_times(const char* message, size_t count);
 
+/* Fold the syscall statistics of an exiting thread into the global ones */
+void myst_times_release_thread(myst_thread_t* thread);
+
+/* Format the syscall latencies of all threads (see /proc/myst/syscalls) */
+int myst_format_syscall_times(myst_buf_t* buf);
+
 /* Return nanoseconds since startup */
 long myst_times_uptime();
 
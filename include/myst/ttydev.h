@@ -71,4 +71,39 @@ struct myst_ttydev
 
 myst_ttydev_t* myst_ttydev_get(void);
 
+/*
+**==============================================================================
+**
+** console output buffering:
+**
+**     With the --console-buffer-size=<size> option (or ConsoleBufferSize in
+**     the configuration), writes to the standard output and standard error
+**     ttys are collected in one buffer of that size per stream instead of
+**     being passed to the target one at a time. A buffer is flushed:
+**
+**         - when the next write does not fit into it
+**         - at the end of each line if the host's standard output is a
+**           terminal
+**         - on a write that finds its oldest data older than
+**           MYST_TTYDEV_FLUSH_MSEC
+**         - before a thread blocks in the target (see myst_tcall()), so the
+**           output of an idle process is not held back
+**         - on fsync(), fdatasync() and sync() and when the kernel exits
+**
+**     Writing to one stream first flushes the other, so the two still
+**     interleave in order. Kernel diagnostics (myst_eprintf() and syslog)
+**     flush the buffers and are then written through, which keeps them in
+**     order without ever holding back a crash report.
+**
+**==============================================================================
+*/
+
+#define MYST_TTYDEV_FLUSH_MSEC 100
+
+/* true while there is buffered console output */
+extern volatile bool __myst_ttydev_pending;
+
+/* write all buffered console output to the target */
+void myst_ttydev_flush(void);
+
 #endif /* _MYST_TTYDEV_H */
@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef _MYST_VDSO_H
+#define _MYST_VDSO_H
+
+#include <sys/types.h>
+
+#include <myst/types.h>
+
+/*
+**==============================================================================
+**
+** vDSO-style thread information page:
+**
+**     Every kernel thread has a myst_vdso_t that the kernel keeps current.
+**     The C-runtime obtains a pointer to it once per thread (with the
+**     SYS_myst_get_vdso syscall) and then answers getpid(), gettid(),
+**     getppid(), getuid(), geteuid(), getgid() and getegid() by reading it,
+**     without entering the kernel.
+**
+**     The page is written only by the kernel, on behalf of the thread that
+**     owns it (the credentials of a thread change only through its own
+**     syscalls and the parent pid of a process never changes), so the
+**     C-runtime may read it without synchronization.
+**
+**==============================================================================
+*/
+
+typedef struct myst_vdso
+{
+    /* the C-runtime thread descriptor of the owning thread */
+    const void* crt_td;
+
+    pid_t pid;
+    pid_t ppid;
+    pid_t tid;
+
+    uid_t uid;
+    uid_t euid;
+    gid_t gid;
+    gid_t egid;
+} myst_vdso_t;
+
+#endif /* _MYST_VDSO_H */
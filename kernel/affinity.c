@@ -3,6 +3,8 @@
 
 #define _GNU_SOURCE
 #include <sched.h>
+#include <stdlib.h>
+#include <string.h>
 #include <sys/mman.h>
 
 #include <myst/eraise.h>
@@ -27,12 +29,17 @@ long myst_syscall_sched_getaffinity(
     }
     else if (pid != 0)
     {
-        myst_thread_t* thread = myst_find_thread(pid);
+        myst_thread_t* thread;
+
+        myst_rw_read_lock(&myst_tid_hash_lock);
+        {
+            if ((thread = myst_find_thread(pid)))
+                pid = thread->target_tid;
+        }
+        myst_rw_read_unlock(&myst_tid_hash_lock);
 
         if (!thread)
             ERAISE(-ESRCH);
-
-        pid = thread->target_tid;
     }
 
     // clear the mask beforehand since the kernel only sets at most
@@ -78,21 +85,61 @@ long myst_syscall_sched_setaffinity(
     }
     else if (pid != 0)
     {
-        myst_thread_t* thread = myst_find_thread(pid);
+        myst_thread_t* thread;
+
+        myst_rw_read_lock(&myst_tid_hash_lock);
+        {
+            if ((thread = myst_find_thread(pid)))
+                pid = thread->target_tid;
+        }
+        myst_rw_read_unlock(&myst_tid_hash_lock);
 
         if (!thread)
             ERAISE(-ESRCH);
-
-        pid = thread->target_tid;
     }
 
-    long params[6] = {(long)pid, (long)cpusetsize, (long)mask};
-    ECHECK((ret = myst_tcall(SYS_sched_setaffinity, params)));
+    /* drop CPUs that are in excess of max_affinity_cpus setting */
+    if (__myst_kernel_args.max_affinity_cpus > 0)
+    {
+        cpu_set_t* copy;
+
+        if (!(copy = malloc(cpusetsize)))
+            ERAISE(-ENOMEM);
+
+        memcpy(copy, mask, cpusetsize);
+
+        for (size_t i = __myst_kernel_args.max_affinity_cpus;
+             i < cpusetsize * 8;
+             i++)
+        {
+            CPU_CLR_S(i, cpusetsize, copy);
+        }
+
+        /* the mask must contain at least one permitted CPU */
+        if (CPU_COUNT_S(cpusetsize, copy) == 0)
+        {
+            free(copy);
+            ERAISE(-EINVAL);
+        }
+
+        /* pin the backing host thread */
+        long params[6] = {(long)pid, (long)cpusetsize, (long)copy};
+        ret = myst_tcall(SYS_sched_setaffinity, params);
+        free(copy);
+        ECHECK(ret);
+    }
+    else
+    {
+        /* pin the backing host thread */
+        long params[6] = {(long)pid, (long)cpusetsize, (long)mask};
+        ECHECK((ret = myst_tcall(SYS_sched_setaffinity, params)));
+    }
 
 done:
     return ret;
 }
 
+/* returns the host CPU that the backing host thread is running on */
 long myst_syscall_getcpu(unsigned* cpu, unsigned* node)
 {
     long ret = 0;
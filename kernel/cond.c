@@ -20,6 +20,34 @@
 static int _cond_signal_bitset(myst_cond_t* c, uint32_t bitset);
 static int _cond_broadcast_bitset(myst_cond_t* c, size_t n, uint32_t bitset);
 
+/* Wake every thread in the given (private) queue, batching the host wakes so
+ * that waking N threads costs N/MYST_TCALL_WAKE_BATCH_SIZE transitions rather
+ * than N. Returns the number of threads dequeued. */
+static size_t _wake_queue(myst_thread_queue_t* waiters)
+{
+    size_t num_awoken = 0;
+    uint64_t events[MYST_TCALL_WAKE_BATCH_SIZE];
+    size_t nevents = 0;
+    myst_thread_t* p;
+
+    while ((p = myst_thread_queue_pop_front(waiters)))
+    {
+        events[nevents++] = p->event;
+        num_awoken++;
+
+        if (nevents == MYST_TCALL_WAKE_BATCH_SIZE)
+        {
+            myst_tcall_wake_many(events, nevents);
+            nevents = 0;
+        }
+    }
+
+    if (nevents)
+        myst_tcall_wake_many(events, nevents);
+
+    return num_awoken;
+}
+
 int myst_cond_init(myst_cond_t* c)
 {
     if (!c)
@@ -234,16 +262,7 @@ int myst_cond_broadcast(myst_cond_t* c, size_t n, uint32_t bitset)
     }
     myst_spin_unlock(&c->lock);
 
-    myst_thread_t* next = NULL;
-
-    for (myst_thread_t* p = waiters.front; p; p = next)
-    {
-        next = p->qnext;
-        p->qnext = NULL;
-        p->queue = NULL;
-        myst_tcall_wake(p->event);
-        num_awoken++;
-    }
+    num_awoken = _wake_queue(&waiters);
 
     return num_awoken;
 }
@@ -290,17 +309,7 @@ int myst_cond_requeue(
     myst_spin_unlock(&c1->lock);
 
     /* Wake the threads in the wakers queue */
-    {
-        myst_thread_t* next = NULL;
-
-        for (myst_thread_t* p = wakers.front; p; p = next)
-        {
-            next = p->qnext;
-            p->qnext = NULL;
-            p->queue = NULL;
-            myst_tcall_wake(p->event);
-        }
-    }
+    _wake_queue(&wakers);
 
     /* Requeue the threads in the requeues queue */
     myst_spin_lock(&c2->lock);
@@ -366,12 +375,7 @@ static int _cond_broadcast_bitset(myst_cond_t* c, size_t n, uint32_t bitset)
     if (ret < 0)
         return -EINVAL;
 
-    myst_thread_t* p;
-    while (p = myst_thread_queue_pop_front(&waiters))
-    {
-        myst_tcall_wake(p->event);
-        num_awoken++;
-    }
+    num_awoken = _wake_queue(&waiters);
 
     return num_awoken;
 }
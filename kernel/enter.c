@@ -36,10 +36,13 @@
 #include <myst/printf.h>
 #include <myst/process.h>
 #include <myst/procfs.h>
+#include <myst/profile.h>
 #include <myst/pubkey.h>
 #include <myst/ramfs.h>
 #include <myst/signal.h>
+#include <myst/spantrace.h>
 #include <myst/stack.h>
+#include <myst/stracebin.h>
 #include <myst/strings.h>
 #include <myst/syscall.h>
 #include <myst/syslog.h>
@@ -53,9 +56,47 @@
 
 static myst_fs_t* _fs;
 
+/* these tcalls are made by span tracing itself */
+MYST_INLINE bool _is_span_tcall(long n)
+{
+    return n == MYST_TCALL_GET_TSD || n == MYST_TCALL_CLOCK_GETTIME;
+}
+
+/* these tcalls may block the calling thread in the target indefinitely */
+static bool _is_blocking_tcall(long n)
+{
+    switch (n)
+    {
+        case MYST_TCALL_WAIT:
+        case MYST_TCALL_WAKE_WAIT:
+        case MYST_TCALL_READ_CONSOLE:
+        case MYST_TCALL_CONNECT_BLOCK:
+        case MYST_TCALL_ACCEPT4_BLOCK:
+        case MYST_TCALL_READ_BLOCK:
+        case MYST_TCALL_WRITE_BLOCK:
+        case MYST_TCALL_RECVFROM_BLOCK:
+        case MYST_TCALL_SENDTO_BLOCK:
+        case MYST_TCALL_RECVMSG_BLOCK:
+        case MYST_TCALL_SENDMSG_BLOCK:
+        case MYST_TCALL_SENDMMSG_BLOCK:
+        case MYST_TCALL_RECVMMSG_BLOCK:
+        case SYS_poll:
+            return true;
+        default:
+            return false;
+    }
+}
+
 long myst_tcall(long n, long params[6])
 {
     void* fs = NULL;
+    uint64_t span;
+
+    /* do not leave buffered console output behind while blocked */
+    if (__myst_ttydev_pending && _is_blocking_tcall(n))
+        myst_ttydev_flush();
+
+    span = _is_span_tcall(n) ? 0 : myst_span_begin();
 
     if (__options.have_syscall_instruction)
     {
@@ -68,6 +109,8 @@ long myst_tcall(long n, long params[6])
     if (fs)
         myst_set_fsbase(fs);
 
+    myst_span_end("tcall", NULL, n, span);
+
     return ret;
 }
 
@@ -477,6 +520,7 @@ static int _init_main_thread(
     process->ppid = ppid;
     process->pid = pid;
     thread->tid = pid;
+    myst_tid_hash_insert(thread);
     thread->target_tid = target_tid;
     thread->event = event;
     thread->target_td = myst_get_fsbase();
@@ -674,6 +718,8 @@ int myst_enter_kernel(myst_kernel_args_t* args)
     myst_fstype_t fstype;
     int tmp_ret;
     int create_appenv_ret;
+    uint64_t boot_span = 0;
+    uint64_t span;
 
     if (!args)
         myst_crash();
@@ -686,6 +732,9 @@ int myst_enter_kernel(myst_kernel_args_t* args)
     /* myst_handle_host_signal can be called from enclave exception handlers */
     args->myst_handle_host_signal = myst_handle_host_signal;
 
+    /* myst_profile_sample is called from the target's profiling timer */
+    args->myst_profile_sample = myst_profile_sample;
+
     /* myst_signal_restore_mask can be called from enclave exception handlers */
     args->myst_signal_restore_mask = myst_signal_restore_mask;
 
@@ -704,9 +753,11 @@ int myst_enter_kernel(myst_kernel_args_t* args)
     {
         args->trace_errors = false;
         args->trace_times = false;
+        args->trace_spans = false;
         memset(&args->strace_config, 0, sizeof(args->strace_config));
         args->memcheck = false;
         args->perf = false;
+        args->profile = false;
         args->debug_symbols = false;
         args->report_native_tids = false;
     }
@@ -737,6 +788,13 @@ int myst_enter_kernel(myst_kernel_args_t* args)
     /* call global constructors within the kernel */
     myst_call_init_functions();
 
+    /* calibrate the kernel clock early so that the boot spans can use it */
+    myst_times_init();
+
+    /* allocate the spans if requested */
+    ECHECK(myst_spantrace_init());
+    boot_span = myst_span_begin();
+
     /* Check arguments */
     {
         if (!args->argc || !args->argv)
@@ -777,6 +835,10 @@ int myst_enter_kernel(myst_kernel_args_t* args)
     process = thread->process;
     myst_main_process = process;
 
+    myst_rw_write_lock(&myst_process_list_lock);
+    myst_pid_hash_insert(process, NULL);
+    myst_rw_write_unlock(&myst_process_list_lock);
+
     myst_copy_host_uid_gid_mappings(&args->host_enc_uid_gid_mappings);
 
     /* determine the rootfs file system type (RAMFS, EXT2FS, OR HOSTFS) */
@@ -790,14 +852,20 @@ int myst_enter_kernel(myst_kernel_args_t* args)
     }
 
     /* Mount the root file system */
+    span = myst_span_begin();
     ECHECK(_mount_rootfs(args, fstype));
+    myst_span_end("boot", "mount rootfs", 0, span);
 
     /* Generate TLS credentials if needed */
+    span = myst_span_begin();
     ECHECK(myst_init_tls_credential_files(
         _getenv(args->envp, WANT_CREDENTIALS), _tmpfs ? _tmpfs : _fs, fstype));
+    myst_span_end("boot", "tls credentials", 0, span);
 
     /* Setup virtual proc filesystem */
+    span = myst_span_begin();
     procfs_setup();
+    myst_span_end("boot", "procfs setup", 0, span);
 
     if (args->hostname)
         ECHECK(
@@ -811,6 +879,7 @@ int myst_enter_kernel(myst_kernel_args_t* args)
     }
 
     /* Unpack the CPIO from memory */
+    span = myst_span_begin();
     if (fstype == MYST_FSTYPE_RAMFS &&
         myst_cpio_mem_unpack(
             args->rootfs_data, args->rootfs_size, "/", _create_mem_file) != 0)
@@ -818,6 +887,7 @@ int myst_enter_kernel(myst_kernel_args_t* args)
         myst_eprintf("failed to unpack root file system\n");
         ERAISE(-EINVAL);
     }
+    myst_span_end("boot", "cpio unpack", 0, span);
 
     /* Setup devfs */
     devfs_setup();
@@ -825,7 +895,9 @@ int myst_enter_kernel(myst_kernel_args_t* args)
     /* Create top-level proc entries */
     create_proc_root_entries();
 
+    span = myst_span_begin();
     ECHECK(_process_mount_configuration(args->mounts));
+    myst_span_end("boot", "mount configuration", 0, span);
 
     ECHECK(_copy_host_etc_files());
 
@@ -834,6 +906,12 @@ int myst_enter_kernel(myst_kernel_args_t* args)
 
     myst_times_start();
 
+    /* allocate the binary strace ring if requested */
+    ECHECK(myst_strace_init());
+
+    /* allocate the profiling samples if requested */
+    ECHECK(myst_profile_init());
+
     /* print how long it took to boot */
     if (__myst_kernel_args.perf || __myst_kernel_args.trace_times)
         _print_boottime();
@@ -852,6 +930,8 @@ int myst_enter_kernel(myst_kernel_args_t* args)
         ERAISE(-ENOENT);
     }
 
+    myst_span_end("boot", "kernel boot", 0, boot_span);
+
     /* Run the main program: wait for SYS_exit to perform longjmp() */
     if (myst_setjmp(&thread->jmpbuf) == 0)
     {
@@ -910,6 +990,13 @@ int myst_enter_kernel(myst_kernel_args_t* args)
             thread->exit_kstack = NULL;
         }
 
+        /* release the kernel stack cached by myst_syscall() */
+        if (thread->kstack_cache)
+        {
+            myst_put_kstack(thread->kstack_cache);
+            thread->kstack_cache = NULL;
+        }
+
         /* Wait for all child threads to shutdown */
         {
             myst_assume(thread->group_prev == NULL);
@@ -919,6 +1006,21 @@ int myst_enter_kernel(myst_kernel_args_t* args)
             }
         }
 
+        /* write out the console output that is still buffered */
+        myst_ttydev_flush();
+
+        /* write the binary strace records (no thread is adding more) */
+        if (__myst_kernel_args.strace_config.binary)
+            myst_strace_dump();
+
+        /* write the folded stacks of the profiling samples */
+        if (__myst_kernel_args.profile)
+            myst_profile_dump();
+
+        /* write the spans as a Chrome trace */
+        if (__myst_kernel_args.trace_spans)
+            myst_spantrace_dump();
+
         /* now all the threads have shutdown we can retrieve the exit status */
         exit_status = process->exit_status;
 
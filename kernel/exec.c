@@ -29,6 +29,7 @@
 #include <myst/round.h>
 #include <myst/setjmp.h>
 #include <myst/signal.h>
+#include <myst/spantrace.h>
 #include <myst/spinlock.h>
 #include <myst/strings.h>
 #include <myst/syscall.h>
@@ -977,6 +978,7 @@ int myst_exec(
     size_t num_bytes_read;
     char* prog_interp = NULL;
     size_t actual_thread_stack_size = thread_stack_size;
+    uint64_t span = myst_span_begin();
 
     if (thread_stack_size)
         _thread_stack_size = thread_stack_size;
@@ -1237,6 +1239,9 @@ int myst_exec(
     if (callback)
         (*callback)(callback_arg);
 
+    /* the span ends here since entering the C-runtime does not return */
+    myst_span_end("exec", "myst_exec", 0, span);
+
     /* enter the C-runtime on the target thread descriptor */
     (*enter)(sp, dynv, myst_syscall, crt_args);
 
@@ -14,7 +14,6 @@
 #include <myst/panic.h>
 #include <myst/pipedev.h>
 #include <myst/process.h>
-#include <myst/spinlock.h>
 #include <myst/strings.h>
 #include <myst/syscall.h>
 #include <myst/thread.h>
@@ -61,7 +60,7 @@ int myst_fdtable_clone(myst_fdtable_t* fdtable, myst_fdtable_t** fdtable_out)
     if (!(new_fdtable = calloc(1, sizeof(myst_fdtable_t))))
         ERAISE(-ENOMEM);
 
-    myst_spin_lock(&fdtable->lock);
+    myst_rw_read_lock(&fdtable->lock);
     {
         for (int i = 0; i < MYST_FDTABLE_SIZE; i++)
         {
@@ -85,7 +84,7 @@ int myst_fdtable_clone(myst_fdtable_t* fdtable, myst_fdtable_t** fdtable_out)
                 /* Duplicate the object */
                 if ((r = (*fdops->fd_dup)(fdops, entry->object, &object)) != 0)
                 {
-                    myst_spin_unlock(&fdtable->lock);
+                    myst_rw_read_unlock(&fdtable->lock);
                     ERAISE(r);
                 }
 
@@ -99,7 +98,7 @@ int myst_fdtable_clone(myst_fdtable_t* fdtable, myst_fdtable_t** fdtable_out)
             }
         }
     }
-    myst_spin_unlock(&fdtable->lock);
+    myst_rw_read_unlock(&fdtable->lock);
 
     *fdtable_out = new_fdtable;
     new_fdtable = NULL;
@@ -119,7 +118,7 @@ int myst_fdtable_cloexec(myst_fdtable_t* fdtable)
     if (!fdtable)
         ERAISE(-EINVAL);
 
-    myst_spin_lock(&fdtable->lock);
+    myst_rw_write_lock(&fdtable->lock);
     {
         /* close any file descriptors with FD_CLOEXEC flag */
         for (int i = 0; i < MYST_FDTABLE_SIZE; i++)
@@ -133,7 +132,7 @@ int myst_fdtable_cloexec(myst_fdtable_t* fdtable)
 
                 if (r < 0)
                 {
-                    myst_spin_unlock(&fdtable->lock);
+                    myst_rw_write_unlock(&fdtable->lock);
                     ERAISE(r);
                 }
 
@@ -151,7 +150,7 @@ int myst_fdtable_cloexec(myst_fdtable_t* fdtable)
             }
         }
     }
-    myst_spin_unlock(&fdtable->lock);
+    myst_rw_write_unlock(&fdtable->lock);
 
 done:
 
@@ -226,7 +225,7 @@ int myst_fdtable_assign(
     if (!fdtable || !object)
         ERAISE(-EINVAL);
 
-    myst_spin_lock(&fdtable->lock);
+    myst_rw_write_lock(&fdtable->lock);
     {
         /* Use the first available entry */
         for (int i = 0; i < MYST_FDTABLE_SIZE; i++)
@@ -239,12 +238,12 @@ int myst_fdtable_assign(
                 entry->device = device;
                 entry->object = object;
                 ret = i;
-                myst_spin_unlock(&fdtable->lock);
+                myst_rw_write_unlock(&fdtable->lock);
                 goto done;
             }
         }
     }
-    myst_spin_unlock(&fdtable->lock);
+    myst_rw_write_unlock(&fdtable->lock);
 
     ERAISE(-EMFILE);
 
@@ -322,7 +321,7 @@ int myst_fdtable_dup(
         }
     }
 
-    myst_spin_lock(&fdtable->lock);
+    myst_rw_write_lock(&fdtable->lock);
     locked = true;
 
     {
@@ -395,8 +394,8 @@ int myst_fdtable_dup(
             myst_fs_t* newfs = (myst_fs_t*)new->device;
             if ((ret = myst_add_fd_link(newfs, new->object, newfd)) < 0)
             {
-                myst_fdtable_remove(fdtable, newfd);
                 (*newfs->fs_close)(newfs, new->object);
+                memset(new, 0, sizeof(myst_fdtable_entry_t));
                 ERAISE(ret);
             }
         }
@@ -407,7 +406,7 @@ int myst_fdtable_dup(
 done:
 
     if (locked)
-        myst_spin_unlock(&fdtable->lock);
+        myst_rw_write_unlock(&fdtable->lock);
 
     return ret;
 }
@@ -422,9 +421,9 @@ int myst_fdtable_remove(myst_fdtable_t* fdtable, int fd)
     if (fd < 0 || fd >= MYST_FDTABLE_SIZE)
         ERAISE(-EINVAL);
 
-    myst_spin_lock(&fdtable->lock);
+    myst_rw_write_lock(&fdtable->lock);
     memset(&fdtable->entries[fd], 0, sizeof(myst_fdtable_entry_t));
-    myst_spin_unlock(&fdtable->lock);
+    myst_rw_write_unlock(&fdtable->lock);
 
 done:
     return ret;
@@ -448,14 +447,14 @@ int myst_fdtable_get(
     if (type == MYST_FDTABLE_TYPE_NONE)
         ERAISE(-EINVAL);
 
-    myst_spin_lock(&fdtable->lock);
+    myst_rw_read_lock(&fdtable->lock);
     {
         myst_fdtable_entry_t* entry = &fdtable->entries[fd];
 
         if (entry->type != type || !(entry->object && entry->device))
         {
             myst_fdtable_type_t actual_type = entry->type;
-            myst_spin_unlock(&fdtable->lock);
+            myst_rw_read_unlock(&fdtable->lock);
 
             // If the client gave us a handle that is not a socket we need to
             // return ENOTSOCK. If the socket has been closed or not used then
@@ -471,7 +470,7 @@ int myst_fdtable_get(
         *device = entry->device;
         *object = entry->object;
     }
-    myst_spin_unlock(&fdtable->lock);
+    myst_rw_read_unlock(&fdtable->lock);
 
 done:
 
@@ -496,13 +495,13 @@ int myst_fdtable_get_any(
     if (!(fd >= 0 && fd < MYST_FDTABLE_SIZE))
         ERAISE(-EBADF);
 
-    myst_spin_lock(&fdtable->lock);
+    myst_rw_read_lock(&fdtable->lock);
     {
         myst_fdtable_entry_t* entry = &fdtable->entries[fd];
 
         if (entry->type == MYST_FDTABLE_TYPE_NONE)
         {
-            myst_spin_unlock(&fdtable->lock);
+            myst_rw_read_unlock(&fdtable->lock);
             ERAISE(-EBADF);
         }
 
@@ -510,7 +509,7 @@ int myst_fdtable_get_any(
         *device = entry->device;
         *object = entry->object;
     }
-    myst_spin_unlock(&fdtable->lock);
+    myst_rw_read_unlock(&fdtable->lock);
 
 done:
 
@@ -616,7 +615,7 @@ long myst_fdtable_sync(myst_fdtable_t* fdtable)
     if (!fdtable)
         ERAISE(-EINVAL);
 
-    myst_spin_lock(&fdtable->lock);
+    myst_rw_read_lock(&fdtable->lock);
     locked = true;
 
     {
@@ -636,7 +635,7 @@ long myst_fdtable_sync(myst_fdtable_t* fdtable)
 done:
 
     if (locked)
-        myst_spin_unlock(&fdtable->lock);
+        myst_rw_read_unlock(&fdtable->lock);
 
     return ret;
 }
@@ -649,7 +648,7 @@ ssize_t myst_fdtable_count(const myst_fdtable_t* fdtable)
     if (!fdtable)
         ERAISE(-EINVAL);
 
-    myst_spin_lock(&((myst_fdtable_t*)fdtable)->lock);
+    myst_rw_read_lock(&((myst_fdtable_t*)fdtable)->lock);
     {
         for (int i = 0; i < MYST_FDTABLE_SIZE; i++)
         {
@@ -659,7 +658,7 @@ ssize_t myst_fdtable_count(const myst_fdtable_t* fdtable)
                 count++;
         }
     }
-    myst_spin_unlock(&((myst_fdtable_t*)fdtable)->lock);
+    myst_rw_read_unlock(&((myst_fdtable_t*)fdtable)->lock);
 
     ret = count;
 
@@ -681,21 +680,21 @@ int myst_fdtable_update_sock_entry(
     if (!(fd >= 0 && fd < MYST_FDTABLE_SIZE))
         ERAISE(-EBADF);
 
-    myst_spin_lock(&fdtable->lock);
+    myst_rw_write_lock(&fdtable->lock);
     {
         myst_fdtable_entry_t* entry = &fdtable->entries[fd];
 
         if (entry->type != MYST_FDTABLE_TYPE_SOCK ||
             !(entry->device && entry->object))
         {
-            myst_spin_unlock(&fdtable->lock);
+            myst_rw_write_unlock(&fdtable->lock);
             ERAISE(-ENOTSOCK);
         }
 
         entry->device = device;
         entry->object = new_sock;
     }
-    myst_spin_unlock(&fdtable->lock);
+    myst_rw_write_unlock(&fdtable->lock);
 
 done:
 
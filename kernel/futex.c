@@ -8,9 +8,13 @@
 #include <myst/cond.h>
 #include <myst/eraise.h>
 #include <myst/futex.h>
+#include <myst/mmanutils.h>
+#include <myst/signal.h>
 #include <myst/strings.h>
 #include <myst/syscall.h>
+#include <myst/tcall.h>
 #include <myst/thread.h>
+#include <myst/ticketlock.h>
 #include <myst/times.h>
 
 static long _syscall_futex_bitset_or_clock_realtime(
@@ -37,6 +41,25 @@ static long _syscall_futex_bitset_or_clock_realtime(
 
 typedef struct futex futex_t;
 
+/* state shared by all futexes that a futex_waitv() caller is queued on */
+typedef struct futex_waitv_context
+{
+    myst_thread_t* thread;
+
+    /* index of the futex that woke the waiter (-1 until woken) */
+    volatile int woken;
+} futex_waitv_context_t;
+
+/* one of these is queued on each futex passed to futex_waitv() */
+typedef struct futex_waitv_waiter
+{
+    struct futex_waitv_waiter* prev;
+    struct futex_waitv_waiter* next;
+    futex_t* futex;
+    futex_waitv_context_t* context;
+    int index;
+} futex_waitv_waiter_t;
+
 struct futex
 {
     futex_t* next;
@@ -44,20 +67,23 @@ struct futex
     volatile int* uaddr;
     myst_cond_t cond;
     myst_mutex_t mutex;
+
+    /* futex_waitv() waiters (guarded by mutex) */
+    futex_waitv_waiter_t* waitv_head;
 };
 
 static futex_t* _chains[NUM_CHAINS];
 static bool _installed_free_futexes;
 
 #if 1
-static myst_spinlock_t _spin = MYST_SPINLOCK_INITIALIZER;
+static myst_ticketlock_t _spin = MYST_TICKETLOCK_INITIALIZER;
 static void _lock(void)
 {
-    myst_spin_lock(&_spin);
+    myst_ticket_lock(&_spin);
 }
 static void _unlock(void)
 {
-    myst_spin_unlock(&_spin);
+    myst_ticket_unlock(&_spin);
 }
 #else
 static myst_mutex_t _mutex;
@@ -215,6 +241,72 @@ done:
     return ret;
 }
 
+/* caller must hold f->mutex */
+static void _waitv_enqueue(futex_t* f, futex_waitv_waiter_t* w)
+{
+    w->prev = NULL;
+    w->next = f->waitv_head;
+
+    if (f->waitv_head)
+        f->waitv_head->prev = w;
+
+    f->waitv_head = w;
+}
+
+/* caller must hold f->mutex */
+static void _waitv_dequeue(futex_t* f, futex_waitv_waiter_t* w)
+{
+    if (w->prev)
+        w->prev->next = w->next;
+    else
+        f->waitv_head = w->next;
+
+    if (w->next)
+        w->next->prev = w->prev;
+
+    w->prev = NULL;
+    w->next = NULL;
+}
+
+/* Wake up to n futex_waitv() waiters queued on this futex. A waiter is only
+ * woken by the first futex that claims it, so waiters already claimed through
+ * another futex are skipped. Caller must hold f->mutex. */
+static size_t _waitv_wake(futex_t* f, size_t n)
+{
+    size_t num_awoken = 0;
+    uint64_t events[MYST_TCALL_WAKE_BATCH_SIZE];
+    size_t nevents = 0;
+
+    for (futex_waitv_waiter_t* w = f->waitv_head; w && num_awoken < n;
+         w = w->next)
+    {
+        int expected = -1;
+
+        if (__atomic_compare_exchange_n(
+                &w->context->woken,
+                &expected,
+                w->index,
+                false,
+                __ATOMIC_SEQ_CST,
+                __ATOMIC_SEQ_CST))
+        {
+            events[nevents++] = w->context->thread->event;
+            num_awoken++;
+
+            if (nevents == MYST_TCALL_WAKE_BATCH_SIZE)
+            {
+                myst_tcall_wake_many(events, nevents);
+                nevents = 0;
+            }
+        }
+    }
+
+    if (nevents)
+        myst_tcall_wake_many(events, nevents);
+
+    return num_awoken;
+}
+
 int myst_futex_wake(int* uaddr, int val, uint32_t bitset)
 {
     int ret = 0;
@@ -241,6 +333,17 @@ int myst_futex_wake(int* uaddr, int val, uint32_t bitset)
     locked = true;
     myst_assume(f->mutex.owner == myst_thread_self());
 
+    /* wake futex_waitv() waiters first (these ignore the bitset) */
+    if (f->waitv_head && val > 0)
+    {
+        size_t n = (val == INT_MAX) ? SIZE_MAX : (size_t)val;
+
+        if ((ret = (int)_waitv_wake(f, n)) == val)
+            goto done;
+
+        val -= ret;
+    }
+
     if (val == 1)
     {
         if (myst_cond_signal(&f->cond, bitset) != 0)
@@ -250,7 +353,7 @@ int myst_futex_wake(int* uaddr, int val, uint32_t bitset)
         }
 
         /* return the number of threads that woke up */
-        ret = 1;
+        ret += 1;
     }
     else if (val > 1)
     {
@@ -264,7 +367,7 @@ int myst_futex_wake(int* uaddr, int val, uint32_t bitset)
             goto done;
         }
 
-        ret = num_awoken;
+        ret += num_awoken;
     }
     else
     {
@@ -283,6 +386,151 @@ done:
     return ret;
 }
 
+int myst_futex_waitv(
+    const myst_futex_waitv_t* waiters,
+    size_t nwaiters,
+    const struct timespec* to)
+{
+    int ret = 0;
+    myst_thread_t* self = myst_thread_self();
+    futex_waitv_context_t context = {self, -1};
+    futex_waitv_waiter_t* queued = NULL;
+    size_t num_queued = 0;
+    int expected = -1;
+    long deadline = 0;
+    struct timespec now;
+    struct timespec rel;
+
+    if (!waiters || nwaiters == 0 || nwaiters > FUTEX_WAITV_MAX)
+    {
+        ret = -EINVAL;
+        goto done;
+    }
+
+    if (!(queued = calloc(nwaiters, sizeof(futex_waitv_waiter_t))))
+    {
+        ret = -ENOMEM;
+        goto done;
+    }
+
+    /* queue on every futex, failing if any of them no longer has the
+     * expected value */
+    for (size_t i = 0; i < nwaiters; i++)
+    {
+        int* uaddr = (int*)waiters[i].uaddr;
+        futex_waitv_waiter_t* w = &queued[i];
+
+        if (!(w->futex = _get_futex(uaddr)))
+        {
+            ret = -ENOMEM;
+            goto done;
+        }
+
+        w->context = &context;
+        w->index = (int)i;
+
+        myst_mutex_lock(&w->futex->mutex);
+        {
+            if (*uaddr != (int)waiters[i].val)
+            {
+                myst_mutex_unlock(&w->futex->mutex);
+                ret = -EAGAIN;
+                goto done;
+            }
+
+            _waitv_enqueue(w->futex, w);
+            num_queued++;
+        }
+        myst_mutex_unlock(&w->futex->mutex);
+    }
+
+    /* unrelated wakeups must not restart the relative timeout */
+    if (to)
+    {
+        myst_syscall_clock_gettime(CLOCK_MONOTONIC, &now);
+        deadline = timespec_to_nanos(&now) + timespec_to_nanos(to);
+    }
+
+    /* a single host wait covers all of the futexes */
+    while (__atomic_load_n(&context.woken, __ATOMIC_ACQUIRE) < 0)
+    {
+        long r;
+
+        if (to)
+        {
+            long nanos;
+
+            myst_syscall_clock_gettime(CLOCK_MONOTONIC, &now);
+
+            if ((nanos = deadline - timespec_to_nanos(&now)) <= 0)
+            {
+                ret = -ETIMEDOUT;
+                break;
+            }
+
+            nanos_to_timespec(&rel, nanos);
+        }
+
+        self->signal.waiting_on_event = true;
+        r = myst_tcall_wait(self->event, to ? &rel : NULL);
+        self->signal.waiting_on_event = false;
+
+        if (__atomic_load_n(&context.woken, __ATOMIC_ACQUIRE) >= 0)
+            break;
+
+        if (r < 0)
+        {
+            ret = (int)r;
+            break;
+        }
+
+        if (myst_signal_has_active_signals(self))
+        {
+            ret = -EINTR;
+            break;
+        }
+    }
+
+done:
+
+    /* dequeue from every futex; once done no waker can reference context */
+    for (size_t i = 0; i < num_queued; i++)
+    {
+        futex_waitv_waiter_t* w = &queued[i];
+
+        myst_mutex_lock(&w->futex->mutex);
+        _waitv_dequeue(w->futex, w);
+        myst_mutex_unlock(&w->futex->mutex);
+    }
+
+    /* if a waker claimed this thread, report the futex that woke it, even if
+     * the wait failed in the meantime (e.g., timed out) */
+    if (num_queued &&
+        !__atomic_compare_exchange_n(
+            &context.woken,
+            &expected,
+            -2,
+            false,
+            __ATOMIC_SEQ_CST,
+            __ATOMIC_SEQ_CST))
+    {
+        ret = expected;
+    }
+
+    if (queued)
+    {
+        for (size_t i = 0; i < nwaiters; i++)
+        {
+            if (queued[i].futex)
+                _put_futex((int*)waiters[i].uaddr);
+        }
+
+        free(queued);
+    }
+
+    return ret;
+}
+
 static int _futex_requeue(int* uaddr, int op, int val, int val2, int* uaddr2)
 {
     int ret = 0;
@@ -355,6 +603,50 @@ done:
     return ret;
 }
 
+/* FUTEX_WAIT_MULTIPLE: the pre-futex_waitv() interface used by Proton */
+static int _futex_wait_multiple(
+    const myst_futex_wait_block_t* blocks,
+    int count,
+    const struct timespec* to)
+{
+    int ret = 0;
+    myst_futex_waitv_t* waiters = NULL;
+
+    if (!blocks || count <= 0 || count > FUTEX_WAITV_MAX)
+    {
+        ret = -EINVAL;
+        goto done;
+    }
+
+    if (myst_is_bad_addr_read(blocks, (size_t)count * sizeof(*blocks)))
+    {
+        ret = -EFAULT;
+        goto done;
+    }
+
+    if (!(waiters = calloc((size_t)count, sizeof(myst_futex_waitv_t))))
+    {
+        ret = -ENOMEM;
+        goto done;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        waiters[i].uaddr = (uint64_t)blocks[i].uaddr;
+        waiters[i].val = (uint32_t)blocks[i].val;
+        waiters[i].flags = FUTEX_32;
+    }
+
+    ret = myst_futex_waitv(waiters, (size_t)count, to);
+
+done:
+
+    if (waiters)
+        free(waiters);
+
+    return ret;
+}
+
 /*
 **==============================================================================
 **
@@ -394,6 +686,15 @@ long myst_syscall_futex(
     {
         ECHECK(_futex_requeue(uaddr, op, val, (int)arg, uaddr2));
     }
+    else if (
+        op == FUTEX_WAIT_MULTIPLE ||
+        op == (FUTEX_WAIT_MULTIPLE | FUTEX_PRIVATE))
+    {
+        ECHECK(ret = _futex_wait_multiple(
+                   (const myst_futex_wait_block_t*)uaddr,
+                   val,
+                   (const struct timespec*)arg));
+    }
     else
     {
         ERAISE(-ENOTSUP);
@@ -403,6 +704,60 @@ done:
     return ret;
 }
 
+long myst_syscall_futex_waitv(
+    const myst_futex_waitv_t* waiters,
+    unsigned int nr_futexes,
+    unsigned int flags,
+    const struct timespec* timeout,
+    clockid_t clockid)
+{
+    long ret = 0;
+    struct timespec rel;
+    const struct timespec* to = NULL;
+
+    if (flags != 0 || !waiters || nr_futexes == 0 ||
+        nr_futexes > FUTEX_WAITV_MAX)
+        ERAISE(-EINVAL);
+
+    if (myst_is_bad_addr_read(waiters, nr_futexes * sizeof(*waiters)))
+        ERAISE(-EFAULT);
+
+    for (unsigned int i = 0; i < nr_futexes; i++)
+    {
+        const myst_futex_waitv_t* w = &waiters[i];
+
+        if ((w->flags & ~FUTEX_PRIVATE) != FUTEX_32 || w->__reserved)
+            ERAISE(-EINVAL);
+
+        if (w->val > UINT32_MAX || !w->uaddr || (w->uaddr % sizeof(int)))
+            ERAISE(-EINVAL);
+    }
+
+    /* the timeout is absolute against the given clock */
+    if (timeout)
+    {
+        struct timespec now;
+        long nanos;
+
+        if (clockid != CLOCK_MONOTONIC && clockid != CLOCK_REALTIME)
+            ERAISE(-EINVAL);
+
+        ECHECK(myst_syscall_clock_gettime(clockid, &now));
+        nanos = timespec_to_nanos(timeout) - timespec_to_nanos(&now);
+
+        if (nanos <= 0)
+            ERAISE(-ETIMEDOUT);
+
+        nanos_to_timespec(&rel, nanos);
+        to = &rel;
+    }
+
+    ret = myst_futex_waitv(waiters, nr_futexes, to);
+
+done:
+    return ret;
+}
+
 static long _syscall_futex_bitset_or_clock_realtime(
     int* uaddr,
     int op,
@@ -49,6 +49,12 @@ static ssize_t _host_read(int fd, void* buf, size_t count)
     return (ssize_t)myst_tcall(SYS_read, params);
 }
 
+static ssize_t _host_write(int fd, const void* buf, size_t count)
+{
+    long params[6] = {(long)fd, (long)buf, (long)count};
+    return (ssize_t)myst_tcall(SYS_write, params);
+}
+
 int myst_load_host_file(const char* path, void** data_out, size_t* size_out)
 {
     int ret = 0;
@@ -115,3 +121,35 @@ done:
 
     return ret;
 }
+
+int myst_write_host_file(const char* path, const void* data, size_t size)
+{
+    int ret = 0;
+    int fd = -1;
+    const uint8_t* p = (const uint8_t*)data;
+    const int flags = O_WRONLY | O_CREAT | O_TRUNC;
+
+    if (!path || (!data && size))
+        ERAISE(-EINVAL);
+
+    ECHECK(fd = _host_open(path, flags, 0644));
+
+    while (size)
+    {
+        ssize_t n = _host_write(fd, p, size);
+        ECHECK(n);
+
+        if (n == 0)
+            ERAISE(-EIO);
+
+        p += n;
+        size -= (size_t)n;
+    }
+
+done:
+
+    if (fd >= 0)
+        _host_close(fd);
+
+    return ret;
+}
@@ -7,10 +7,11 @@
 #include <myst/spinlock.h>
 #include <myst/stack.h>
 #include <myst/thread.h>
+#include <myst/ticketlock.h>
 #include <myst/time.h>
 
 static myst_kstack_t* _head;
-static myst_spinlock_t _lock;
+static myst_ticketlock_t _lock;
 
 /* allocate a new kernel stack with a protected guard page */
 static long _new_kstack(void* arg)
@@ -46,7 +47,7 @@ myst_kstack_t* myst_get_kstack(void)
 {
     myst_kstack_t* kstack = NULL;
 
-    myst_spin_lock(&_lock);
+    myst_ticket_lock(&_lock);
     {
         if (_head)
         {
@@ -55,7 +56,7 @@ myst_kstack_t* myst_get_kstack(void)
                 _head = _head->u.next;
         }
     }
-    myst_spin_unlock(&_lock);
+    myst_ticket_unlock(&_lock);
 
     if (kstack == NULL)
     {
@@ -76,10 +77,10 @@ myst_kstack_t* myst_get_kstack(void)
 void myst_put_kstack(myst_kstack_t* kstack)
 {
     myst_unregister_stack(kstack->u.__data, sizeof(kstack->u.__data));
-    myst_spin_lock(&_lock);
+    myst_ticket_lock(&_lock);
     {
         kstack->u.next = _head;
         _head = kstack;
     }
-    myst_spin_unlock(&_lock);
+    myst_ticket_unlock(&_lock);
 }
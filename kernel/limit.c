@@ -43,7 +43,8 @@ int myst_limit_set_default(struct rlimit rlimits[])
     rlimits[RLIMIT_RSS].rlim_cur = RLIM_INFINITY;
     rlimits[RLIMIT_RSS].rlim_max = RLIM_INFINITY;
 
-    // RLIMIT_NPROC
+    // RLIMIT_NPROC: the host threads, including those set aside for the
+    // carriers of multiplexed threads (see _admit_host_thread() in thread.c)
     rlimits[RLIMIT_NPROC].rlim_cur = __myst_kernel_args.max_threads;
     rlimits[RLIMIT_NPROC].rlim_max = __myst_kernel_args.max_threads;
 
@@ -109,7 +110,7 @@ int myst_limit_get_rlimit(pid_t pid, int resource, struct rlimit* rlim)
     myst_process_t* process;
     int ret = 0;
 
-    myst_spin_lock(&myst_process_list_lock);
+    myst_rw_read_lock(&myst_process_list_lock);
 
     if (!rlim)
         ERAISE(-EFAULT);
@@ -129,7 +130,7 @@ int myst_limit_get_rlimit(pid_t pid, int resource, struct rlimit* rlim)
     rlim->rlim_max = process->rlimits[resource].rlim_max;
 
 done:
-    myst_spin_unlock(&myst_process_list_lock);
+    myst_rw_read_unlock(&myst_process_list_lock);
     return ret;
 }
 
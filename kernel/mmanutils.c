@@ -898,7 +898,7 @@ int proc_pid_maps_vcallback(
     }* locals = NULL;
     myst_process_t* process;
 
-    myst_spin_lock(&myst_process_list_lock);
+    myst_rw_read_lock(&myst_process_list_lock);
 
     if (!vbuf && !entrypath)
         ERAISE(-EINVAL);
@@ -1024,7 +1024,7 @@ int proc_pid_maps_vcallback(
 done:
     _runlock(&locked);
 
-    myst_spin_unlock(&myst_process_list_lock);
+    myst_rw_read_unlock(&myst_process_list_lock);
 
     if (ret != 0)
         myst_buf_release(vbuf);
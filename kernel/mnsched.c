@@ -0,0 +1,663 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/user.h>
+
+#include <myst/assume.h>
+#include <myst/fsgs.h>
+#include <myst/kernel.h>
+#include <myst/mnsched.h>
+#include <myst/panic.h>
+#include <myst/setjmp.h>
+#include <myst/signal.h>
+#include <myst/stack.h>
+#include <myst/syscall.h>
+#include <myst/tcall.h>
+#include <myst/thread.h>
+#include <myst/ticketlock.h>
+
+#define NANO_IN_SECOND 1000000000UL
+
+/* a host thread that runs multiplexed threads */
+typedef struct myst_mn_carrier
+{
+    /* the scheduler context (on the host thread's stack) */
+    myst_jmp_buf_t ctx;
+
+    /* the host event, thread id, and thread descriptor of this carrier */
+    uint64_t event;
+    pid_t target_tid;
+    myst_td_t* target_td;
+
+    /* the thread being run and whether it exited */
+    myst_thread_t* current;
+    bool dead;
+
+    /* the exception handler stack installed into target_td */
+    void* altstack;
+
+    /* link for the idle carrier list */
+    bool idle;
+    struct myst_mn_carrier* idle_next;
+} myst_mn_carrier_t;
+
+/* maps events to threads; the generation detects stale events */
+typedef struct slot
+{
+    myst_thread_t* thread;
+    uint32_t generation;
+    uint32_t next_free;
+} slot_t;
+
+#define SLOT_NONE UINT32_MAX
+
+/* everything below is protected by this lock */
+static myst_ticketlock_t _lock = MYST_TICKETLOCK_INITIALIZER;
+
+static slot_t* _slots;
+static uint32_t _num_slots;
+static uint32_t _max_slots;
+static uint32_t _free_slot = SLOT_NONE;
+
+/* the run queue (FIFO) */
+static myst_thread_t* _run_head;
+static myst_thread_t* _run_tail;
+
+/* threads whose wait has a timeout, sorted by deadline */
+static myst_thread_t* _timer_head;
+
+static myst_mn_carrier_t* _idle_carriers;
+static size_t _num_carriers;
+
+/* number of multiplexed threads that have not exited */
+static size_t _num_threads;
+
+bool myst_mn_enabled(void)
+{
+    return __myst_kernel_args.mn_threads > 0;
+}
+
+static uint64_t _now(void)
+{
+    struct timespec ts;
+
+    if (myst_syscall_clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+        myst_panic("clock_gettime() failed");
+
+    return (uint64_t)ts.tv_sec * NANO_IN_SECOND + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t _make_event(uint32_t slot)
+{
+    const uint64_t gen = _slots[slot].generation;
+    return ((uint64_t)slot << 32) | (gen << 1) | MYST_MN_EVENT_TAG;
+}
+
+/* resolve an event to its thread (null if the thread has since exited) */
+static myst_thread_t* _lookup(uint64_t event)
+{
+    const uint32_t slot = (uint32_t)(event >> 32);
+    const uint32_t gen = (uint32_t)event >> 1;
+
+    if (slot >= _num_slots || _slots[slot].generation != gen)
+        return NULL;
+
+    return _slots[slot].thread;
+}
+
+static long _alloc_slot(myst_thread_t* thread)
+{
+    uint32_t slot;
+
+    if (_free_slot != SLOT_NONE)
+    {
+        slot = _free_slot;
+        _free_slot = _slots[slot].next_free;
+    }
+    else
+    {
+        if (_num_slots == _max_slots)
+        {
+            const uint32_t n = _max_slots ? _max_slots * 2 : 1024;
+            slot_t* slots;
+
+            if (!(slots = realloc(_slots, n * sizeof(slot_t))))
+                return -ENOMEM;
+
+            _slots = slots;
+            _max_slots = n;
+        }
+
+        slot = _num_slots++;
+        _slots[slot].generation = 0;
+    }
+
+    _slots[slot].thread = thread;
+    _slots[slot].next_free = SLOT_NONE;
+    thread->mn.slot = slot;
+
+    return 0;
+}
+
+static void _free_slot_of(myst_thread_t* thread)
+{
+    slot_t* slot = &_slots[thread->mn.slot];
+
+    /* invalidate outstanding events (31 bits of the generation are used) */
+    slot->generation = (slot->generation + 1) & 0x7fffffff;
+    slot->thread = NULL;
+    slot->next_free = _free_slot;
+    _free_slot = thread->mn.slot;
+}
+
+static void _enqueue(myst_thread_t* thread)
+{
+    thread->mn.run_next = NULL;
+
+    if (_run_tail)
+        _run_tail->mn.run_next = thread;
+    else
+        _run_head = thread;
+
+    _run_tail = thread;
+}
+
+static myst_thread_t* _dequeue(void)
+{
+    myst_thread_t* thread;
+
+    if ((thread = _run_head))
+    {
+        if (!(_run_head = thread->mn.run_next))
+            _run_tail = NULL;
+
+        thread->mn.run_next = NULL;
+    }
+
+    return thread;
+}
+
+static void _timer_insert(myst_thread_t* thread)
+{
+    myst_thread_t* prev = NULL;
+    myst_thread_t* p = _timer_head;
+
+    while (p && p->mn.deadline <= thread->mn.deadline)
+    {
+        prev = p;
+        p = p->mn.timer_next;
+    }
+
+    thread->mn.timer_prev = prev;
+    thread->mn.timer_next = p;
+
+    if (p)
+        p->mn.timer_prev = thread;
+
+    if (prev)
+        prev->mn.timer_next = thread;
+    else
+        _timer_head = thread;
+}
+
+static void _timer_remove(myst_thread_t* thread)
+{
+    if (thread->mn.timer_prev)
+        thread->mn.timer_prev->mn.timer_next = thread->mn.timer_next;
+    else
+        _timer_head = thread->mn.timer_next;
+
+    if (thread->mn.timer_next)
+        thread->mn.timer_next->mn.timer_prev = thread->mn.timer_prev;
+
+    thread->mn.timer_prev = NULL;
+    thread->mn.timer_next = NULL;
+    thread->mn.deadline = 0;
+}
+
+static myst_mn_carrier_t* _pop_idle_carrier(void)
+{
+    myst_mn_carrier_t* carrier;
+
+    if ((carrier = _idle_carriers))
+    {
+        _idle_carriers = carrier->idle_next;
+        carrier->idle_next = NULL;
+        carrier->idle = false;
+    }
+
+    return carrier;
+}
+
+static void _remove_idle_carrier(myst_mn_carrier_t* carrier)
+{
+    for (myst_mn_carrier_t** p = &_idle_carriers; *p; p = &(*p)->idle_next)
+    {
+        if (*p == carrier)
+        {
+            *p = carrier->idle_next;
+            break;
+        }
+    }
+
+    carrier->idle_next = NULL;
+    carrier->idle = false;
+}
+
+/* make a waiting thread runnable; returns true if it was queued */
+static bool _make_runnable(myst_thread_t* thread)
+{
+    if (thread->mn.deadline)
+        _timer_remove(thread);
+
+    thread->mn.state = MYST_MN_RUNNABLE;
+
+    /* else the carrier queues it once it has switched away from it */
+    if (!thread->mn.parked)
+        return false;
+
+    _enqueue(thread);
+    return true;
+}
+
+/* called by a carrier, which then runs the expired threads itself */
+static void _fire_timers(uint64_t now)
+{
+    myst_thread_t* thread;
+
+    while ((thread = _timer_head) && thread->mn.deadline <= now)
+    {
+        thread->mn.timed_out = true;
+        _make_runnable(thread);
+    }
+}
+
+static void _wake_carrier(myst_mn_carrier_t* carrier)
+{
+    if (carrier)
+        myst_tcall_wake(carrier->event);
+}
+
+long myst_mn_start_thread(myst_thread_t* thread, bool* need_carrier)
+{
+    long ret = 0;
+    myst_mn_carrier_t* carrier = NULL;
+
+    *need_carrier = false;
+
+    myst_ticket_lock(&_lock);
+    {
+        if ((ret = _alloc_slot(thread)) < 0)
+        {
+            myst_ticket_unlock(&_lock);
+            return ret;
+        }
+
+        thread->mn.enabled = true;
+        thread->event = _make_event(thread->mn.slot);
+        _num_threads++;
+
+        if (_num_carriers < __myst_kernel_args.mn_threads)
+        {
+            /* the new carrier runs this thread first */
+            _num_carriers++;
+            *need_carrier = true;
+        }
+        else
+        {
+            thread->mn.state = MYST_MN_RUNNABLE;
+            thread->mn.parked = true;
+            _enqueue(thread);
+            carrier = _pop_idle_carrier();
+        }
+    }
+    myst_ticket_unlock(&_lock);
+
+    _wake_carrier(carrier);
+
+    return ret;
+}
+
+/* entry point of a multiplexed thread (runs on its entry stack) */
+static long _thread_main(void* arg)
+{
+    myst_thread_t* thread = (myst_thread_t*)arg;
+    myst_mn_carrier_t* carrier = thread->mn.carrier;
+
+    myst_enter_thread(thread, thread->event, carrier->target_tid);
+
+    /* exiting threads switch to their carrier from myst_mn_exit_thread() */
+    myst_panic("unexpected return");
+    return 0;
+}
+
+/* switch from the carrier to the thread; returns when the thread waits,
+ * yields, or exits */
+static void _run(myst_mn_carrier_t* carrier, myst_thread_t* thread)
+{
+    carrier->current = thread;
+    carrier->dead = false;
+
+    thread->mn.carrier = carrier;
+    thread->target_tid = carrier->target_tid;
+
+    myst_assume(myst_tcall_set_tsd((uint64_t)thread) == 0);
+
+    if (thread->mn.started)
+        thread->target_td = carrier->target_td;
+
+    /* install the exception handler stack of this thread if different */
+    if (thread->signal_delivery_altstack != carrier->altstack)
+    {
+        void* stack = thread->signal_delivery_altstack;
+        size_t size = thread->signal_delivery_altstack_size;
+
+        if (stack)
+        {
+            stack = (uint8_t*)stack + PAGE_SIZE;
+            size -= PAGE_SIZE;
+        }
+
+        myst_tcall_td_set_exception_handler_stack(
+            carrier->target_td, stack, size);
+        carrier->altstack = thread->signal_delivery_altstack;
+    }
+
+    if (myst_setjmp(&carrier->ctx) == 0)
+    {
+        if (!thread->mn.started)
+        {
+            uint8_t* sp = (uint8_t*)thread->entry_stack;
+
+            sp += thread->entry_stack_size;
+            thread->mn.started = true;
+            myst_call_on_stack(sp, _thread_main, thread);
+            myst_panic("unexpected return");
+        }
+
+        myst_longjmp(&thread->mn.ctx, 1);
+    }
+
+    /* ---------- back on the carrier's stack ---------- */
+}
+
+/* switch from the calling thread to its carrier */
+static void _switch_to_carrier(myst_thread_t* thread)
+{
+    if (myst_setjmp(&thread->mn.ctx) == 0)
+        myst_longjmp(&thread->mn.carrier->ctx, 1);
+
+    /* ---------- resumed, possibly by a different carrier ---------- */
+}
+
+long myst_mn_run_carrier(
+    myst_thread_t* thread,
+    uint64_t event,
+    pid_t target_tid)
+{
+    myst_mn_carrier_t carrier;
+
+    memset(&carrier, 0, sizeof(carrier));
+    carrier.event = event;
+    carrier.target_tid = target_tid;
+    carrier.target_td = myst_get_fsbase();
+
+    for (;;)
+    {
+        /* find the next thread to run */
+        while (!thread)
+        {
+            const uint64_t now = _now();
+            struct timespec ts;
+            struct timespec* timeout = NULL;
+
+            myst_ticket_lock(&_lock);
+            {
+                _fire_timers(now);
+
+                if ((thread = _dequeue()))
+                {
+                    thread->mn.parked = false;
+                    thread->mn.state = MYST_MN_RUNNING;
+                    myst_ticket_unlock(&_lock);
+                    break;
+                }
+
+                /* retire the carrier once every thread has exited */
+                if (_num_threads == 0)
+                {
+                    _num_carriers--;
+                    myst_ticket_unlock(&_lock);
+                    return 0;
+                }
+
+                if (_timer_head)
+                {
+                    const uint64_t nsec = _timer_head->mn.deadline - now;
+                    ts.tv_sec = (time_t)(nsec / NANO_IN_SECOND);
+                    ts.tv_nsec = (long)(nsec % NANO_IN_SECOND);
+                    timeout = &ts;
+                }
+
+                carrier.idle = true;
+                carrier.idle_next = _idle_carriers;
+                _idle_carriers = &carrier;
+            }
+            myst_ticket_unlock(&_lock);
+
+            myst_tcall_wait(carrier.event, timeout);
+
+            myst_ticket_lock(&_lock);
+            {
+                if (carrier.idle)
+                    _remove_idle_carrier(&carrier);
+            }
+            myst_ticket_unlock(&_lock);
+        }
+
+        _run(&carrier, thread);
+
+        /* the thread may have installed or removed its altstack */
+        if (!carrier.dead)
+            carrier.altstack = thread->signal_delivery_altstack;
+
+        myst_ticket_lock(&_lock);
+        {
+            if (carrier.dead)
+            {
+                _free_slot_of(thread);
+                _num_threads--;
+            }
+            else
+            {
+                thread->mn.parked = true;
+
+                /* yielded, or woken before the switch completed */
+                if (thread->mn.state == MYST_MN_RUNNABLE)
+                    _enqueue(thread);
+            }
+        }
+        myst_ticket_unlock(&_lock);
+
+        /* free the exited thread now that its stack is no longer in use */
+        if (carrier.dead)
+        {
+            void* stack = thread->entry_stack;
+
+            myst_unregister_stack(stack, thread->entry_stack_size);
+            free(stack);
+            free(thread);
+        }
+
+        thread = NULL;
+    }
+}
+
+void myst_mn_exit_thread(myst_thread_t* thread)
+{
+    myst_mn_carrier_t* carrier = thread->mn.carrier;
+
+    carrier->dead = true;
+    myst_longjmp(&carrier->ctx, 1);
+
+    /* unreachable */
+    for (;;)
+        ;
+}
+
+long myst_mn_wait(uint64_t event, const struct timespec* timeout)
+{
+    myst_thread_t* thread;
+    uint64_t deadline = 0;
+
+    if (timeout)
+    {
+        if (timeout->tv_sec < 0 || timeout->tv_nsec < 0 ||
+            (uint64_t)timeout->tv_nsec >= NANO_IN_SECOND)
+        {
+            return -EINVAL;
+        }
+
+        deadline = _now() + (uint64_t)timeout->tv_sec * NANO_IN_SECOND +
+                   (uint64_t)timeout->tv_nsec;
+    }
+
+    myst_ticket_lock(&_lock);
+    {
+        if (!(thread = _lookup(event)))
+        {
+            myst_ticket_unlock(&_lock);
+            return -EINVAL;
+        }
+
+        /* consume a wakeup that arrived before the wait */
+        if (thread->mn.tokens)
+        {
+            thread->mn.tokens--;
+            myst_ticket_unlock(&_lock);
+            return 0;
+        }
+
+        if (timeout && timeout->tv_sec == 0 && timeout->tv_nsec == 0)
+        {
+            myst_ticket_unlock(&_lock);
+            return -ETIMEDOUT;
+        }
+
+        thread->mn.state = MYST_MN_WAITING;
+        thread->mn.timed_out = false;
+
+        if (timeout)
+        {
+            thread->mn.deadline = deadline;
+            _timer_insert(thread);
+        }
+    }
+    myst_ticket_unlock(&_lock);
+
+    _switch_to_carrier(thread);
+
+    return thread->mn.timed_out ? -ETIMEDOUT : 0;
+}
+
+long myst_mn_wake(uint64_t event)
+{
+    myst_thread_t* thread;
+    myst_mn_carrier_t* carrier = NULL;
+    long ret = 0;
+
+    myst_ticket_lock(&_lock);
+    {
+        /* ignore events of threads that have exited */
+        if ((thread = _lookup(event)))
+        {
+            if (thread->mn.state == MYST_MN_WAITING)
+            {
+                if (_make_runnable(thread))
+                    carrier = _pop_idle_carrier();
+
+                ret = 1;
+            }
+            else
+            {
+                thread->mn.tokens++;
+            }
+        }
+    }
+    myst_ticket_unlock(&_lock);
+
+    _wake_carrier(carrier);
+
+    return ret;
+}
+
+long myst_mn_yield(myst_thread_t* thread)
+{
+    myst_ticket_lock(&_lock);
+    {
+        /* keep running if nothing else is runnable */
+        if (!_run_head)
+        {
+            myst_ticket_unlock(&_lock);
+            return 0;
+        }
+
+        thread->mn.state = MYST_MN_RUNNABLE;
+    }
+    myst_ticket_unlock(&_lock);
+
+    _switch_to_carrier(thread);
+
+    return 0;
+}
+
+long myst_mn_sleep(const struct timespec* req, struct timespec* rem)
+{
+    myst_thread_t* self = myst_thread_self();
+    uint64_t deadline;
+    uint64_t now;
+
+    if (!req)
+        return -EFAULT;
+
+    if (req->tv_sec < 0 || req->tv_nsec < 0 ||
+        (uint64_t)req->tv_nsec >= NANO_IN_SECOND)
+    {
+        return -EINVAL;
+    }
+
+    now = _now();
+    deadline = now + (uint64_t)req->tv_sec * NANO_IN_SECOND +
+               (uint64_t)req->tv_nsec;
+
+    while (now < deadline)
+    {
+        struct timespec ts;
+
+        ts.tv_sec = (time_t)((deadline - now) / NANO_IN_SECOND);
+        ts.tv_nsec = (long)((deadline - now) % NANO_IN_SECOND);
+
+        self->signal.waiting_on_event = true;
+        myst_mn_wait(self->event, &ts);
+        self->signal.waiting_on_event = false;
+
+        now = _now();
+
+        if (myst_signal_has_active_signals(self))
+        {
+            if (rem)
+            {
+                const uint64_t left = now < deadline ? deadline - now : 0;
+                rem->tv_sec = (time_t)(left / NANO_IN_SECOND);
+                rem->tv_nsec = (long)(left % NANO_IN_SECOND);
+            }
+
+            return -EINTR;
+        }
+    }
+
+    return 0;
+}
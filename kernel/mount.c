@@ -22,7 +22,7 @@
 #include <myst/realpath.h>
 #include <myst/roothash.h>
 #include <myst/sha256.h>
-#include <myst/spinlock.h>
+#include <myst/rwspinlock.h>
 #include <myst/strings.h>
 #include <myst/syscall.h>
 #include <myst/verity.h>
@@ -43,7 +43,7 @@ typedef struct mount_table_entry
 
 static mount_table_entry_t _mount_table[MOUNT_TABLE_SIZE];
 static size_t _mount_table_size = 0;
-static myst_spinlock_t _lock = MYST_SPINLOCK_INITIALIZER;
+static myst_rwspinlock_t _lock = MYST_RWSPINLOCK_INITIALIZER;
 
 static bool _installed_free_mount_table = false;
 
@@ -85,7 +85,7 @@ int myst_mount_resolve(
     /* Find the real path (the absolute non-relative path). */
     ECHECK(myst_realpath(path, &locals->realpath));
 
-    myst_spin_lock(&_lock);
+    myst_rw_read_lock(&_lock);
     locked = true;
 
     /* Find the longest binding point that contains this path. */
@@ -123,7 +123,7 @@ int myst_mount_resolve(
 
     if (locked)
     {
-        myst_spin_unlock(&_lock);
+        myst_rw_read_unlock(&_lock);
         locked = false;
     }
 
@@ -138,7 +138,7 @@ done:
         free(locals);
 
     if (locked)
-        myst_spin_unlock(&_lock);
+        myst_rw_read_unlock(&_lock);
 
     return ret;
 }
@@ -187,7 +187,7 @@ int myst_mount(
     }
 
     /* Lock the mount table. */
-    myst_spin_lock(&_lock);
+    myst_rw_write_lock(&_lock);
     locked = true;
 
     /* Install _free_mount_table() if not already installed. */
@@ -239,7 +239,7 @@ done:
         free(mount_table_entry.path);
 
     if (locked)
-        myst_spin_unlock(&_lock);
+        myst_rw_write_unlock(&_lock);
 
     return ret;
 }
@@ -257,7 +257,7 @@ int myst_umount(const char* target)
     if (!(locals = malloc(sizeof(struct locals))))
         ERAISE(-ENOMEM);
 
-    myst_spin_lock(&_lock);
+    myst_rw_write_lock(&_lock);
 
     /* Find the real path (the absolute non-relative path) */
     ECHECK(myst_realpath(target, &locals->realpath));
@@ -295,7 +295,7 @@ done:
     if (locals)
         free(locals);
 
-    myst_spin_unlock(&_lock);
+    myst_rw_write_unlock(&_lock);
 
     return ret;
 }
@@ -304,7 +304,7 @@ int myst_teardown_auto_mounts()
 {
     int ret = 0;
 
-    myst_spin_lock(&_lock);
+    myst_rw_write_lock(&_lock);
 
     for (size_t i = 0; i < _mount_table_size; i++)
     {
@@ -329,7 +329,7 @@ int myst_teardown_auto_mounts()
 
 done:
 
-    myst_spin_unlock(&_lock);
+    myst_rw_write_unlock(&_lock);
 
     return ret;
 }
@@ -53,6 +53,13 @@ long myst_syscall_sendmmsg(
 
     ECHECK(myst_fdtable_get_sock(fdtable, sockfd, &sd, &sock));
 
+    /* let socket devices that support it send the vector in one go */
+    if (sd->sd_sendmmsg)
+    {
+        ret = (*sd->sd_sendmmsg)(sd, sock, msgvec, vlen, flags);
+        goto done;
+    }
+
     for (cnt = 0; cnt < vlen; cnt++)
     {
         ret = (*sd->sd_sendmsg)(sd, sock, &msgvec[cnt].msg_hdr, flags);
@@ -88,14 +95,22 @@ long myst_syscall_recvmmsg(
 
     ECHECK(myst_fdtable_get_sock(fdtable, sockfd, &sd, &sock));
 
-    if (timeout)
+    if (timeout && !is_timespec_valid(timeout))
+        ERAISE(-EINVAL);
+
+    /* let socket devices that support it receive the vector in one go */
+    if (sd->sd_recvmmsg)
     {
-        if (!is_timespec_valid(timeout))
-            ERAISE(-EINVAL);
+        ret = (*sd->sd_recvmmsg)(sd, sock, msgvec, vlen, flags, timeout);
+        goto done;
+    }
 
+    if (timeout)
+    {
         expire = timespec_to_nanos(timeout);
         myst_syscall_clock_gettime(CLOCK_MONOTONIC, &start);
     }
+
     for (cnt = 0; cnt < vlen; cnt++)
     {
         // The MSG_WAITFORONE flag is only recognizable by recvmmsg
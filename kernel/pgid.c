@@ -9,7 +9,7 @@ long myst_syscall_setpgid(pid_t pid, pid_t pgid, myst_thread_t* thread)
     long ret = 0;
     myst_process_t* process = myst_find_process(thread);
 
-    if (pgid < 0)
+    if (pid < 0 || pgid < 0)
         ERAISE(-EINVAL);
     if (pgid > 32767)
         ERAISE(-EPERM);
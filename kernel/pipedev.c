@@ -845,7 +845,7 @@ static int _pd_interrupt(myst_pipedev_t* pipedev, myst_pipe_t* pipe)
           myst_getpid());)
 
     /* signal any threads blocked on read or write */
-    myst_cond_signal(&pipe->shared->cond, FUTEX_BITSET_MATCH_ANY);
+    myst_cond_broadcast(&pipe->shared->cond, SIZE_MAX, FUTEX_BITSET_MATCH_ANY);
 
 done:
     T(printf("_pd_interrupt(%zu): done\n", _id(pipe));)
@@ -871,7 +871,7 @@ static int _pd_close(myst_pipedev_t* pipedev, myst_pipe_t* pipe)
     ECHECK(myst_tcall_close(pipe->fd));
 
     /* signal any threads blocked on read or write */
-    myst_cond_signal(&pipe->shared->cond, FUTEX_BITSET_MATCH_ANY);
+    myst_cond_broadcast(&pipe->shared->cond, SIZE_MAX, FUTEX_BITSET_MATCH_ANY);
 
     _lock(&pipe->shared->lock, &locked);
 
@@ -891,7 +891,8 @@ static int _pd_close(myst_pipedev_t* pipedev, myst_pipe_t* pipe)
     else
     {
         /* signal that this end of the pipe has been closed */
-        myst_cond_signal(&pipe->shared->cond, FUTEX_BITSET_MATCH_ANY);
+        myst_cond_broadcast(
+            &pipe->shared->cond, SIZE_MAX, FUTEX_BITSET_MATCH_ANY);
         _unlock(&pipe->shared->lock, &locked);
     }
 
@@ -11,6 +11,7 @@
 #include <myst/printf.h>
 #include <myst/strings.h>
 #include <myst/tcall.h>
+#include <myst/ttydev.h>
 
 int myst_console_printf(int fd, const char* format, ...)
 {
@@ -34,6 +35,10 @@ int myst_console_printf(int fd, const char* format, ...)
     if (count < 0 || (size_t)count >= sizeof(locals->buf))
         ERAISE(-EINVAL);
 
+    /* keep the order with the buffered output of the application */
+    if (__myst_ttydev_pending)
+        myst_ttydev_flush();
+
     ECHECK(myst_tcall_write_console(fd, locals->buf, (size_t)count));
 
 done:
@@ -66,6 +71,10 @@ int myst_console_vprintf(int fd, const char* format, va_list ap)
     if (count < 0 || (size_t)count >= sizeof(locals->buf))
         return -EINVAL;
 
+    /* keep the order with the buffered output of the application */
+    if (__myst_ttydev_pending)
+        myst_ttydev_flush();
+
     ECHECK(myst_tcall_write_console(fd, locals->buf, (size_t)count));
 
 done:
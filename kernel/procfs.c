@@ -421,7 +421,7 @@ static int _status_vcallback(
     size_t buf_size;
     myst_process_t* process;
 
-    myst_spin_lock(&myst_process_list_lock);
+    myst_rw_read_lock(&myst_process_list_lock);
 
     if (!(locals = calloc(1, sizeof(struct locals))))
         ERAISE(-ENOMEM);
@@ -506,7 +506,7 @@ static int _status_vcallback(
 
 done:
 
-    myst_spin_unlock(&myst_process_list_lock);
+    myst_rw_read_unlock(&myst_process_list_lock);
 
     if (locals && locals->_host_status_buf)
         free(locals->_host_status_buf);
@@ -545,7 +545,7 @@ static int _pid_stat_vcallback(
     int ret = 0;
     myst_process_t* process;
 
-    myst_spin_lock(&myst_process_list_lock);
+    myst_rw_read_lock(&myst_process_list_lock);
 
     if (!vbuf || !entrypath)
         ERAISE(-EINVAL);
@@ -630,7 +630,31 @@ static int _pid_stat_vcallback(
 
 done:
 
-    myst_spin_unlock(&myst_process_list_lock);
+    myst_rw_read_unlock(&myst_process_list_lock);
+
+    return ret;
+}
+
+static int _myst_syscalls_vcallback(
+    myst_file_t* self,
+    myst_buf_t* vbuf,
+    const char* entrypath)
+{
+    (void)self;
+    int ret = 0;
+
+    (void)entrypath;
+
+    if (!vbuf)
+        ERAISE(-EINVAL);
+
+    myst_buf_clear(vbuf);
+    ECHECK(myst_format_syscall_times(vbuf));
+
+done:
+
+    if (ret != 0)
+        myst_buf_release(vbuf);
 
     return ret;
 }
@@ -704,6 +728,15 @@ int create_proc_root_entries()
             _procfs, "/sys/kernel/pid_max", S_IFREG | S_IRUSR, v_cb));
     }
 
+    /* Create /proc/myst/syscalls */
+    {
+        myst_vcallback_t v_cb = {0};
+        v_cb.open_cb = _myst_syscalls_vcallback;
+        ECHECK(myst_mkdirhier("/proc/myst", 777));
+        ECHECK(myst_create_virtual_file(
+            _procfs, "/myst/syscalls", S_IFREG | S_IRUSR, v_cb));
+    }
+
 done:
     return ret;
 }
@@ -0,0 +1,624 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#define _GNU_SOURCE
+#include <elf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <myst/buf.h>
+#include <myst/eraise.h>
+#include <myst/hostfile.h>
+#include <myst/kernel.h>
+#include <myst/paths.h>
+#include <myst/printf.h>
+#include <myst/profile.h>
+#include <myst/spinlock.h>
+
+/* frames further than this from the interrupted RSP are not followed */
+#define MAX_STACK_SPAN (64 * 1024 * 1024)
+
+typedef struct sample
+{
+    /* the number of frames in pcs[] (zero while being written) */
+    uint32_t depth;
+
+    /* the host thread that was interrupted */
+    pid_t tid;
+
+    /* the interrupted RIP followed by the return addresses */
+    uint64_t pcs[MYST_PROFILE_MAX_DEPTH];
+} sample_t;
+
+typedef struct func
+{
+    uint64_t lo;
+    uint64_t hi;
+    const char* name;
+} func_t;
+
+typedef struct module
+{
+    struct module* next;
+
+    /* where the module is loaded */
+    uint64_t lo;
+    uint64_t hi;
+
+    /* the basename of the module path */
+    char* name;
+
+    /* the function symbols sorted by address */
+    func_t* funcs;
+    size_t num_funcs;
+
+    /* a copy of the string table that the function names point into */
+    char* strings;
+} module_t;
+
+/* the samples (allocated by myst_profile_init()) */
+static sample_t* _samples;
+
+/* the number of samples claimed so far (may exceed the maximum) */
+static uint64_t _num_claimed;
+
+/* set by myst_profile_dump() to stop further sampling */
+static bool _stopped;
+
+/* the modules registered by myst_profile_add_symbol_file() */
+static module_t* _modules;
+static myst_spinlock_t _modules_lock;
+
+int myst_profile_init(void)
+{
+    int ret = 0;
+
+    if (!__myst_kernel_args.profile)
+        goto done;
+
+    if (!(_samples = calloc(MYST_PROFILE_MAX_SAMPLES, sizeof(sample_t))))
+        ERAISE(-ENOMEM);
+
+done:
+    return ret;
+}
+
+/*
+**==============================================================================
+**
+** sampling:
+**
+**     Runs in a host signal handler on the interrupted stack, so it neither
+**     locks nor uses thread-local storage. The frame-pointer chain is only
+**     followed upwards within the image and within MAX_STACK_SPAN of the
+**     interrupted RSP, which keeps the walk on mapped stack memory even when
+**     the interrupted code uses RBP as a general purpose register.
+**
+**==============================================================================
+*/
+
+void myst_profile_sample(const mcontext_t* mcontext, pid_t tid)
+{
+    const uint64_t rsp = (uint64_t)mcontext->gregs[REG_RSP];
+    const uint64_t* fp = (const uint64_t*)mcontext->gregs[REG_RBP];
+    const uint64_t* prev = (const uint64_t*)rsp;
+    uint64_t index;
+    uint32_t depth = 0;
+    sample_t* s;
+
+    if (!_samples || __atomic_load_n(&_stopped, __ATOMIC_ACQUIRE))
+        return;
+
+    index = __atomic_fetch_add(&_num_claimed, 1, __ATOMIC_RELAXED);
+
+    if (index >= MYST_PROFILE_MAX_SAMPLES)
+        return;
+
+    s = &_samples[index];
+    s->tid = tid;
+    s->pcs[depth++] = (uint64_t)mcontext->gregs[REG_RIP];
+
+    while (depth < MYST_PROFILE_MAX_DEPTH)
+    {
+        if (fp < prev || ((uint64_t)fp & 7) != 0)
+            break;
+
+        if ((uint64_t)fp - rsp >= MAX_STACK_SPAN)
+            break;
+
+        if (!myst_is_addr_within_kernel(fp) ||
+            !myst_is_addr_within_kernel(fp + 1))
+        {
+            break;
+        }
+
+        if (fp[1] == 0)
+            break;
+
+        s->pcs[depth++] = fp[1];
+        prev = fp + 2;
+        fp = (const uint64_t*)fp[0];
+    }
+
+    /* publish the sample */
+    __atomic_store_n(&s->depth, depth, __ATOMIC_RELEASE);
+}
+
+/*
+**==============================================================================
+**
+** symbol tables:
+**
+**==============================================================================
+*/
+
+static void _swap(uint8_t* p, uint8_t* q, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        uint8_t t = p[i];
+        p[i] = q[i];
+        q[i] = t;
+    }
+}
+
+static void _sift_down(
+    uint8_t* base,
+    size_t root,
+    size_t n,
+    size_t size,
+    int (*compar)(const void*, const void*))
+{
+    size_t child;
+
+    while ((child = 2 * root + 1) < n)
+    {
+        if (child + 1 < n &&
+            compar(base + child * size, base + (child + 1) * size) < 0)
+        {
+            child++;
+        }
+
+        if (compar(base + root * size, base + child * size) >= 0)
+            break;
+
+        _swap(base + root * size, base + child * size, size);
+        root = child;
+    }
+}
+
+/* the kernel has no qsort(), so use an in-place heap sort */
+static void _sort(
+    void* base,
+    size_t n,
+    size_t size,
+    int (*compar)(const void*, const void*))
+{
+    uint8_t* p = base;
+
+    for (size_t i = n / 2; i > 0; i--)
+        _sift_down(p, i - 1, n, size, compar);
+
+    for (size_t i = n; i > 1; i--)
+    {
+        _swap(p, p + (i - 1) * size, size);
+        _sift_down(p, 0, i - 1, size, compar);
+    }
+}
+
+static int _compare_funcs(const void* p, const void* q)
+{
+    const func_t* f = p;
+    const func_t* g = q;
+
+    if (f->lo < g->lo)
+        return -1;
+
+    if (f->lo > g->lo)
+        return 1;
+
+    return 0;
+}
+
+/* append the function symbols of a symbol table relocated by bias */
+static int _add_funcs(
+    module_t* m,
+    const void* symtab,
+    size_t symtab_size,
+    const char* strtab,
+    size_t strtab_size,
+    uint64_t bias)
+{
+    int ret = 0;
+    const Elf64_Sym* syms = symtab;
+    const size_t n = symtab_size / sizeof(Elf64_Sym);
+    func_t* funcs;
+
+    if (!syms || !strtab || n == 0)
+        goto done;
+
+    if (!(funcs = realloc(m->funcs, (m->num_funcs + n) * sizeof(func_t))))
+        ERAISE(-ENOMEM);
+
+    m->funcs = funcs;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        const Elf64_Sym* p = &syms[i];
+        func_t* f;
+
+        if (ELF64_ST_TYPE(p->st_info) != STT_FUNC)
+            continue;
+
+        if (p->st_shndx == SHN_UNDEF || p->st_value == 0 || p->st_size == 0)
+            continue;
+
+        if (p->st_name >= strtab_size)
+            continue;
+
+        f = &m->funcs[m->num_funcs++];
+        f->lo = bias + p->st_value;
+        f->hi = f->lo + p->st_size;
+        f->name = strtab + p->st_name;
+    }
+
+done:
+    return ret;
+}
+
+static const func_t* _find_func(const module_t* m, uint64_t addr)
+{
+    size_t lo = 0;
+    size_t hi = m->num_funcs;
+
+    /* find the last function that starts at or before addr */
+    while (lo < hi)
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+
+        if (m->funcs[mid].lo <= addr)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo == 0 || addr >= m->funcs[lo - 1].hi)
+        return NULL;
+
+    return &m->funcs[lo - 1];
+}
+
+static void _free_module(module_t* m)
+{
+    if (m)
+    {
+        free(m->name);
+        free(m->funcs);
+        free(m->strings);
+        free(m);
+    }
+}
+
+/* read the symbols of an ELF file whose lowest segment is loaded at text */
+static int _load_module(
+    module_t* m,
+    const uint8_t* data,
+    size_t size,
+    uint64_t text)
+{
+    int ret = 0;
+    const Elf64_Ehdr* eh = (const Elf64_Ehdr*)data;
+    const Elf64_Shdr* sh;
+    const Elf64_Shdr* symtab = NULL;
+    const Elf64_Shdr* strtab;
+    uint64_t min_vaddr = UINT64_MAX;
+    uint64_t bias;
+
+    if (size < sizeof(Elf64_Ehdr) || memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0)
+        ERAISE(-ENOEXEC);
+
+    if (eh->e_phoff > size ||
+        eh->e_phnum > (size - eh->e_phoff) / sizeof(Elf64_Phdr))
+    {
+        ERAISE(-ENOEXEC);
+    }
+
+    if (eh->e_shoff > size ||
+        eh->e_shnum > (size - eh->e_shoff) / sizeof(Elf64_Shdr))
+    {
+        ERAISE(-ENOEXEC);
+    }
+
+    /* the loader maps the lowest segment at text (rounded down to a page) */
+    for (size_t i = 0; i < eh->e_phnum; i++)
+    {
+        const Elf64_Phdr* ph = (const Elf64_Phdr*)(data + eh->e_phoff) + i;
+
+        if (ph->p_type == PT_LOAD && ph->p_vaddr < min_vaddr)
+            min_vaddr = ph->p_vaddr;
+    }
+
+    if (min_vaddr == UINT64_MAX)
+        ERAISE(-ENOEXEC);
+
+    bias = text - (min_vaddr & ~(uint64_t)(PAGE_SIZE - 1));
+
+    /* prefer the full symbol table over the dynamic one */
+    sh = (const Elf64_Shdr*)(data + eh->e_shoff);
+
+    for (size_t i = 0; i < eh->e_shnum; i++)
+    {
+        if (sh[i].sh_type == SHT_SYMTAB)
+        {
+            symtab = &sh[i];
+            break;
+        }
+
+        if (sh[i].sh_type == SHT_DYNSYM)
+            symtab = &sh[i];
+    }
+
+    if (!symtab || symtab->sh_link >= eh->e_shnum)
+        goto done;
+
+    strtab = &sh[symtab->sh_link];
+
+    if (symtab->sh_offset > size || symtab->sh_size > size - symtab->sh_offset)
+        ERAISE(-ENOEXEC);
+
+    if (strtab->sh_offset > size || strtab->sh_size > size - strtab->sh_offset)
+        ERAISE(-ENOEXEC);
+
+    if (!(m->strings = malloc(strtab->sh_size)))
+        ERAISE(-ENOMEM);
+
+    memcpy(m->strings, data + strtab->sh_offset, strtab->sh_size);
+
+    ECHECK(_add_funcs(
+        m,
+        data + symtab->sh_offset,
+        symtab->sh_size,
+        m->strings,
+        strtab->sh_size,
+        bias));
+
+    _sort(m->funcs, m->num_funcs, sizeof(func_t), _compare_funcs);
+
+done:
+    return ret;
+}
+
+int myst_profile_add_symbol_file(
+    const char* path,
+    const void* file_data,
+    size_t file_size,
+    const void* text,
+    size_t text_size)
+{
+    int ret = 0;
+    module_t* m = NULL;
+
+    if (!path || !file_data || !text || !text_size)
+        ERAISE(-EINVAL);
+
+    if (!_samples)
+        goto done;
+
+    if (!(m = calloc(1, sizeof(module_t))))
+        ERAISE(-ENOMEM);
+
+    m->lo = (uint64_t)text;
+    m->hi = m->lo + text_size;
+
+    if (!(m->name = strdup(myst_basename(path))))
+        ERAISE(-ENOMEM);
+
+    ECHECK(_load_module(m, file_data, file_size, m->lo));
+
+    /* newer modules come first since they may reuse an unloaded range */
+    myst_spin_lock(&_modules_lock);
+    m->next = _modules;
+    _modules = m;
+    myst_spin_unlock(&_modules_lock);
+    m = NULL;
+
+done:
+    _free_module(m);
+    return ret;
+}
+
+/*
+**==============================================================================
+**
+** folded stacks:
+**
+**==============================================================================
+*/
+
+static int _append_str(myst_buf_t* buf, const char* s)
+{
+    return myst_buf_append(buf, s, strlen(s));
+}
+
+static int _append_frame(myst_buf_t* buf, const module_t* kernel, uint64_t pc)
+{
+    int ret = 0;
+    const func_t* f;
+
+    if (pc >= kernel->lo && pc < kernel->hi)
+    {
+        f = _find_func(kernel, pc);
+        ECHECK(_append_str(buf, f ? f->name : "[kernel]"));
+        ECHECK(_append_str(buf, "_[k]"));
+        goto done;
+    }
+
+    for (const module_t* m = _modules; m; m = m->next)
+    {
+        if (pc >= m->lo && pc < m->hi)
+        {
+            if ((f = _find_func(m, pc)))
+            {
+                ECHECK(_append_str(buf, f->name));
+            }
+            else
+            {
+                ECHECK(_append_str(buf, "["));
+                ECHECK(_append_str(buf, m->name));
+                ECHECK(_append_str(buf, "]"));
+            }
+
+            goto done;
+        }
+    }
+
+    if (myst_is_addr_within_kernel((const void*)pc))
+        ECHECK(_append_str(buf, "[unknown]"));
+    else
+        ECHECK(_append_str(buf, "[host]"));
+
+done:
+    return ret;
+}
+
+/* format a sample as "thread-<tid>;<outermost>;...;<innermost>" */
+static int _fold_sample(const sample_t* s, const module_t* kernel, char** line)
+{
+    int ret = 0;
+    myst_buf_t buf = MYST_BUF_INITIALIZER;
+    char tmp[32];
+
+    snprintf(tmp, sizeof(tmp), "thread-%d", s->tid);
+    ECHECK(_append_str(&buf, tmp));
+
+    for (size_t i = s->depth; i > 0; i--)
+    {
+        uint64_t pc = s->pcs[i - 1];
+
+        /* return addresses point past the call, into the next statement */
+        if (i > 1)
+            pc--;
+
+        ECHECK(myst_buf_append(&buf, ";", 1));
+        ECHECK(_append_frame(&buf, kernel, pc));
+    }
+
+    ECHECK(myst_buf_append(&buf, "", 1));
+    *line = (char*)buf.data;
+    buf.data = NULL;
+
+done:
+    myst_buf_release(&buf);
+    return ret;
+}
+
+static int _compare_lines(const void* p, const void* q)
+{
+    return strcmp(*(char* const*)p, *(char* const*)q);
+}
+
+int myst_profile_dump(void)
+{
+    int ret = 0;
+    const char* path = __myst_kernel_args.profile_path;
+    module_t kernel = {0};
+    char** lines = NULL;
+    size_t num_lines = 0;
+    size_t num_samples;
+    myst_buf_t out = MYST_BUF_INITIALIZER;
+    char tmp[32];
+
+    if (!_samples)
+        goto done;
+
+    __atomic_store_n(&_stopped, true, __ATOMIC_RELEASE);
+    num_samples = __atomic_load_n(&_num_claimed, __ATOMIC_ACQUIRE);
+
+    if (num_samples > MYST_PROFILE_MAX_SAMPLES)
+    {
+        myst_eprintf(
+            "kernel: profile: dropped %zu samples\n",
+            num_samples - MYST_PROFILE_MAX_SAMPLES);
+        num_samples = MYST_PROFILE_MAX_SAMPLES;
+    }
+
+    /* the kernel symbols are relative to the kernel image */
+    kernel.lo = (uint64_t)__myst_kernel_args.kernel_data;
+    kernel.hi = kernel.lo + __myst_kernel_args.kernel_size;
+
+    ECHECK(_add_funcs(
+        &kernel,
+        __myst_kernel_args.symtab_data,
+        __myst_kernel_args.symtab_size,
+        __myst_kernel_args.strtab_data,
+        __myst_kernel_args.strtab_size,
+        kernel.lo));
+
+    ECHECK(_add_funcs(
+        &kernel,
+        __myst_kernel_args.dynsym_data,
+        __myst_kernel_args.dynsym_size,
+        __myst_kernel_args.dynstr_data,
+        __myst_kernel_args.dynstr_size,
+        kernel.lo));
+
+    _sort(kernel.funcs, kernel.num_funcs, sizeof(func_t), _compare_funcs);
+
+    if (!(lines = calloc(num_samples + 1, sizeof(char*))))
+        ERAISE(-ENOMEM);
+
+    myst_spin_lock(&_modules_lock);
+
+    for (size_t i = 0; i < num_samples; i++)
+    {
+        const sample_t* s = &_samples[i];
+
+        if (__atomic_load_n(&s->depth, __ATOMIC_ACQUIRE) == 0)
+            continue;
+
+        if ((ret = _fold_sample(s, &kernel, &lines[num_lines])) != 0)
+            break;
+
+        num_lines++;
+    }
+
+    myst_spin_unlock(&_modules_lock);
+    ECHECK(ret);
+
+    /* sort the lines so that identical stacks are adjacent and count them */
+    _sort(lines, num_lines, sizeof(char*), _compare_lines);
+
+    for (size_t i = 0; i < num_lines;)
+    {
+        size_t j = i + 1;
+
+        while (j < num_lines && strcmp(lines[i], lines[j]) == 0)
+            j++;
+
+        snprintf(tmp, sizeof(tmp), " %zu\n", j - i);
+        ECHECK(_append_str(&out, lines[i]));
+        ECHECK(_append_str(&out, tmp));
+        i = j;
+    }
+
+    ECHECK(myst_write_host_file(path, out.data, out.size));
+
+done:
+
+    if (ret != 0)
+        myst_eprintf("kernel: failed to write profile to %s: %d\n", path, ret);
+
+    if (lines)
+    {
+        for (size_t i = 0; i < num_lines; i++)
+            free(lines[i]);
+
+        free(lines);
+    }
+
+    free(kernel.funcs);
+    myst_buf_release(&out);
+
+    return ret;
+}
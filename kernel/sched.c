@@ -47,9 +47,11 @@ long myst_syscall_sched_getparam(pid_t pid, struct sched_param* param)
             params[0] = (long)process->main_process_thread->target_tid;
         else
         {
+            myst_rw_read_lock(&myst_tid_hash_lock);
             myst_thread_t* thread = myst_find_thread(pid);
             if (thread)
                 params[0] = (long)thread->target_tid;
+            myst_rw_read_unlock(&myst_tid_hash_lock);
         }
         /* If params[0] is not set yet, then pid could not be found */
         if (!params[0])
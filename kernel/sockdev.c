@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 
+#define _GNU_SOURCE
 #include <errno.h>
 #include <limits.h>
 #include <stdlib.h>
@@ -21,6 +22,7 @@
 #include <myst/syscall.h>
 #include <myst/syslog.h>
 #include <myst/tcall.h>
+#include <myst/times.h>
 
 #define MAGIC 0xc436d7e6
 
@@ -415,6 +417,130 @@ done:
     return ret;
 }
 
+static int _sd_sendmmsg(
+    myst_sockdev_t* sd,
+    myst_sock_t* sock,
+    struct mmsghdr* msgvec,
+    unsigned int vlen,
+    int flags)
+{
+    int ret = 0;
+    unsigned int cnt = 0;
+    bool nowait;
+
+    if (!sd || !_valid_sock(sock))
+        ERAISE(-EINVAL);
+
+    if (!msgvec && vlen)
+        ERAISE(-EFAULT);
+
+    nowait = sock->nonblock || (flags & MSG_DONTWAIT);
+
+    /* each tcall sends as many of the remaining messages as the host socket
+     * takes without blocking; a blocking socket waits for room for the rest */
+    while (cnt < vlen)
+    {
+        struct mmsghdr* vec = &msgvec[cnt];
+        unsigned int len = vlen - cnt;
+        long r;
+
+        if (nowait)
+            r = myst_tcall_sendmmsg(sock->fd, vec, len, flags);
+        else
+            r = myst_tcall_sendmmsg_block(sock->fd, vec, len, flags);
+
+        if (r <= 0)
+        {
+            /* only return an error when no message was sent */
+            if (cnt == 0)
+                ERAISE((int)r);
+            break;
+        }
+
+        cnt += (unsigned int)r;
+
+        if (nowait)
+            break;
+    }
+
+    ret = (int)cnt;
+
+done:
+    return ret;
+}
+
+static int _sd_recvmmsg(
+    myst_sockdev_t* sd,
+    myst_sock_t* sock,
+    struct mmsghdr* msgvec,
+    unsigned int vlen,
+    int flags,
+    const struct timespec* timeout)
+{
+    int ret = 0;
+    unsigned int cnt = 0;
+    struct timespec start;
+    long expire = 0;
+    bool nowait;
+
+    if (!sd || !_valid_sock(sock))
+        ERAISE(-EINVAL);
+
+    if (!msgvec && vlen)
+        ERAISE(-EFAULT);
+
+    nowait = sock->nonblock || (flags & MSG_DONTWAIT);
+
+    if (timeout)
+    {
+        expire = timespec_to_nanos(timeout);
+        myst_syscall_clock_gettime(CLOCK_MONOTONIC, &start);
+    }
+
+    /* each tcall receives every remaining message the host socket already
+     * holds; a blocking socket then waits for more until vlen messages have
+     * arrived, the timeout expired or MSG_WAITFORONE said to stop */
+    while (cnt < vlen)
+    {
+        struct mmsghdr* vec = &msgvec[cnt];
+        unsigned int len = vlen - cnt;
+        const int rflags = flags & ~MSG_WAITFORONE;
+        long r;
+
+        if (nowait)
+            r = myst_tcall_recvmmsg(sock->fd, vec, len, rflags);
+        else
+            r = myst_tcall_recvmmsg_block(sock->fd, vec, len, rflags);
+
+        if (r <= 0)
+        {
+            /* only return an error when no message was received */
+            if (cnt == 0)
+                ERAISE((int)r);
+            break;
+        }
+
+        cnt += (unsigned int)r;
+
+        if (nowait || (flags & MSG_WAITFORONE))
+            break;
+
+        if (timeout)
+        {
+            struct timespec now;
+            myst_syscall_clock_gettime(CLOCK_MONOTONIC, &now);
+
+            if (myst_lapsed_nsecs(&start, &now) >= expire)
+                break;
+        }
+    }
+
+    ret = (int)cnt;
+
+done:
+    return ret;
+}
+
 static int _sd_shutdown(myst_sockdev_t* sd, myst_sock_t* sock, int how)
 {
     ssize_t ret = 0;
@@ -575,8 +701,21 @@ static ssize_t _sd_readv(
     if (!sd || !_valid_sock(sock))
         ERAISE(-EINVAL);
 
-    ret = myst_fdops_readv(&sd->fdops, sock, iov, iovcnt);
-    ECHECK(ret);
+    if (!iov && iovcnt)
+        ERAISE(-EINVAL);
+
+    /* pass the iovecs to the host rather than reading into a flat buffer */
+    if (sock->nonblock)
+    {
+        ECHECK(ret = myst_tcall_readv(sock->fd, iov, iovcnt));
+    }
+    else
+    {
+        /* a blocking readv() on a socket is a recvmsg() without flags */
+        struct msghdr msg = {
+            .msg_iov = (struct iovec*)iov, .msg_iovlen = (size_t)iovcnt};
+        ECHECK(ret = myst_tcall_recvmsg_block(sock->fd, &msg, 0));
+    }
 
 done:
     return ret;
@@ -593,8 +732,20 @@ static ssize_t _sd_writev(
     if (!sd || !_valid_sock(sock))
         ERAISE(-EINVAL);
 
-    ret = myst_fdops_writev(&sd->fdops, sock, iov, iovcnt);
-    ECHECK(ret);
+    if (!iov && iovcnt)
+        ERAISE(-EINVAL);
+
+    if (sock->nonblock)
+    {
+        ECHECK(ret = myst_tcall_writev(sock->fd, iov, iovcnt));
+    }
+    else
+    {
+        /* a blocking writev() on a socket is a sendmsg() without flags */
+        struct msghdr msg = {
+            .msg_iov = (struct iovec*)iov, .msg_iovlen = (size_t)iovcnt};
+        ECHECK(ret = myst_tcall_sendmsg_block(sock->fd, &msg, 0));
+    }
 
 done:
     return ret;
@@ -801,6 +952,8 @@ myst_sockdev_t* myst_sockdev_get(void)
         .sd_recvfrom = _sd_recvfrom,
         .sd_sendmsg = _sd_sendmsg,
         .sd_recvmsg = _sd_recvmsg,
+        .sd_sendmmsg = _sd_sendmmsg,
+        .sd_recvmmsg = _sd_recvmmsg,
         .sd_shutdown = _sd_shutdown,
         .sd_getsockopt = _sd_getsockopt,
         .sd_setsockopt = _sd_setsockopt,
@@ -0,0 +1,298 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <myst/buf.h>
+#include <myst/eraise.h>
+#include <myst/hostfile.h>
+#include <myst/kernel.h>
+#include <myst/printf.h>
+#include <myst/spantrace.h>
+#include <myst/syscall.h>
+#include <myst/tcall.h>
+#include <myst/thread.h>
+#include <myst/times.h>
+
+typedef struct span
+{
+    /* the category (NULL while being written) */
+    const char* cat;
+    const char* name;
+    long arg;
+
+    /* the start and end times in ticks */
+    uint64_t start;
+    uint64_t end;
+
+    pid_t pid;
+    pid_t tid;
+} span_t;
+
+/* the spans (allocated by myst_spantrace_init()) */
+static span_t* _spans;
+
+/* the number of spans claimed so far (may exceed the maximum) */
+static uint64_t _num_claimed;
+
+/* the time that span times are shown relative to */
+static uint64_t _start_ticks;
+
+#define TCALL_NAME(NAME) [MYST_TCALL_##NAME - MYST_TCALL_RANDOM] = #NAME
+
+static const char* _tcall_names[] = {
+    TCALL_NAME(RANDOM),
+    TCALL_NAME(VSNPRINTF),
+    TCALL_NAME(WRITE_CONSOLE),
+    TCALL_NAME(GEN_CREDS),
+    TCALL_NAME(FREE_CREDS),
+    TCALL_NAME(VERIFY_CERT),
+    TCALL_NAME(GEN_CREDS_EX),
+    TCALL_NAME(CLOCK_GETTIME),
+    TCALL_NAME(CLOCK_SETTIME),
+    TCALL_NAME(ISATTY),
+    TCALL_NAME(ADD_SYMBOL_FILE),
+    TCALL_NAME(LOAD_SYMBOLS),
+    TCALL_NAME(UNLOAD_SYMBOLS),
+    TCALL_NAME(CREATE_THREAD),
+    TCALL_NAME(WAIT),
+    TCALL_NAME(WAKE),
+    TCALL_NAME(WAKE_WAIT),
+    TCALL_NAME(SET_RUN_THREAD_FUNCTION),
+    TCALL_NAME(TARGET_STAT),
+    TCALL_NAME(SET_TSD),
+    TCALL_NAME(GET_TSD),
+    TCALL_NAME(GET_ERRNO_LOCATION),
+    TCALL_NAME(READ_CONSOLE),
+    TCALL_NAME(POLL_WAKE),
+    TCALL_NAME(OPEN_BLOCK_DEVICE),
+    TCALL_NAME(CLOSE_BLOCK_DEVICE),
+    TCALL_NAME(READ_BLOCK_DEVICE),
+    TCALL_NAME(WRITE_BLOCK_DEVICE),
+    TCALL_NAME(LUKS_ENCRYPT),
+    TCALL_NAME(LUKS_DECRYPT),
+    TCALL_NAME(SHA256_START),
+    TCALL_NAME(SHA256_UPDATE),
+    TCALL_NAME(SHA256_FINISH),
+    TCALL_NAME(VERIFY_SIGNATURE),
+    TCALL_NAME(LOAD_FSSIG),
+    TCALL_NAME(CLOCK_GETRES),
+    TCALL_NAME(GCOV),
+    TCALL_NAME(INTERRUPT_THREAD),
+    TCALL_NAME(CONNECT_BLOCK),
+    TCALL_NAME(ACCEPT4_BLOCK),
+    TCALL_NAME(READ_BLOCK),
+    TCALL_NAME(WRITE_BLOCK),
+    TCALL_NAME(RECVFROM_BLOCK),
+    TCALL_NAME(SENDTO_BLOCK),
+    TCALL_NAME(RECVMSG_BLOCK),
+    TCALL_NAME(SENDMSG_BLOCK),
+    TCALL_NAME(TD_SET_EXCEPTION_HANDLER_STACK),
+    TCALL_NAME(TD_REGISTER_EXCEPTION_HANDLER_STACK),
+    TCALL_NAME(TD_UNREGISTER_EXCEPTION_HANDLER_STACK),
+    TCALL_NAME(WAKE_MANY),
+    TCALL_NAME(SENDMMSG_BLOCK),
+    TCALL_NAME(RECVMMSG_BLOCK),
+};
+
+static const size_t _num_tcall_names = MYST_COUNTOF(_tcall_names);
+
+int myst_spantrace_init(void)
+{
+    int ret = 0;
+
+    if (!__myst_kernel_args.trace_spans)
+        goto done;
+
+    if (!(_spans = calloc(MYST_SPANTRACE_MAX_SPANS, sizeof(span_t))))
+        ERAISE(-ENOMEM);
+
+    _start_ticks = myst_times_ticks();
+
+done:
+    return ret;
+}
+
+uint64_t myst_span_begin(void)
+{
+    if (!_spans)
+        return 0;
+
+    return myst_times_ticks();
+}
+
+void myst_span_end(const char* cat, const char* name, long arg, uint64_t start)
+{
+    if (_spans && start)
+        myst_span_record(cat, name, arg, start, myst_times_ticks());
+}
+
+void myst_span_record(
+    const char* cat,
+    const char* name,
+    long arg,
+    uint64_t start,
+    uint64_t end)
+{
+    uint64_t index;
+    uint64_t value = 0;
+    const myst_thread_t* thread;
+    span_t* s;
+
+    if (!_spans || !cat)
+        return;
+
+    index = __atomic_fetch_add(&_num_claimed, 1, __ATOMIC_RELAXED);
+
+    if (index >= MYST_SPANTRACE_MAX_SPANS)
+        return;
+
+    s = &_spans[index];
+    s->name = name;
+    s->arg = arg;
+    s->start = start;
+    s->end = end;
+
+    /* myst_thread_self() asserts that there is a thread, which is not the
+     * case before the main thread is created */
+    myst_tcall_get_tsd(&value);
+    thread = (const myst_thread_t*)value;
+
+    if (myst_valid_thread(thread))
+    {
+        s->pid = thread->process->pid;
+        s->tid = thread->tid;
+    }
+
+    /* publish the span */
+    __atomic_store_n(&s->cat, cat, __ATOMIC_RELEASE);
+}
+
+static const char* _span_name(const span_t* s)
+{
+    const char* name = s->name;
+
+    if (name)
+        return name;
+
+    if (s->arg >= MYST_TCALL_RANDOM &&
+        (size_t)(s->arg - MYST_TCALL_RANDOM) < _num_tcall_names)
+    {
+        name = _tcall_names[s->arg - MYST_TCALL_RANDOM];
+    }
+    else
+    {
+        name = myst_syscall_name(s->arg);
+    }
+
+    if (name && strncmp(name, "SYS_", 4) == 0)
+        name += 4;
+
+    return name ? name : "unknown";
+}
+
+static uint64_t _ticks_to_nsecs(uint64_t ticks, uint64_t mult)
+{
+    if (mult)
+        return (uint64_t)(((__uint128_t)ticks * mult) >> 32);
+
+    return ticks;
+}
+
+static int _append(myst_buf_t* buf, const char* s)
+{
+    return myst_buf_append(buf, s, strlen(s));
+}
+
+/* format a time in nanoseconds as microseconds (the Chrome trace unit) */
+static int _append_usecs(myst_buf_t* buf, uint64_t nsecs)
+{
+    char tmp[64];
+
+    snprintf(tmp, sizeof(tmp), "%lu.%03lu", nsecs / 1000, nsecs % 1000);
+    return _append(buf, tmp);
+}
+
+static int _append_span(myst_buf_t* buf, const span_t* s, uint64_t mult)
+{
+    int ret = 0;
+    uint64_t start = s->start > _start_ticks ? s->start - _start_ticks : 0;
+    uint64_t lapsed = s->end > s->start ? s->end - s->start : 0;
+    char tmp[128];
+
+    ECHECK(_append(buf, "{\"name\":\""));
+    ECHECK(_append(buf, _span_name(s)));
+    ECHECK(_append(buf, "\",\"cat\":\""));
+    ECHECK(_append(buf, s->cat));
+    ECHECK(_append(buf, "\",\"ph\":\"X\",\"ts\":"));
+    ECHECK(_append_usecs(buf, _ticks_to_nsecs(start, mult)));
+    ECHECK(_append(buf, ",\"dur\":"));
+    ECHECK(_append_usecs(buf, _ticks_to_nsecs(lapsed, mult)));
+
+    snprintf(
+        tmp,
+        sizeof(tmp),
+        ",\"pid\":%d,\"tid\":%d,\"args\":{\"arg\":%ld}}",
+        s->pid,
+        s->tid,
+        s->arg);
+    ECHECK(_append(buf, tmp));
+
+done:
+    return ret;
+}
+
+int myst_spantrace_dump(void)
+{
+    int ret = 0;
+    const char* path = __myst_kernel_args.trace_spans_path;
+    const uint64_t mult = myst_times_ticks_mult();
+    myst_buf_t buf = MYST_BUF_INITIALIZER;
+    uint64_t num_spans;
+    bool first = true;
+
+    if (!_spans)
+        goto done;
+
+    num_spans = __atomic_load_n(&_num_claimed, __ATOMIC_ACQUIRE);
+
+    if (num_spans > MYST_SPANTRACE_MAX_SPANS)
+    {
+        myst_eprintf(
+            "kernel: trace-spans: dropped %lu spans\n",
+            num_spans - MYST_SPANTRACE_MAX_SPANS);
+        num_spans = MYST_SPANTRACE_MAX_SPANS;
+    }
+
+    ECHECK(_append(&buf, "{\"traceEvents\":[\n"));
+
+    for (uint64_t i = 0; i < num_spans; i++)
+    {
+        const span_t* s = &_spans[i];
+
+        /* skip spans that are still being written */
+        if (!__atomic_load_n(&s->cat, __ATOMIC_ACQUIRE))
+            continue;
+
+        if (!first)
+            ECHECK(_append(&buf, ",\n"));
+
+        ECHECK(_append_span(&buf, s, mult));
+        first = false;
+    }
+
+    ECHECK(_append(&buf, "\n],\"displayTimeUnit\":\"ms\"}\n"));
+
+    ECHECK(myst_write_host_file(path, buf.data, buf.size));
+
+done:
+
+    if (ret != 0)
+        myst_eprintf("kernel: failed to write spans to %s: %d\n", path, ret);
+
+    myst_buf_release(&buf);
+
+    return ret;
+}
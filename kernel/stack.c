@@ -1,5 +1,7 @@
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <myst/kstack.h>
 #include <myst/spinlock.h>
@@ -12,10 +14,13 @@ typedef struct stack
 } stack_t;
 
 // There is one entry stack, N kernel stacks, and N threads that may enter the
-// kernel from the host, where N == MYST_MAX_KSTACKS.
+// kernel from the host, where N == MYST_MAX_KSTACKS. The table grows beyond
+// this when threads are multiplexed onto host threads (see --mn-threads).
 #define MAX_STACKS (1 + MYST_MAX_KSTACKS + MYST_MAX_KSTACKS)
 
-static stack_t _stacks[MAX_STACKS];
+static stack_t _static_stacks[MAX_STACKS];
+static stack_t* _stacks = _static_stacks;
+static size_t _max_stacks = MAX_STACKS;
 static size_t _nstacks;
 static myst_spinlock_t _lock = MYST_SPINLOCK_INITIALIZER;
 
@@ -25,9 +30,24 @@ int myst_register_stack(const void* stack, size_t size)
 
     myst_spin_lock(&_lock);
     {
-        assert(_nstacks < MAX_STACKS);
+        if (_nstacks == _max_stacks)
+        {
+            const size_t n = _max_stacks * 2;
+            stack_t* stacks;
+
+            if ((stacks = malloc(n * sizeof(stack_t))))
+            {
+                memcpy(stacks, _stacks, _nstacks * sizeof(stack_t));
+
+                if (_stacks != _static_stacks)
+                    free(_stacks);
+
+                _stacks = stacks;
+                _max_stacks = n;
+            }
+        }
 
-        if (_nstacks < MAX_STACKS)
+        if (_nstacks < _max_stacks)
         {
             _stacks[_nstacks].stack = stack;
             _stacks[_nstacks].size = size;
@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <myst/eraise.h>
+#include <myst/hostfile.h>
+#include <myst/kernel.h>
+#include <myst/printf.h>
+#include <myst/stracebin.h>
+#include <myst/thread.h>
+#include <myst/times.h>
+
+/* the ring of records (allocated by myst_strace_init()) */
+static myst_strace_record_t* _ring;
+
+/* the number of records claimed so far */
+static uint64_t _count;
+
+int myst_strace_init(void)
+{
+    int ret = 0;
+    const size_t size = MYST_STRACE_RING_SIZE * sizeof(myst_strace_record_t);
+
+    if (!__myst_kernel_args.strace_config.binary)
+        goto done;
+
+    if (!(_ring = calloc(1, size)))
+        ERAISE(-ENOMEM);
+
+done:
+    return ret;
+}
+
+void myst_strace_record(long n, const long params[6], long ret)
+{
+    myst_thread_t* thread = myst_thread_self();
+    uint64_t seq;
+    myst_strace_record_t* r;
+
+    if (!_ring)
+        return;
+
+    /* claim a slot and invalidate it before writing the record into it */
+    seq = __atomic_add_fetch(&_count, 1, __ATOMIC_RELAXED);
+    r = &_ring[(seq - 1) % MYST_STRACE_RING_SIZE];
+    __atomic_store_n(&r->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    r->enter_ticks = thread->enter_kernel_ticks;
+    r->leave_ticks = thread->leave_kernel_ticks;
+    r->n = n;
+    memcpy(r->params, params, sizeof(r->params));
+    r->ret = ret;
+    r->pid = thread->process->pid;
+    r->tid = thread->tid;
+
+    /* publish the record */
+    __atomic_store_n(&r->seq, seq, __ATOMIC_RELEASE);
+}
+
+int myst_strace_dump(void)
+{
+    int ret = 0;
+    const char* path = __myst_kernel_args.strace_config.binary_path;
+    uint64_t count = __atomic_load_n(&_count, __ATOMIC_ACQUIRE);
+    uint64_t first;
+    myst_strace_header_t* header = NULL;
+    myst_strace_record_t* records;
+    size_t num_records = 0;
+    size_t size;
+
+    if (!_ring)
+        goto done;
+
+    first = count > MYST_STRACE_RING_SIZE ? count - MYST_STRACE_RING_SIZE : 0;
+
+    /* the file is the header followed by the records */
+    size = sizeof(myst_strace_header_t);
+    size += (count - first) * sizeof(myst_strace_record_t);
+
+    if (!(header = calloc(1, size)))
+        ERAISE(-ENOMEM);
+
+    records = (myst_strace_record_t*)(header + 1);
+
+    /* copy the records oldest first, skipping those being (re)written */
+    for (uint64_t seq = first + 1; seq <= count; seq++)
+    {
+        const size_t index = (seq - 1) % MYST_STRACE_RING_SIZE;
+        const myst_strace_record_t* r = &_ring[index];
+
+        if (__atomic_load_n(&r->seq, __ATOMIC_ACQUIRE) != seq)
+            continue;
+
+        records[num_records] = *r;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (__atomic_load_n(&r->seq, __ATOMIC_RELAXED) == seq)
+            num_records++;
+    }
+
+    header->magic = MYST_STRACE_MAGIC;
+    header->version = MYST_STRACE_VERSION;
+    header->record_size = sizeof(myst_strace_record_t);
+    header->num_records = num_records;
+    header->num_dropped = count - num_records;
+    header->ticks_mult = myst_times_ticks_mult();
+
+    size = sizeof(myst_strace_header_t);
+    size += num_records * sizeof(myst_strace_record_t);
+
+    ECHECK(myst_write_host_file(path, header, size));
+
+done:
+
+    if (ret != 0)
+        myst_eprintf("kernel: failed to write strace to %s: %d\n", path, ret);
+
+    if (header)
+        free(header);
+
+    return ret;
+}
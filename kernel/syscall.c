@@ -68,6 +68,7 @@
 #include <myst/pipedev.h>
 #include <myst/printf.h>
 #include <myst/process.h>
+#include <myst/profile.h>
 #include <myst/pubkey.h>
 #include <myst/ramfs.h>
 #include <myst/realpath.h>
@@ -75,7 +76,9 @@
 #include <myst/setjmp.h>
 #include <myst/signal.h>
 #include <myst/sockdev.h>
+#include <myst/spantrace.h>
 #include <myst/spinlock.h>
+#include <myst/stracebin.h>
 #include <myst/strings.h>
 #include <myst/syscall.h>
 #include <myst/syscallext.h>
@@ -86,6 +89,7 @@
 #include <myst/time.h>
 #include <myst/times.h>
 #include <myst/trace.h>
+#include <myst/ttydev.h>
 
 #define MAX_IPADDR_LEN 64
 
@@ -282,6 +286,73 @@ __attribute__((format(printf, 2, 3))) static void _strace(
     }
 }
 
+/* Trace a syscall from the args format of its syscall table entry. Each
+ * conversion takes the next parameter, cast to the type that the conversion
+ * expects (int for %d, %u, %x and %o; long for the l and z modifiers).
+ */
+static void _strace_params(long n, const char* fmt, const long params[6])
+{
+    const size_t buf_size = 1024;
+    char* buf;
+    size_t len = 0;
+    size_t i = 0;
+
+    if (!_trace_syscall(n))
+        return;
+
+    if (!(buf = malloc(buf_size)))
+        myst_panic("out of memory");
+
+    for (const char* p = fmt; *p && len < buf_size - 1;)
+    {
+        char spec[8];
+        size_t m = 0;
+        bool wide = false;
+        int r;
+
+        if (*p != '%' || p[1] == '%')
+        {
+            buf[len++] = *p;
+            p += (*p == '%') ? 2 : 1;
+            continue;
+        }
+
+        spec[m++] = *p++;
+
+        while ((*p == 'l' || *p == 'z') && m < sizeof(spec) - 2)
+        {
+            spec[m++] = *p++;
+            wide = true;
+        }
+
+        if (!*p || i == 6)
+            break;
+
+        spec[m++] = *p;
+        spec[m] = '\0';
+
+        if (wide)
+            r = snprintf(buf + len, buf_size - len, spec, params[i]);
+        else if (*p == 's')
+            r = snprintf(buf + len, buf_size - len, spec, (char*)params[i]);
+        else if (*p == 'p')
+            r = snprintf(buf + len, buf_size - len, spec, (void*)params[i]);
+        else
+            r = snprintf(buf + len, buf_size - len, spec, (int)params[i]);
+
+        /* on truncation, snprintf() returns the length it would have had */
+        if (r > 0)
+            len = ((size_t)r < buf_size - len) ? len + (size_t)r : buf_size - 1;
+
+        p++;
+        i++;
+    }
+
+    buf[len] = '\0';
+    _strace(n, "%s", buf);
+    free(buf);
+}
+
 long myst_syscall_unmap_on_exit(myst_thread_t* thread, void* ptr, size_t size)
 {
     long ret = 0;
@@ -426,6 +497,7 @@ done:
 long myst_syscall_creat(const char* pathname, mode_t mode)
 {
     long ret = 0;
+    uint64_t span = myst_span_begin();
     int fd;
     myst_fs_t *fs, *fs_out;
     myst_file_t* file;
@@ -464,12 +536,15 @@ done:
     if (locals)
         free(locals);
 
+    myst_span_end("fs", "creat", ret, span);
+
     return ret;
 }
 
 long myst_syscall_open(const char* pathname, int flags, mode_t mode)
 {
     long ret = 0;
+    uint64_t span = myst_span_begin();
     myst_fs_t *fs, *fs_out;
     myst_file_t* file;
     myst_fdtable_t* fdtable = myst_fdtable_current();
@@ -511,6 +586,8 @@ done:
     if (locals)
         free(locals);
 
+    myst_span_end("fs", "open", ret, span);
+
     return ret;
 }
 
@@ -957,6 +1034,34 @@ done:
     return ret;
 }
 
+/* get the file system and file of fd if it is a file that may be accessed at
+ * the given offset; otherwise myst_syscall_pread() or myst_syscall_pwrite()
+ * reports the error */
+static bool _get_vectored_file(
+    int fd,
+    off_t offset,
+    myst_fs_t** fs,
+    myst_file_t** file)
+{
+    myst_fdtable_type_t type;
+    void* device = NULL;
+    void* object = NULL;
+
+    if (offset < 0)
+        return false;
+
+    if (myst_fdtable_get_any(
+            myst_fdtable_current(), fd, &type, &device, &object) != 0)
+        return false;
+
+    if (type != MYST_FDTABLE_TYPE_FILE)
+        return false;
+
+    *fs = device;
+    *file = object;
+    return true;
+}
+
 ssize_t myst_syscall_pwritev2(
     int fd,
     const struct iovec* iov,
@@ -968,11 +1073,20 @@ ssize_t myst_syscall_pwritev2(
     void* buf = NULL;
     ssize_t len;
     ssize_t nwritten;
+    myst_fs_t* fs;
+    myst_file_t* file;
 
     // ATTN: all flags are ignored since they are hints and have no
     // definitively perceptible effect.
     (void)flags;
 
+    /* let file systems that support it write the IO vector as is */
+    if (_get_vectored_file(fd, offset, &fs, &file) && fs->fs_pwritev)
+    {
+        ECHECK(ret = (*fs->fs_pwritev)(fs, file, iov, iovcnt, offset));
+        goto done;
+    }
+
     ECHECK(len = myst_iov_gather(iov, iovcnt, &buf));
     ECHECK(nwritten = myst_syscall_pwrite(fd, buf, len, offset));
     ret = nwritten;
@@ -997,11 +1111,20 @@ ssize_t myst_syscall_preadv2(
     char buf[256];
     void* ptr = NULL;
     ssize_t nread;
+    myst_fs_t* fs;
+    myst_file_t* file;
 
     // ATTN: all flags are ignored since they are hints and have no
     // definitively perceptible effect.
     (void)flags;
 
+    /* let file systems that support it read into the IO vector as is */
+    if (_get_vectored_file(fd, offset, &fs, &file) && fs->fs_preadv)
+    {
+        ECHECK(ret = (*fs->fs_preadv)(fs, file, iov, iovcnt, offset));
+        goto done;
+    }
+
     ECHECK(len = myst_iov_len(iov, iovcnt));
 
     if (len == 0)
@@ -1067,6 +1190,7 @@ done:
 long myst_syscall_stat(const char* pathname, struct stat* statbuf)
 {
     long ret = 0;
+    uint64_t span = myst_span_begin();
     myst_fs_t* fs;
     struct locals
     {
@@ -1085,12 +1209,15 @@ done:
     if (locals)
         free(locals);
 
+    myst_span_end("fs", "stat", ret, span);
+
     return ret;
 }
 
 long myst_syscall_lstat(const char* pathname, struct stat* statbuf)
 {
     long ret = 0;
+    uint64_t span = myst_span_begin();
     myst_fs_t* fs;
     struct locals
     {
@@ -1109,6 +1236,8 @@ done:
     if (locals)
         free(locals);
 
+    myst_span_end("fs", "lstat", ret, span);
+
     return ret;
 }
 
@@ -1264,6 +1393,7 @@ static const char* _trim_trailing_slashes(
 long myst_syscall_mkdir(const char* pathname, mode_t mode)
 {
     long ret = 0;
+    uint64_t span = myst_span_begin();
     myst_fs_t* fs;
     struct locals
     {
@@ -1292,6 +1422,8 @@ done:
     if (locals)
         free(locals);
 
+    myst_span_end("fs", "mkdir", ret, span);
+
     return ret;
 }
 
@@ -1315,6 +1447,7 @@ done:
 long myst_syscall_rmdir(const char* pathname)
 {
     long ret = 0;
+    uint64_t span = myst_span_begin();
     myst_fs_t* fs;
     struct locals
     {
@@ -1333,12 +1466,15 @@ done:
     if (locals)
         free(locals);
 
+    myst_span_end("fs", "rmdir", ret, span);
+
     return ret;
 }
 
 long myst_syscall_getdents64(int fd, struct dirent* dirp, size_t count)
 {
     long ret = 0;
+    uint64_t span = myst_span_begin();
     myst_fs_t* fs;
     myst_file_t* file;
     const myst_fdtable_type_t type = MYST_FDTABLE_TYPE_FILE;
@@ -1349,6 +1485,8 @@ long myst_syscall_getdents64(int fd, struct dirent* dirp, size_t count)
     ret = (*fs->fs_getdents64)(fs, file, dirp, count);
 
 done:
+    myst_span_end("fs", "getdents64", ret, span);
+
     return ret;
 }
 
@@ -1432,6 +1570,7 @@ done:
 long myst_syscall_unlink(const char* pathname)
 {
     long ret = 0;
+    uint64_t span = myst_span_begin();
     myst_fs_t* fs;
     struct locals
     {
@@ -1450,6 +1589,8 @@ done:
     if (locals)
         free(locals);
 
+    myst_span_end("fs", "unlink", ret, span);
+
     return ret;
 }
 
@@ -1486,6 +1627,7 @@ done:
 long myst_syscall_access(const char* pathname, int mode)
 {
     long ret = 0;
+    uint64_t span = myst_span_begin();
     myst_fs_t* fs;
     struct locals
     {
@@ -1504,6 +1646,8 @@ done:
     if (locals)
         free(locals);
 
+    myst_span_end("fs", "access", ret, span);
+
     return ret;
 }
 
@@ -1534,6 +1678,7 @@ done:
 long myst_syscall_rename(const char* oldpath, const char* newpath)
 {
     long ret = 0;
+    uint64_t span = myst_span_begin();
     myst_fs_t* old_fs;
     myst_fs_t* new_fs;
     struct locals
@@ -1563,6 +1708,8 @@ done:
     if (locals)
         free(locals);
 
+    myst_span_end("fs", "rename", ret, span);
+
     return ret;
 }
 
@@ -1596,6 +1743,7 @@ done:
 long myst_syscall_truncate(const char* path, off_t length)
 {
     long ret = 0;
+    uint64_t span = myst_span_begin();
     myst_fs_t* fs;
     struct locals
     {
@@ -1614,6 +1762,8 @@ done:
     if (locals)
         free(locals);
 
+    myst_span_end("fs", "truncate", ret, span);
+
     return ret;
 }
 
@@ -1635,6 +1785,7 @@ done:
 long myst_syscall_readlink(const char* pathname, char* buf, size_t bufsiz)
 {
     long ret = 0;
+    uint64_t span = myst_span_begin();
     myst_fs_t* fs;
     struct locals
     {
@@ -1653,6 +1804,8 @@ done:
     if (locals)
         free(locals);
 
+    myst_span_end("fs", "readlink", ret, span);
+
     return ret;
 }
 
@@ -1693,6 +1846,7 @@ done:
 long myst_syscall_symlink(const char* target, const char* linkpath)
 {
     long ret = 0;
+    uint64_t span = myst_span_begin();
     myst_fs_t* fs;
     struct locals
     {
@@ -1711,6 +1865,8 @@ done:
     if (locals)
         free(locals);
 
+    myst_span_end("fs", "symlink", ret, span);
+
     return ret;
 }
 
@@ -1869,6 +2025,7 @@ done:
 long myst_syscall_statfs(const char* path, struct statfs* buf)
 {
     long ret = 0;
+    uint64_t span = myst_span_begin();
     myst_fs_t* fs;
     struct locals
     {
@@ -1896,6 +2053,8 @@ done:
     if (locals)
         free(locals);
 
+    myst_span_end("fs", "statfs", ret, span);
+
     return ret;
 }
 
@@ -1997,6 +2156,7 @@ done:
 long myst_syscall_chmod(const char* pathname, mode_t mode)
 {
     long ret = 0;
+    uint64_t span = myst_span_begin();
     myst_fs_t* fs;
     struct locals
     {
@@ -2027,6 +2187,8 @@ done:
     if (locals)
         free(locals);
 
+    myst_span_end("fs", "chmod", ret, span);
+
     return ret;
 }
 
@@ -2765,11 +2927,20 @@ done:
 long myst_syscall_sched_yield(void)
 {
     long params[6] = {0};
+
+    /* let other multiplexed threads run on this carrier */
+    if (myst_mn_enabled() && myst_thread_self()->mn.enabled)
+        return myst_mn_yield(myst_thread_self());
+
     return myst_tcall(SYS_sched_yield, params);
 }
 
 long myst_syscall_nanosleep(const struct timespec* req, struct timespec* rem)
 {
+    /* release the carrier rather than blocking the host thread */
+    if (myst_mn_enabled() && myst_thread_self()->mn.enabled)
+        return myst_mn_sleep(req, rem);
+
     long params[6] = {(long)req, (long)rem};
     return _forward_syscall(SYS_nanosleep, params);
 }
@@ -2895,6 +3066,10 @@ long myst_syscall_fsync(int fd)
 
     ECHECK(myst_fdtable_get_any(fdtable, fd, &type, &device, &object));
 
+    /* flush the buffered console output (the error stays as before) */
+    if (type == MYST_FDTABLE_TYPE_TTY)
+        myst_ttydev_flush();
+
     if (type != MYST_FDTABLE_TYPE_FILE)
         ERAISE(-EROFS);
 
@@ -2917,6 +3092,10 @@ long myst_syscall_fdatasync(int fd)
 
     ECHECK(myst_fdtable_get_any(fdtable, fd, &type, &device, &object));
 
+    /* flush the buffered console output (the error stays as before) */
+    if (type == MYST_FDTABLE_TYPE_TTY)
+        myst_ttydev_flush();
+
     if (type != MYST_FDTABLE_TYPE_FILE)
         ERAISE(-EROFS);
 
@@ -2929,6 +3108,7 @@ done:
 long myst_syscall_sync(void)
 {
     myst_fdtable_t* fdtable = myst_fdtable_current();
+    myst_ttydev_flush();
     return myst_fdtable_sync(fdtable);
 }
 
@@ -3009,14 +3189,21 @@ long myst_syscall_get_robust_list(
 {
     long ret = 0;
     myst_thread_t* thread;
+    bool locked = false;
 
     if (pid < 0)
         ERAISE(-EINVAL);
 
     if (pid == 0)
         thread = myst_thread_self();
-    else if (!(thread = myst_find_thread(pid)))
-        ERAISE(-ESRCH);
+    else
+    {
+        myst_rw_read_lock(&myst_tid_hash_lock);
+        locked = true;
+
+        if (!(thread = myst_find_thread(pid)))
+            ERAISE(-ESRCH);
+    }
 
     myst_spin_lock(&thread->robust_list_head_lock);
     {
@@ -3029,6 +3216,10 @@ long myst_syscall_get_robust_list(
     myst_spin_unlock(&thread->robust_list_head_lock);
 
 done:
+
+    if (locked)
+        myst_rw_read_unlock(&myst_tid_hash_lock);
+
     return ret;
 }
 
@@ -3130,10 +3321,13 @@ long myst_syscall_interrupt_thread(int tid)
     long ret = 0;
     myst_thread_t* thread;
 
-    if (!(thread = myst_find_thread(tid)))
+    if (!(thread = myst_get_thread(tid)))
         ERAISE(-ESRCH);
 
-    ECHECK(myst_interrupt_thread(thread));
+    ret = myst_interrupt_thread(thread);
+    myst_put_thread(thread);
+
+    ECHECK(ret);
 
 done:
     return ret;
@@ -3226,6 +3420,8 @@ static const char* _futex_op_str(int op)
             return "FUTEX_TRYLOCK_PI";
         case FUTEX_WAIT_BITSET:
             return "FUTEX_WAIT_BITSET";
+        case FUTEX_WAIT_MULTIPLE:
+            return "FUTEX_WAIT_MULTIPLE";
         default:
             return "UNKNOWN";
     }
@@ -3271,9 +3467,7 @@ void myst_dump_ramfs(void)
 
 static long _SYS_myst_trace(long n, long params[6])
 {
-    const char* msg = (const char*)params[0];
-
-    _strace(n, "msg=%s", msg);
+    (void)params;
 
     return (_return(n, 0));
 }
@@ -3289,8 +3483,6 @@ static long _SYS_myst_dump_stack(long n, long params[6])
 {
     const void* stack = (void*)params[0];
 
-    _strace(n, NULL);
-
     myst_dump_stack((void*)stack);
     return (_return(n, 0));
 }
@@ -3330,7 +3522,7 @@ static long _SYS_myst_add_symbol_file(long n, long params[6])
 
     _strace(n, "path=\"%s\" text=%p text_size=%zu", path, text, text_size);
 
-    if (__myst_kernel_args.debug_symbols)
+    if (__myst_kernel_args.debug_symbols || __myst_kernel_args.profile)
         ret = myst_syscall_add_symbol_file(path, text, text_size);
 
     return (_return(n, ret));
@@ -3366,25 +3558,29 @@ static long _SYS_myst_unload_symbols(long n, long params[6])
 
 static long _SYS_myst_gen_creds(long n, long params[6])
 {
-    _strace(n, NULL);
+    (void)n;
+
     return (_forward_syscall(MYST_TCALL_GEN_CREDS, params));
 }
 
 static long _SYS_myst_free_creds(long n, long params[6])
 {
-    _strace(n, NULL);
+    (void)n;
+
     return (_forward_syscall(MYST_TCALL_FREE_CREDS, params));
 }
 
 static long _SYS_myst_gen_creds_ex(long n, long params[6])
 {
-    _strace(n, NULL);
+    (void)n;
+
     return (_forward_syscall(MYST_TCALL_GEN_CREDS_EX, params));
 }
 
 static long _SYS_myst_verify_cert(long n, long params[6])
 {
-    _strace(n, NULL);
+    (void)n;
+
     return (_forward_syscall(MYST_TCALL_VERIFY_CERT, params));
 }
 
@@ -3411,8 +3607,6 @@ static long _SYS_myst_gcov(long n, long params[6])
     const char* func = (const char*)params[0];
     long* gcov_params = (long*)params[1];
 
-    _strace(n, "func=%s gcov_params=%p", func, gcov_params);
-
     long ret = myst_gcov(func, gcov_params);
     return (_return(n, ret));
 }
@@ -3457,8 +3651,6 @@ static long _SYS_read(long n, long params[6])
     void* buf = (void*)params[1];
     size_t count = (size_t)params[2];
 
-    _strace(n, "fd=%d buf=%p count=%zu", fd, buf, count);
-
     return (_return(n, myst_syscall_read(fd, buf, count)));
 }
 
@@ -3469,8 +3661,6 @@ static long _SYS_write(long n, long params[6])
     size_t count = (size_t)params[2];
     long ret;
 
-    _strace(n, "fd=%d buf=%p count=%zu", fd, buf, count);
-
     if (!buf && count)
         ret = -EINVAL;
     else if (buf && myst_is_bad_addr_read(buf, count))
@@ -3487,8 +3677,6 @@ static long _SYS_pread64(long n, long params[6])
     size_t count = (size_t)params[2];
     off_t offset = (off_t)params[3];
 
-    _strace(n, "fd=%d buf=%p count=%zu offset=%ld", fd, buf, count, offset);
-
     return (_return(n, myst_syscall_pread(fd, buf, count, offset)));
 }
 
@@ -3499,8 +3687,6 @@ static long _SYS_pwrite64(long n, long params[6])
     size_t count = (size_t)params[2];
     off_t offset = (off_t)params[3];
 
-    _strace(n, "fd=%d buf=%p count=%zu offset=%ld", fd, buf, count, offset);
-
     return (_return(n, myst_syscall_pwrite(fd, buf, count, offset)));
 }
 
@@ -3534,8 +3720,6 @@ static long _SYS_close(long n, long params[6])
 {
     int fd = (int)params[0];
 
-    _strace(n, "fd=%d", fd);
-
     return (_return(n, myst_syscall_close(fd)));
 }
 
@@ -3544,8 +3728,6 @@ static long _SYS_stat(long n, long params[6])
     const char* pathname = (const char*)params[0];
     struct stat* statbuf = (struct stat*)params[1];
 
-    _strace(n, "pathname=\"%s\" statbuf=%p", pathname, statbuf);
-
     return (_return(n, myst_syscall_stat(pathname, statbuf)));
 }
 
@@ -3554,8 +3736,6 @@ static long _SYS_fstat(long n, long params[6])
     int fd = (int)params[0];
     void* statbuf = (void*)params[1];
 
-    _strace(n, "fd=%d statbuf=%p", fd, statbuf);
-
     return (_return(n, myst_syscall_fstat(fd, statbuf)));
 }
 
@@ -3565,8 +3745,6 @@ static long _SYS_lstat(long n, long params[6])
     const char* pathname = (const char*)params[0];
     struct stat* statbuf = (struct stat*)params[1];
 
-    _strace(n, "pathname=\"%s\" statbuf=%p", pathname, statbuf);
-
     return (_return(n, myst_syscall_lstat(pathname, statbuf)));
 }
 
@@ -3577,8 +3755,6 @@ static long _SYS_poll(long n, long params[6])
     int timeout = (int)params[2];
     long ret;
 
-    _strace(n, "fds=%p nfds=%ld timeout=%d", fds, nfds, timeout);
-
     if (_trace_syscall(SYS_poll))
     {
         for (nfds_t i = 0; i < nfds; i++)
@@ -3595,8 +3771,6 @@ static long _SYS_lseek(long n, long params[6])
     off_t offset = (off_t)params[1];
     int whence = (int)params[2];
 
-    _strace(n, "fd=%d offset=%ld whence=%d", fd, offset, whence);
-
     return (_return(n, myst_syscall_lseek(fd, offset, whence)));
 }
 
@@ -3774,8 +3948,6 @@ static long _SYS_rt_sigprocmask(long n, long params[6])
     const sigset_t* set = (sigset_t*)params[1];
     sigset_t* oldset = (sigset_t*)params[2];
 
-    _strace(n, "how=%d set=%p oldset=%p", how, set, oldset);
-
     long ret = myst_signal_sigprocmask(how, set, oldset);
     return (_return(n, ret));
 }
@@ -3801,8 +3973,6 @@ static long _SYS_readv(long n, long params[6])
     const struct iovec* iov = (const struct iovec*)params[1];
     int iovcnt = (int)params[2];
 
-    _strace(n, "fd=%d iov=%p iovcnt=%d", fd, iov, iovcnt);
-
     return (_return(n, myst_syscall_readv(fd, iov, iovcnt)));
 }
 
@@ -3812,8 +3982,6 @@ static long _SYS_writev(long n, long params[6])
     const struct iovec* iov = (const struct iovec*)params[1];
     int iovcnt = (int)params[2];
 
-    _strace(n, "fd=%d iov=%p iovcnt=%d", fd, iov, iovcnt);
-
     return (_return(n, myst_syscall_writev(fd, iov, iovcnt)));
 }
 
@@ -3822,8 +3990,6 @@ static long _SYS_access(long n, long params[6])
     const char* pathname = (const char*)params[0];
     int mode = (int)params[1];
 
-    _strace(n, "pathname=\"%s\" mode=%d", pathname, mode);
-
     return (_return(n, myst_syscall_access(pathname, mode)));
 }
 
@@ -3937,18 +4103,12 @@ static long _SYS_msync(long n, long params[6])
     size_t length = (size_t)params[1];
     int flags = (int)params[2];
 
-    _strace(n, "addr=%p length=%zu flags=%d ", addr, length, flags);
-
     return (_return(n, myst_msync(addr, length, flags)));
 }
 
 static long _SYS_madvise(long n, long params[6])
 {
-    void* addr = (void*)params[0];
-    size_t length = (size_t)params[1];
-    int advice = (int)params[2];
-
-    _strace(n, "addr=%p length=%zu advice=%d", addr, length, advice);
+    (void)params;
 
     return (_return(n, 0));
 }
@@ -3958,8 +4118,6 @@ static long _SYS_dup(long n, long params[6])
     int oldfd = (int)params[0];
     long ret;
 
-    _strace(n, "oldfd=%d", oldfd);
-
     ret = myst_syscall_dup(oldfd);
     return (_return(n, ret));
 }
@@ -3970,8 +4128,6 @@ static long _SYS_dup2(long n, long params[6])
     int newfd = (int)params[1];
     long ret;
 
-    _strace(n, "oldfd=%d newfd=%d", oldfd, newfd);
-
     ret = myst_syscall_dup2(oldfd, newfd);
     return (_return(n, ret));
 }
@@ -3983,8 +4139,6 @@ static long _SYS_dup3(long n, long params[6])
     int flags = (int)params[2];
     long ret;
 
-    _strace(n, "oldfd=%d newfd=%d flags=%o", oldfd, newfd, flags);
-
     ret = myst_syscall_dup3(oldfd, newfd, flags);
     return (_return(n, ret));
 }
@@ -4114,8 +4268,6 @@ static long _SYS_myst_interrupt_thread(long n, long params[6])
 {
     int tid = (int)params[0];
 
-    _strace(n, "tid=%d\n", tid);
-
     long ret = myst_syscall_interrupt_thread(tid);
     return (_return(n, ret));
 }
@@ -4238,13 +4390,6 @@ static long _SYS_wait4(long n, long params[6])
     struct rusage* rusage = (struct rusage*)params[3];
     long ret;
 
-    _strace(
-        n,
-        "pid=%d wstatus=%p options=%d rusage=%p",
-        pid,
-        wstatus,
-        options,
-        rusage);
     ret = myst_syscall_wait4(pid, wstatus, options, rusage);
     return (_return(n, ret));
 }
@@ -4283,10 +4428,7 @@ static long _SYS_fcntl(long n, long params[6])
 
 static long _SYS_flock(long n, long params[6])
 {
-    int fd = (int)params[0];
-    int cmd = (int)params[1];
-
-    _strace(n, "fd=%d cmd=%d", fd, cmd);
+    (void)params;
 
     return (_return(n, 0));
 }
@@ -4295,8 +4437,6 @@ static long _SYS_fsync(long n, long params[6])
 {
     int fd = (int)params[0];
 
-    _strace(n, "fd=%d", fd);
-
     return (_return(n, myst_syscall_fsync(fd)));
 }
 
@@ -4304,8 +4444,6 @@ static long _SYS_fdatasync(long n, long params[6])
 {
     int fd = (int)params[0];
 
-    _strace(n, "fd=%d", fd);
-
     return (_return(n, myst_syscall_fdatasync(fd)));
 }
 
@@ -4314,8 +4452,6 @@ static long _SYS_truncate(long n, long params[6])
     const char* path = (const char*)params[0];
     off_t length = (off_t)params[1];
 
-    _strace(n, "path=\"%s\" length=%ld", path, length);
-
     return (_return(n, myst_syscall_truncate(path, length)));
 }
 
@@ -4324,8 +4460,6 @@ static long _SYS_ftruncate(long n, long params[6])
     int fd = (int)params[0];
     off_t length = (off_t)params[1];
 
-    _strace(n, "fd=%d length=%ld", fd, length);
-
     return (_return(n, myst_syscall_ftruncate(fd, length)));
 }
 
@@ -4334,8 +4468,6 @@ static long _SYS_getcwd(long n, long params[6])
     char* buf = (char*)params[0];
     size_t size = (size_t)params[1];
 
-    _strace(n, "buf=%p size=%zu", buf, size);
-
     return (_return(n, myst_syscall_getcwd(buf, size)));
 }
 
@@ -4355,8 +4487,6 @@ static long _SYS_fchdir(long n, long params[6])
 {
     int fd = (int)params[0];
 
-    _strace(n, "fd=%d", fd);
-
     return (_return(n, myst_syscall_fchdir(fd)));
 }
 
@@ -4365,8 +4495,6 @@ static long _SYS_rename(long n, long params[6])
     const char* oldpath = (const char*)params[0];
     const char* newpath = (const char*)params[1];
 
-    _strace(n, "oldpath=\"%s\" newpath=\"%s\"", oldpath, newpath);
-
     return (_return(n, myst_syscall_rename(oldpath, newpath)));
 }
 
@@ -4395,8 +4523,6 @@ static long _SYS_rmdir(long n, long params[6])
 {
     const char* pathname = (const char*)params[0];
 
-    _strace(n, "pathname=\"%s\"", pathname);
-
     return (_return(n, myst_syscall_rmdir(pathname)));
 }
 
@@ -4426,8 +4552,6 @@ static long _SYS_link(long n, long params[6])
     const char* oldpath = (const char*)params[0];
     const char* newpath = (const char*)params[1];
 
-    _strace(n, "oldpath=\"%s\" newpath=\"%s\"", oldpath, newpath);
-
     return (_return(n, myst_syscall_link(oldpath, newpath)));
 }
 
@@ -4435,8 +4559,6 @@ static long _SYS_unlink(long n, long params[6])
 {
     const char* pathname = (const char*)params[0];
 
-    _strace(n, "pathname=\"%s\"", pathname);
-
     return (_return(n, myst_syscall_unlink(pathname)));
 }
 
@@ -4445,8 +4567,6 @@ static long _SYS_symlink(long n, long params[6])
     const char* target = (const char*)params[0];
     const char* linkpath = (const char*)params[1];
 
-    _strace(n, "target=\"%s\" linkpath=\"%s\"", target, linkpath);
-
     return (_return(n, myst_syscall_symlink(target, linkpath)));
 }
 
@@ -4456,8 +4576,6 @@ static long _SYS_readlink(long n, long params[6])
     char* buf = (char*)params[1];
     size_t bufsiz = (size_t)params[2];
 
-    _strace(n, "pathname=\"%s\" buf=%p bufsiz=%zu", pathname, buf, bufsiz);
-
     return (_return(n, myst_syscall_readlink(pathname, buf, bufsiz)));
 }
 
@@ -4466,8 +4584,6 @@ static long _SYS_chmod(long n, long params[6])
     const char* pathname = (const char*)params[0];
     mode_t mode = (mode_t)params[1];
 
-    _strace(n, "pathname=\"%s\" mode=%o", pathname, mode);
-
     return (_return(n, myst_syscall_chmod(pathname, mode)));
 }
 
@@ -4476,8 +4592,6 @@ static long _SYS_fchmod(long n, long params[6])
     int fd = (int)params[0];
     mode_t mode = (mode_t)params[1];
 
-    _strace(n, "fd=%d mode=%o", fd, mode);
-
     return (_return(n, myst_syscall_fchmod(fd, mode)));
 }
 
@@ -4487,8 +4601,6 @@ static long _SYS_chown(long n, long params[6])
     uid_t owner = (uid_t)params[1];
     gid_t group = (gid_t)params[2];
 
-    _strace(n, "pathname=%s owner=%u group=%u", pathname, owner, group);
-
     return (_return(n, myst_syscall_chown(pathname, owner, group)));
 }
 
@@ -4498,8 +4610,6 @@ static long _SYS_fchown(long n, long params[6])
     uid_t owner = (uid_t)params[1];
     gid_t group = (gid_t)params[2];
 
-    _strace(n, "fd=%d owner=%u group=%u", fd, owner, group);
-
     return (_return(n, myst_syscall_fchown(fd, owner, group)));
 }
 
@@ -4511,15 +4621,6 @@ static long _SYS_fchownat(long n, long params[6])
     gid_t group = (gid_t)params[3];
     int flags = (int)params[4];
 
-    _strace(
-        n,
-        "dirfd=%d pathname=%s owner=%u group=%u flags=%d",
-        dirfd,
-        pathname,
-        owner,
-        group,
-        flags);
-
     return (_return(
         n, myst_syscall_fchownat(dirfd, pathname, owner, group, flags)));
 }
@@ -4542,8 +4643,6 @@ static long _SYS_umask(long n, long params[6])
 {
     mode_t mask = (mode_t)params[0];
 
-    _strace(n, "mask=%o", mask);
-
     return (_return(n, myst_syscall_umask(mask)));
 }
 
@@ -4552,8 +4651,6 @@ static long _SYS_gettimeofday(long n, long params[6])
     struct timeval* tv = (struct timeval*)params[0];
     struct timezone* tz = (void*)params[1];
 
-    _strace(n, "tv=%p tz=%p", tv, tz);
-
     long ret = myst_syscall_gettimeofday(tv, tz);
     return (_return(n, ret));
 }
@@ -4564,8 +4661,6 @@ static long _SYS_getrusage(long n, long params[6])
     struct rusage* usage = (struct rusage*)params[1];
     long ret;
 
-    _strace(n, "who=%d usage=%p", who, usage);
-
     if (!usage || myst_is_bad_addr_write(usage, sizeof(*usage)))
         ret = -EFAULT;
     else if (
@@ -4582,7 +4677,6 @@ static long _SYS_getrusage(long n, long params[6])
 static long _SYS_sysinfo(long n, long params[6])
 {
     struct sysinfo* info = (struct sysinfo*)params[0];
-    _strace(n, "info=%p", info);
     long ret = myst_syscall_sysinfo(info);
     return (_return(n, ret));
 }
@@ -4672,7 +4766,6 @@ static long _SYS_getgroups(long n, long params[6])
     size_t size = (size_t)params[0];
     gid_t* list = (gid_t*)params[1];
     /* return the extra groups on the thread */
-    _strace(n, NULL);
     return (_return(n, myst_syscall_getgroups(size, list)));
 }
 
@@ -4746,7 +4839,6 @@ static long _SYS_setreuid(long n, long params[6])
     /* set the real and effective uid of the thread */
     uid_t ruid = (uid_t)params[0];
     uid_t euid = (uid_t)params[1];
-    _strace(n, "Changing IDs to ruid=%u, euid=%u", ruid, euid);
     return (_return(n, myst_syscall_setreuid(ruid, euid)));
 }
 
@@ -4755,7 +4847,6 @@ static long _SYS_setregid(long n, long params[6])
     /* set the real and effective uid of the thread */
     gid_t rgid = (gid_t)params[0];
     gid_t egid = (gid_t)params[1];
-    _strace(n, "Changing setting to rgid=%u, egid=%u", rgid, egid);
     return (_return(n, myst_syscall_setregid(rgid, egid)));
 }
 
@@ -4765,12 +4856,6 @@ static long _SYS_setresuid(long n, long params[6])
     uid_t ruid = (uid_t)params[0];
     uid_t euid = (uid_t)params[1];
     uid_t savuid = (uid_t)params[2];
-    _strace(
-        n,
-        "Changing setting to ruid=%u, euid=%u, savuid=%u",
-        ruid,
-        euid,
-        savuid);
     return (_return(n, myst_syscall_setresuid(ruid, euid, savuid)));
 }
 
@@ -4779,7 +4864,6 @@ static long _SYS_getresuid(long n, long params[6])
     uid_t* ruid = (uid_t*)params[0];
     uid_t* euid = (uid_t*)params[1];
     uid_t* savuid = (uid_t*)params[2];
-    _strace(n, NULL);
     return (_return(n, myst_syscall_getresuid(ruid, euid, savuid)));
 }
 
@@ -4789,12 +4873,6 @@ static long _SYS_setresgid(long n, long params[6])
     gid_t rgid = (gid_t)params[0];
     gid_t egid = (gid_t)params[1];
     gid_t savgid = (gid_t)params[2];
-    _strace(
-        n,
-        "Changing setting to rgid=%u, egid=%u, savgid=%u",
-        rgid,
-        egid,
-        savgid);
     return (_return(n, myst_syscall_setresgid(rgid, egid, savgid)));
 }
 
@@ -4803,21 +4881,18 @@ static long _SYS_getresgid(long n, long params[6])
     gid_t* rgid = (gid_t*)params[0];
     gid_t* egid = (gid_t*)params[1];
     gid_t* savgid = (gid_t*)params[2];
-    _strace(n, NULL);
     return (_return(n, myst_syscall_getresgid(rgid, egid, savgid)));
 }
 
 static long _SYS_setfsuid(long n, long params[6])
 {
     uid_t fsuid = (uid_t)params[0];
-    _strace(n, "fsuid=%u", fsuid);
     return (_return(n, myst_syscall_setfsuid(fsuid)));
 }
 
 static long _SYS_setfsgid(long n, long params[6])
 {
     gid_t fsgid = (gid_t)params[0];
-    _strace(n, "fsgid=%u", fsgid);
     return (_return(n, myst_syscall_setfsgid(fsgid)));
 }
 
@@ -4825,7 +4900,6 @@ static long _SYS_rt_sigpending(long n, long params[6])
 {
     sigset_t* set = (sigset_t*)params[0];
     unsigned size = (unsigned)params[1];
-    _strace(n, "set=%p size=%d", set, size);
     return (_return(n, myst_signal_sigpending(set, size)));
 }
 
@@ -4833,7 +4907,6 @@ static long _SYS_sigaltstack(long n, long params[6])
 {
     const stack_t* ss = (stack_t*)params[0];
     stack_t* ss_old = (stack_t*)params[1];
-    _strace(n, "altstack=%p altstack_old=%p", ss, ss_old);
     return (_return(n, myst_signal_altstack(ss, ss_old)));
 }
 
@@ -4863,8 +4936,6 @@ static long _SYS_statfs(long n, long params[6])
     const char* path = (const char*)params[0];
     struct statfs* buf = (struct statfs*)params[1];
 
-    _strace(n, "path=\"%s\" buf=%p", path, buf);
-
     long ret = myst_syscall_statfs(path, buf);
 
     return (_return(n, ret));
@@ -4875,8 +4946,6 @@ static long _SYS_fstatfs(long n, long params[6])
     int fd = (int)params[0];
     struct statfs* buf = (struct statfs*)params[1];
 
-    _strace(n, "fd=%d buf=%p", fd, buf);
-
     long ret = myst_syscall_fstatfs(fd, buf);
 
     return (_return(n, ret));
@@ -4895,8 +4964,6 @@ static long _SYS_sched_getparam(long n, long params[6])
     pid_t pid = (pid_t)params[0];
     struct sched_param* param = (struct sched_param*)params[1];
 
-    _strace(n, "pid=%d param=%p", pid, param);
-
     return (_return(n, myst_syscall_sched_getparam(pid, param)));
 }
 
@@ -5001,15 +5068,6 @@ static long _SYS_mount(long n, long params[6])
     void* data = (void*)params[4];
     long ret;
 
-    _strace(
-        n,
-        "source=%s target=%s filesystemtype=%s mountflags=%lu data=%p",
-        source,
-        target,
-        filesystemtype,
-        mountflags,
-        data);
-
     ret = myst_syscall_mount(
         source, target, filesystemtype, mountflags, data, false);
 
@@ -5022,8 +5080,6 @@ static long _SYS_umount2(long n, long params[6])
     int flags = (int)params[1];
     long ret;
 
-    _strace(n, "target=%p flags=%d", target, flags);
-
     ret = myst_syscall_umount2(target, flags);
 
     return (_return(n, ret));
@@ -5034,8 +5090,6 @@ static long _SYS_sethostname(long n, long params[6])
     const char* name = (const char*)params[0];
     size_t len = (size_t)params[1];
 
-    _strace(n, "name=\"%s\" len=%zu", name, len);
-
     return (_return(n, myst_syscall_sethostname(name, len)));
 }
 
@@ -5072,7 +5126,6 @@ static long _SYS_time(long n, long params[6])
 {
     time_t* tloc = (time_t*)params[0];
 
-    _strace(n, "tloc=%p", tloc);
     long ret = myst_syscall_time(tloc);
     return (_return(n, ret));
 }
@@ -5125,6 +5178,30 @@ static long _SYS_futex(long n, long params[6])
         n, myst_syscall_futex(uaddr, futex_op, val, arg, uaddr2, val3)));
 }
 
+static long _SYS_futex_waitv(long n, long params[6])
+{
+    const myst_futex_waitv_t* waiters = (const myst_futex_waitv_t*)params[0];
+    unsigned int nr_futexes = (unsigned int)params[1];
+    unsigned int flags = (unsigned int)params[2];
+    const struct timespec* timeout = (const struct timespec*)params[3];
+    clockid_t clockid = (clockid_t)params[4];
+    struct timespec_buf buf;
+
+    _strace(
+        n,
+        "waiters=%p nr_futexes=%u flags=%u timeout=%s clockid=%d",
+        waiters,
+        nr_futexes,
+        flags,
+        _format_timespec(&buf, timeout),
+        clockid);
+
+    return (_return(
+        n,
+        myst_syscall_futex_waitv(
+            waiters, nr_futexes, flags, timeout, clockid)));
+}
+
 static long _SYS_sched_setaffinity(long n, long params[6])
 {
     pid_t pid = (pid_t)params[0];
@@ -5132,8 +5209,6 @@ static long _SYS_sched_setaffinity(long n, long params[6])
     const cpu_set_t* mask = (const cpu_set_t*)params[2];
     long ret;
 
-    _strace(n, "pid=%d cpusetsize=%zu mask=%p", pid, cpusetsize, mask);
-
     ret = myst_syscall_sched_setaffinity(pid, cpusetsize, mask);
     return (_return(n, ret));
 }
@@ -5145,8 +5220,6 @@ static long _SYS_sched_getaffinity(long n, long params[6])
     cpu_set_t* mask = (cpu_set_t*)params[2];
     long ret;
 
-    _strace(n, "pid=%d cpusetsize=%zu mask=%p", pid, cpusetsize, mask);
-
     /* returns the number of bytes in the kernel affinity mask */
     ret = myst_syscall_sched_getaffinity(pid, cpusetsize, mask);
 
@@ -5191,8 +5264,6 @@ static long _SYS_epoll_create(long n, long params[6])
 {
     int size = (int)params[0];
 
-    _strace(n, "size=%d", size);
-
     if (size <= 0)
         return (_return(n, -EINVAL));
 
@@ -5205,8 +5276,6 @@ static long _SYS_getdents64(long n, long params[6])
     struct dirent* dirp = (struct dirent*)params[1];
     unsigned int count = (unsigned int)params[2];
 
-    _strace(n, "fd=%d dirp=%p count=%u", fd, dirp, count);
-
     return (_return(n, myst_syscall_getdents64((int)fd, dirp, count)));
 }
 
@@ -5223,12 +5292,7 @@ static long _SYS_set_tid_address(long n, long params[6])
 
 static long _SYS_fadvise64(long n, long params[6])
 {
-    int fd = (int)params[0];
-    loff_t offset = (loff_t)params[1];
-    loff_t len = (loff_t)params[2];
-    int advice = (int)params[3];
-
-    _strace(n, "fd=%d offset=%ld len=%ld advice=%d", fd, offset, len, advice);
+    (void)params;
 
     /* ATTN: no-op */
     return (_return(n, 0));
@@ -5250,8 +5314,6 @@ static long _SYS_clock_getres(long n, long params[6])
     clockid_t clk_id = (clockid_t)params[0];
     struct timespec* res = (struct timespec*)params[1];
 
-    _strace(n, "clk_id=%u tp=%p", clk_id, res);
-
     return (_return(n, myst_syscall_clock_getres(clk_id, res)));
 }
 
@@ -5263,14 +5325,6 @@ static long _SYS_epoll_wait(long n, long params[6])
     int timeout = (int)params[3];
     long ret;
 
-    _strace(
-        n,
-        "edpf=%d events=%p maxevents=%d timeout=%d",
-        epfd,
-        events,
-        maxevents,
-        timeout);
-
     ret = myst_syscall_epoll_wait(epfd, events, maxevents, timeout);
     return (_return(n, ret));
 }
@@ -5283,8 +5337,6 @@ static long _SYS_epoll_ctl(long n, long params[6])
     struct epoll_event* event = (struct epoll_event*)params[3];
     long ret;
 
-    _strace(n, "edpf=%d op=%d fd=%d event=%p", epfd, op, fd, event);
-
     ret = myst_syscall_epoll_ctl(epfd, op, fd, event);
     return (_return(n, ret));
 }
@@ -5295,8 +5347,6 @@ static long _SYS_tgkill(long n, long params[6])
     int tid = (int)params[1];
     int sig = (int)params[2];
 
-    _strace(n, "tgid=%d tid=%d sig=%d", tgid, tid, sig);
-
     long ret = myst_syscall_tgkill(tgid, tid, sig);
     return (_return(n, ret));
 }
@@ -5310,16 +5360,6 @@ static long _SYS_mbind(long n, long params[6])
     unsigned long maxnode = (unsigned long)params[4];
     unsigned flags = (unsigned)params[5];
 
-    _strace(
-        n,
-        "addr=%p len=%lu mode=%d nodemask=%p maxnode=%lu flags=%u",
-        addr,
-        len,
-        mode,
-        nodemask,
-        maxnode,
-        flags);
-
     long ret = myst_syscall_mbind(addr, len, mode, nodemask, maxnode, flags);
     return (_return(n, ret));
 }
@@ -5331,9 +5371,6 @@ static long _SYS_waitid(long n, long params[6])
     siginfo_t* infop = (siginfo_t*)params[2];
     int options = (int)params[3];
 
-    _strace(
-        n, "idtype=%i id=%i infop=%p options=%x", idtype, id, infop, options);
-
     long ret = myst_syscall_waitid(idtype, id, infop, options);
     return (_return(n, ret));
 }
@@ -5365,8 +5402,6 @@ static long _SYS_inotify_rm_watch(long n, long params[6])
     int fd = (int)params[0];
     int wd = (int)params[1];
 
-    _strace(n, "fd=%d wd=%d", fd, wd);
-
     long ret = myst_syscall_inotify_rm_watch(fd, wd);
     return (_return(n, ret));
 }
@@ -5459,14 +5494,6 @@ static long _SYS_newfstatat(long n, long params[6])
     int flags = (int)params[3];
     long ret;
 
-    _strace(
-        n,
-        "dirfd=%d pathname=%s statbuf=%p flags=%d",
-        dirfd,
-        pathname,
-        statbuf,
-        flags);
-
     ret = myst_syscall_fstatat(dirfd, pathname, statbuf, flags);
     return (_return(n, ret));
 }
@@ -5477,8 +5504,6 @@ static long _SYS_unlinkat(long n, long params[6])
     const char* pathname = (const char*)params[1];
     int flags = (int)params[2];
 
-    _strace(n, "dirfd=%d pathname=%s flags=%d", dirfd, pathname, flags);
-
     return (_return(n, myst_syscall_unlinkat(dirfd, pathname, flags)));
 }
 
@@ -5489,14 +5514,6 @@ static long _SYS_renameat(long n, long params[6])
     int newdirfd = (int)params[2];
     const char* newpath = (const char*)params[3];
 
-    _strace(
-        n,
-        "olddirfd=%d oldpath=\"%s\" newdirfd=%d newpath=\"%s\"",
-        olddirfd,
-        oldpath,
-        newdirfd,
-        newpath);
-
     return (_return(
         n, myst_syscall_renameat(olddirfd, oldpath, newdirfd, newpath)));
 }
@@ -5509,15 +5526,6 @@ static long _SYS_linkat(long n, long params[6])
     const char* newpath = (const char*)params[3];
     int flags = (int)params[4];
 
-    _strace(
-        n,
-        "olddirfd=%d oldpath=%s newdirfd=%d newpath=%s flags=%d",
-        olddirfd,
-        oldpath,
-        newdirfd,
-        newpath,
-        flags);
-
     return (_return(
         n, myst_syscall_linkat(olddirfd, oldpath, newdirfd, newpath, flags)));
 }
@@ -5528,8 +5536,6 @@ static long _SYS_symlinkat(long n, long params[6])
     int newdirfd = (int)params[1];
     const char* linkpath = (const char*)params[2];
 
-    _strace(n, "target=%s newdirfd=%d linkpath=%s", target, newdirfd, linkpath);
-
     return (_return(n, myst_syscall_symlinkat(target, newdirfd, linkpath)));
 }
 
@@ -5540,14 +5546,6 @@ static long _SYS_readlinkat(long n, long params[6])
     char* buf = (char*)params[2];
     size_t bufsiz = (size_t)params[3];
 
-    _strace(
-        n,
-        "dirfd=%d pathname=%s buf=%p bufsize=%ld",
-        dirfd,
-        pathname,
-        buf,
-        bufsiz);
-
     return (_return(n, myst_syscall_readlinkat(dirfd, pathname, buf, bufsiz)));
 }
 
@@ -5559,14 +5557,6 @@ static long _SYS_fchmodat(long n, long params[6])
     int flags = (int)params[3];
     long ret;
 
-    _strace(
-        n,
-        "dirfd=%d pathname=\"%s\" mode=0%o flags=0%o",
-        dirfd,
-        pathname,
-        mode,
-        flags);
-
     ret = myst_syscall_fchmodat(dirfd, pathname, mode, flags);
 
     return (_return(n, ret));
@@ -5579,14 +5569,6 @@ static long _SYS_faccessat(long n, long params[6])
     int mode = (int)params[2];
     int flags = (int)params[3];
 
-    _strace(
-        n,
-        "dirfd=%d pathname=%s mode=%d flags=%d",
-        dirfd,
-        pathname,
-        mode,
-        flags);
-
     return (_return(n, myst_syscall_faccessat(dirfd, pathname, mode, flags)));
 }
 
@@ -5648,8 +5630,6 @@ static long _SYS_set_robust_list(long n, long params[6])
     size_t len = (size_t)params[1];
     long ret;
 
-    _strace(n, "head=%p len=%zu", head, len);
-
     ret = myst_syscall_set_robust_list(head, len);
     return (_return(n, ret));
 }
@@ -5661,8 +5641,6 @@ static long _SYS_get_robust_list(long n, long params[6])
     size_t* len_ptr = (size_t*)params[2];
     long ret;
 
-    _strace(n, "pid=%d head=%p len=%p", pid, head_ptr, len_ptr);
-
     ret = myst_syscall_get_robust_list(pid, head_ptr, len_ptr);
     return (_return(n, ret));
 }
@@ -5675,14 +5653,6 @@ static long _SYS_utimensat(long n, long params[6])
     int flags = (int)params[3];
     long ret;
 
-    _strace(
-        n,
-        "dirfd=%d pathname=%s times=%p flags=%o",
-        dirfd,
-        pathname,
-        times,
-        flags);
-
     ret = myst_syscall_utimensat(dirfd, pathname, times, flags);
     return (_return(n, ret));
 }
@@ -5696,15 +5666,6 @@ static long _SYS_epoll_pwait(long n, long params[6])
     const sigset_t* sigmask = (const sigset_t*)params[4];
     long ret;
 
-    _strace(
-        n,
-        "edpf=%d events=%p maxevents=%d timeout=%d sigmask=%p",
-        epfd,
-        events,
-        maxevents,
-        timeout,
-        sigmask);
-
     /* ATTN: ignore sigmask */
     ret = myst_syscall_epoll_wait(epfd, events, maxevents, timeout);
     return (_return(n, ret));
@@ -5712,12 +5673,7 @@ static long _SYS_epoll_pwait(long n, long params[6])
 
 static long _SYS_fallocate(long n, long params[6])
 {
-    int fd = (int)params[0];
-    int mode = (int)params[1];
-    off_t offset = (off_t)params[2];
-    off_t len = (off_t)params[3];
-
-    _strace(n, "fd=%d mode=%d offset=%ld len=%ld", fd, mode, offset, len);
+    (void)params;
 
     /* ATTN: treated as advisory only */
     return (_return(n, 0));
@@ -5755,8 +5711,6 @@ static long _SYS_eventfd2(long n, long params[6])
     unsigned int initval = (unsigned int)params[0];
     int flags = (int)params[1];
 
-    _strace(n, "initval=%u flags=%d", initval, flags);
-
     long ret = myst_syscall_eventfd(initval, flags);
     return (_return(n, ret));
 }
@@ -5765,7 +5719,6 @@ static long _SYS_epoll_create1(long n, long params[6])
 {
     int flags = (int)params[0];
 
-    _strace(n, "flags=%d", flags);
     return (_return(n, myst_syscall_epoll_create1(flags)));
 }
 
@@ -5788,8 +5741,6 @@ static long _SYS_inotify_init1(long n, long params[6])
 {
     int flags = (int)params[0];
 
-    _strace(n, "flags=%x", flags);
-
     long ret = myst_syscall_inotify_init1(flags);
     return (_return(n, ret));
 }
@@ -5801,8 +5752,6 @@ static long _SYS_preadv(long n, long params[6])
     int iovcnt = (int)params[2];
     off_t offset = (off_t)params[3];
 
-    _strace(n, "fd=%d iov=%p iovcnt=%d offset=%zu", fd, iov, iovcnt, offset);
-
     long ret = myst_syscall_preadv2(fd, iov, iovcnt, offset, 0);
     return (_return(n, ret));
 }
@@ -5814,8 +5763,6 @@ static long _SYS_pwritev(long n, long params[6])
     int iovcnt = (int)params[2];
     off_t offset = (off_t)params[3];
 
-    _strace(n, "fd=%d iov=%p iovcnt=%d offset=%zu", fd, iov, iovcnt, offset);
-
     long ret = myst_syscall_pwritev2(fd, iov, iovcnt, offset, 0);
     return (_return(n, ret));
 }
@@ -5850,14 +5797,6 @@ static long _SYS_prlimit64(long n, long params[6])
     struct rlimit* new_rlim = (struct rlimit*)params[2];
     struct rlimit* old_rlim = (struct rlimit*)params[3];
 
-    _strace(
-        n,
-        "pid=%d, resource=%d, new_rlim=%p, old_rlim=%p",
-        pid,
-        resource,
-        new_rlim,
-        old_rlim);
-
     int ret = myst_syscall_prlimit64(pid, resource, new_rlim, old_rlim);
     return (_return(n, ret));
 }
@@ -5891,8 +5830,6 @@ static long _SYS_getcpu(long n, long params[6])
     struct getcpu_cache* tcache = (struct getcpu_cache*)params[2];
     long ret;
 
-    _strace(n, "cpu=%p node=%p, tcache=%p", cpu, node, tcache);
-
     /* unused since Linux 2.6.24 */
     (void)tcache;
 
@@ -5906,8 +5843,6 @@ static long _SYS_getrandom(long n, long params[6])
     size_t buflen = (size_t)params[1];
     unsigned int flags = (unsigned int)params[2];
 
-    _strace(n, "buf=%p buflen=%zu flags=%d", buf, buflen, flags);
-
     return (_return(n, myst_syscall_getrandom(buf, buflen, flags)));
 }
 
@@ -5940,10 +5875,8 @@ static long _SYS_execveat(
 
 static long _SYS_membarrier(long n, long params[6])
 {
-    int cmd = (int)params[0];
-    int flags = (int)params[1];
+    (void)params;
 
-    _strace(n, "cmd=%d flags=%d", cmd, flags);
     /* membarrier syscall relies on inter-processor-interrupt and the
      * untrusted privileged SW layer such as the hypervisor or bare
      * metal OS to sychronize code execution across CPU cores. Not
@@ -5985,8 +5918,6 @@ static long _SYS_preadv2(long n, long params[6])
     off_t offset = (off_t)params[3];
     int flags = (int)params[4];
 
-    _strace(n, "fd=%d iov=%p iovcnt=%d offset=%zu", fd, iov, iovcnt, offset);
-
     long ret = myst_syscall_preadv2(fd, iov, iovcnt, offset, flags);
     return (_return(n, ret));
 }
@@ -5999,8 +5930,6 @@ static long _SYS_pwritev2(long n, long params[6])
     off_t offset = (off_t)params[3];
     int flags = (int)params[4];
 
-    _strace(n, "fd=%d iov=%p iovcnt=%d offset=%zu", fd, iov, iovcnt, offset);
-
     long ret = myst_syscall_pwritev2(fd, iov, iovcnt, offset, flags);
     return (_return(n, ret));
 }
@@ -6229,8 +6158,6 @@ static long _SYS_recvmsg(long n, long params[6])
     int flags = (int)params[2];
     long ret;
 
-    _strace(n, "sockfd=%d msg=%p flags=%d", sockfd, msg, flags);
-
     ret = myst_syscall_recvmsg(sockfd, msg, flags);
     return (_return(n, ret));
 }
@@ -6241,8 +6168,6 @@ static long _SYS_shutdown(long n, long params[6])
     int how = (int)params[1];
     long ret;
 
-    _strace(n, "sockfd=%d how=%d", sockfd, how);
-
     if (__myst_kernel_args.perf)
         myst_print_syscall_times("SYS_shutdown", 10);
 
@@ -6256,8 +6181,6 @@ static long _SYS_listen(long n, long params[6])
     int backlog = (int)params[1];
     long ret;
 
-    _strace(n, "sockfd=%d backlog=%d", sockfd, backlog);
-
     if (__myst_kernel_args.perf)
         myst_print_syscall_times("SYS_listen", 10);
 
@@ -6341,15 +6264,6 @@ static long _SYS_setsockopt(long n, long params[6])
     socklen_t optlen = (socklen_t)params[4];
     long ret;
 
-    _strace(
-        n,
-        "sockfd=%d level=%d optname=%d optval=%p optlen=%u",
-        sockfd,
-        level,
-        optname,
-        optval,
-        optlen);
-
     ret = myst_syscall_setsockopt(sockfd, level, optname, optval, optlen);
     return (_return(n, ret));
 }
@@ -6363,15 +6277,6 @@ static long _SYS_getsockopt(long n, long params[6])
     socklen_t* optlen = (socklen_t*)params[4];
     long ret;
 
-    _strace(
-        n,
-        "sockfd=%d level=%d optname=%d optval=%p optlen=%p",
-        sockfd,
-        level,
-        optname,
-        optval,
-        optlen);
-
     ret = myst_syscall_getsockopt(sockfd, level, optname, optval, optlen);
     return (_return(n, ret));
 }
@@ -6397,6 +6302,425 @@ static long _SYS_sendfile(long n, long params[6])
     return (_return(n, ret));
 }
 
+static long _SYS_myst_pre_launch_hook(long n, long params[6])
+{
+    (void)params;
+
+    _strace(n, NULL);
+
+    if (__myst_kernel_args.perf || __myst_kernel_args.trace_times)
+        _print_app_load_time();
+
+    return (_return(n, 0));
+}
+
+static long _SYS_myst_get_vdso(long n, long params[6])
+{
+    myst_thread_t* thread = myst_thread_self();
+
+    (void)params;
+
+    _strace(n, NULL);
+
+    /* keep the calls visible to strace by not publishing the page */
+    if (__myst_kernel_args.strace_config.trace_syscalls ||
+        __myst_kernel_args.strace_config.binary)
+    {
+        return (_return(n, -ENOTSUP));
+    }
+
+    /* kept current by _syscall() from now on */
+    myst_update_vdso(thread);
+
+    return (_return(n, (long)&thread->vdso));
+}
+
+static long _SYS_myst_oe_forward(long n, long params[6])
+{
+    _strace(n, "forwarded");
+    return (_return(n, _forward_syscall(n, params)));
+}
+
+/*
+**==============================================================================
+**
+** syscall table:
+**
+**     Syscalls whose handlers need nothing but the syscall number and its
+**     parameters are dispatched through this table, indexed by syscall
+**     number. The few that need the state of the calling thread (the thread
+**     descriptors, the process, or the syscall arguments) are handled by the
+**     switch statement in _syscall().
+**
+**     Entries that describe their arguments are traced by _call_syscall()
+**     before their handler runs, so the handler itself only implements the
+**     syscall. Handlers that decode their arguments (flags, structures, or
+**     parameters traced out of order) still call _strace() themselves.
+**
+**     Entries flagged SYSCALL_FAST are called by myst_syscall() without
+**     entering _syscall() at all. File descriptor syscalls (lseek, dup,
+**     fcntl) are never flagged, since whether they wait or leave the kernel
+**     depends on the file system or device behind the descriptor.
+**
+**==============================================================================
+*/
+
+/* the handler never waits (on futexes, host I/O, or other threads) */
+#define SYSCALL_NOBLOCK 0x1
+
+/* the handler never leaves the kernel (makes no tcalls) and so does not need
+ * the kernel fsbase that myst_syscall() installs for calls into the target */
+#define SYSCALL_KERNEL_ONLY 0x2
+
+/* the handler neither reads thread->user_rsp nor depends on pending signals
+ * being processed around it */
+#define SYSCALL_NOPROLOGUE 0x4
+
+/* myst_syscall() runs these handlers directly on the caller's stack and
+ * thread descriptor, without the prologue and epilogue of _syscall() */
+#define SYSCALL_FAST \
+    (SYSCALL_NOBLOCK | SYSCALL_KERNEL_ONLY | SYSCALL_NOPROLOGUE)
+
+typedef struct syscall_entry
+{
+    long (*handler)(long n, long params[6]);
+    uint32_t flags;
+
+    /* the arguments for strace: a printf format with one conversion per
+     * parameter, in parameter order (null if the handler traces itself) */
+    const char* args;
+} syscall_entry_t;
+
+static long _SYS_myst_batch(long n, long params[6]);
+
+static const syscall_entry_t _syscall_table[MYST_MAX_SYSCALLS] = {
+    [SYS_myst_trace] = {_SYS_myst_trace, 0, "msg=%s"},
+    [SYS_myst_trace_ptr] = {_SYS_myst_trace_ptr},
+    [SYS_myst_dump_stack] = {_SYS_myst_dump_stack, 0, ""},
+    [SYS_myst_dump_ehdr] = {_SYS_myst_dump_ehdr},
+    [SYS_myst_dump_argv] = {_SYS_myst_dump_argv},
+    [SYS_myst_add_symbol_file] = {_SYS_myst_add_symbol_file},
+    [SYS_myst_load_symbols] = {_SYS_myst_load_symbols},
+    [SYS_myst_unload_symbols] = {_SYS_myst_unload_symbols},
+    [SYS_myst_gen_creds] = {_SYS_myst_gen_creds, 0, ""},
+    [SYS_myst_free_creds] = {_SYS_myst_free_creds, 0, ""},
+    [SYS_myst_gen_creds_ex] = {_SYS_myst_gen_creds_ex, 0, ""},
+    [SYS_myst_verify_cert] = {_SYS_myst_verify_cert, 0, ""},
+    [SYS_myst_max_threads] = {_SYS_myst_max_threads, SYSCALL_FAST},
+    [SYS_myst_poll_wake] = {_SYS_myst_poll_wake},
+#ifdef MYST_ENABLE_GCOV
+    [SYS_myst_gcov] = {_SYS_myst_gcov, 0, "func=%s gcov_params=%p"},
+#endif
+    [SYS_myst_get_exec_stack_option] = {_SYS_myst_get_exec_stack_option},
+    [SYS_myst_get_process_thread_stack] = {_SYS_myst_get_process_thread_stack},
+    [SYS_read] = {_SYS_read, 0, "fd=%d buf=%p count=%zu"},
+    [SYS_write] = {_SYS_write, 0, "fd=%d buf=%p count=%zu"},
+    [SYS_pread64] = {_SYS_pread64, 0, "fd=%d buf=%p count=%zu offset=%ld"},
+    [SYS_pwrite64] = {_SYS_pwrite64, 0, "fd=%d buf=%p count=%zu offset=%ld"},
+    [SYS_open] = {_SYS_open},
+    [SYS_close] = {_SYS_close, 0, "fd=%d"},
+    [SYS_stat] = {_SYS_stat, 0, "pathname=\"%s\" statbuf=%p"},
+    [SYS_fstat] = {_SYS_fstat, 0, "fd=%d statbuf=%p"},
+    [SYS_lstat] = {_SYS_lstat, 0, "pathname=\"%s\" statbuf=%p"},
+    [SYS_poll] = {_SYS_poll, 0, "fds=%p nfds=%ld timeout=%d"},
+    [SYS_lseek] = {_SYS_lseek, 0, "fd=%d offset=%ld whence=%d"},
+    [SYS_mprotect] = {_SYS_mprotect},
+    [SYS_brk] = {_SYS_brk},
+    [SYS_rt_sigaction] = {_SYS_rt_sigaction},
+    [SYS_rt_sigprocmask] =
+        {_SYS_rt_sigprocmask, SYSCALL_NOBLOCK, "how=%d set=%p oldset=%p"},
+    [SYS_ioctl] = {_SYS_ioctl},
+    [SYS_readv] = {_SYS_readv, 0, "fd=%d iov=%p iovcnt=%d"},
+    [SYS_writev] = {_SYS_writev, 0, "fd=%d iov=%p iovcnt=%d"},
+    [SYS_access] = {_SYS_access, 0, "pathname=\"%s\" mode=%d"},
+    [SYS_pipe] = {_SYS_pipe},
+    [SYS_select] = {_SYS_select},
+    [SYS_sched_yield] = {_SYS_sched_yield},
+    [SYS_mremap] = {_SYS_mremap},
+    [SYS_msync] = {_SYS_msync, 0, "addr=%p length=%zu flags=%d "},
+    [SYS_madvise] = {_SYS_madvise, 0, "addr=%p length=%zu advice=%d"},
+    [SYS_dup] = {_SYS_dup, 0, "oldfd=%d"},
+    [SYS_dup2] = {_SYS_dup2, 0, "oldfd=%d newfd=%d"},
+    [SYS_dup3] = {_SYS_dup3, 0, "oldfd=%d newfd=%d flags=%o"},
+    [SYS_pause] = {_SYS_pause},
+    [SYS_nanosleep] = {_SYS_nanosleep},
+    [SYS_getpid] = {_SYS_getpid, SYSCALL_FAST},
+    [SYS_myst_clone] = {_SYS_myst_clone},
+    [SYS_myst_interrupt_thread] = {_SYS_myst_interrupt_thread, 0, "tid=%d"},
+    [SYS_wait4] = {_SYS_wait4, 0, "pid=%d wstatus=%p options=%d rusage=%p"},
+    [SYS_kill] = {_SYS_kill},
+    [SYS_uname] = {_SYS_uname, SYSCALL_NOBLOCK},
+    [SYS_fcntl] = {_SYS_fcntl},
+    [SYS_flock] = {_SYS_flock, 0, "fd=%d cmd=%d"},
+    [SYS_fsync] = {_SYS_fsync, 0, "fd=%d"},
+    [SYS_fdatasync] = {_SYS_fdatasync, 0, "fd=%d"},
+    [SYS_truncate] = {_SYS_truncate, 0, "path=\"%s\" length=%ld"},
+    [SYS_ftruncate] = {_SYS_ftruncate, 0, "fd=%d length=%ld"},
+    [SYS_getcwd] = {_SYS_getcwd, SYSCALL_FAST, "buf=%p size=%zu"},
+    [SYS_chdir] = {_SYS_chdir},
+    [SYS_fchdir] = {_SYS_fchdir, 0, "fd=%d"},
+    [SYS_rename] = {_SYS_rename, 0, "oldpath=\"%s\" newpath=\"%s\""},
+    [SYS_mkdir] = {_SYS_mkdir},
+    [SYS_rmdir] = {_SYS_rmdir, 0, "pathname=\"%s\""},
+    [SYS_creat] = {_SYS_creat},
+    [SYS_link] = {_SYS_link, 0, "oldpath=\"%s\" newpath=\"%s\""},
+    [SYS_unlink] = {_SYS_unlink, 0, "pathname=\"%s\""},
+    [SYS_symlink] = {_SYS_symlink, 0, "target=\"%s\" linkpath=\"%s\""},
+    [SYS_readlink] = {_SYS_readlink, 0, "pathname=\"%s\" buf=%p bufsiz=%zu"},
+    [SYS_chmod] = {_SYS_chmod, 0, "pathname=\"%s\" mode=%o"},
+    [SYS_fchmod] = {_SYS_fchmod, 0, "fd=%d mode=%o"},
+    [SYS_chown] = {_SYS_chown, 0, "pathname=%s owner=%u group=%u"},
+    [SYS_fchown] = {_SYS_fchown, 0, "fd=%d owner=%u group=%u"},
+    [SYS_fchownat] =
+        {_SYS_fchownat, 0, "dirfd=%d pathname=%s owner=%u group=%u flags=%d"},
+    [SYS_lchown] = {_SYS_lchown},
+    [SYS_umask] = {_SYS_umask, SYSCALL_FAST, "mask=%o"},
+    [SYS_gettimeofday] = {_SYS_gettimeofday, SYSCALL_NOBLOCK, "tv=%p tz=%p"},
+    [SYS_getrusage] = {_SYS_getrusage, SYSCALL_NOBLOCK, "who=%d usage=%p"},
+    [SYS_sysinfo] = {_SYS_sysinfo, SYSCALL_NOBLOCK, "info=%p"},
+    [SYS_syslog] = {_SYS_syslog},
+    [SYS_getppid] = {_SYS_getppid, SYSCALL_FAST},
+    [SYS_getsid] = {_SYS_getsid, SYSCALL_FAST},
+    [SYS_setsid] = {_SYS_setsid},
+    [SYS_getgroups] = {_SYS_getgroups, SYSCALL_FAST, ""},
+    [SYS_setgroups] = {_SYS_setgroups},
+    [SYS_getuid] = {_SYS_getuid, SYSCALL_FAST},
+    [SYS_setuid] = {_SYS_setuid},
+    [SYS_getgid] = {_SYS_getgid, SYSCALL_FAST},
+    [SYS_setgid] = {_SYS_setgid},
+    [SYS_geteuid] = {_SYS_geteuid, SYSCALL_FAST},
+    [SYS_getegid] = {_SYS_getegid, SYSCALL_FAST},
+    [SYS_setreuid] = {_SYS_setreuid, 0, "ruid=%u euid=%u"},
+    [SYS_setregid] = {_SYS_setregid, 0, "rgid=%u egid=%u"},
+    [SYS_setresuid] = {_SYS_setresuid, 0, "ruid=%u euid=%u savuid=%u"},
+    [SYS_getresuid] = {_SYS_getresuid, SYSCALL_FAST, ""},
+    [SYS_setresgid] = {_SYS_setresgid, 0, "rgid=%u egid=%u savgid=%u"},
+    [SYS_getresgid] = {_SYS_getresgid, SYSCALL_FAST, ""},
+    [SYS_setfsuid] = {_SYS_setfsuid, 0, "fsuid=%u"},
+    [SYS_setfsgid] = {_SYS_setfsgid, 0, "fsgid=%u"},
+    [SYS_rt_sigpending] = {_SYS_rt_sigpending, SYSCALL_FAST, "set=%p size=%d"},
+    [SYS_sigaltstack] =
+        {_SYS_sigaltstack, SYSCALL_NOBLOCK | SYSCALL_KERNEL_ONLY},
+    [SYS_mknod] = {_SYS_mknod},
+    [SYS_statfs] = {_SYS_statfs, 0, "path=\"%s\" buf=%p"},
+    [SYS_fstatfs] = {_SYS_fstatfs, 0, "fd=%d buf=%p"},
+    [SYS_sched_setparam] = {_SYS_sched_setparam},
+    [SYS_sched_getparam] = {_SYS_sched_getparam, 0, "pid=%d param=%p"},
+    [SYS_sched_setscheduler] = {_SYS_sched_setscheduler},
+    [SYS_sched_getscheduler] = {_SYS_sched_getscheduler},
+    [SYS_sched_get_priority_max] = {_SYS_sched_get_priority_max},
+    [SYS_sched_get_priority_min] = {_SYS_sched_get_priority_min},
+    [SYS_mlock] = {_SYS_mlock},
+    [SYS_prctl] = {_SYS_prctl},
+    [SYS_sync] = {_SYS_sync},
+    [SYS_mount] =
+        {_SYS_mount,
+         0,
+         "source=%s target=%s filesystemtype=%s mountflags=%lu data=%p"},
+    [SYS_umount2] = {_SYS_umount2, 0, "target=%p flags=%d"},
+    [SYS_sethostname] = {_SYS_sethostname, 0, "name=\"%s\" len=%zu"},
+    [SYS_gettid] = {_SYS_gettid, SYSCALL_FAST},
+    [SYS_fsetxattr] = {_SYS_fsetxattr},
+    [SYS_time] = {_SYS_time, SYSCALL_NOBLOCK, "tloc=%p"},
+    [SYS_futex] = {_SYS_futex},
+    [SYS_sched_setaffinity] =
+        {_SYS_sched_setaffinity, 0, "pid=%d cpusetsize=%zu mask=%p"},
+    [SYS_sched_getaffinity] =
+        {_SYS_sched_getaffinity,
+         SYSCALL_NOBLOCK,
+         "pid=%d cpusetsize=%zu mask=%p"},
+    [SYS_epoll_create] = {_SYS_epoll_create, 0, "size=%d"},
+    [SYS_getdents64] = {_SYS_getdents64, 0, "fd=%d dirp=%p count=%u"},
+    [SYS_set_tid_address] = {_SYS_set_tid_address, SYSCALL_FAST},
+    [SYS_fadvise64] = {_SYS_fadvise64, 0, "fd=%d offset=%ld len=%ld advice=%d"},
+    [SYS_clock_settime] = {_SYS_clock_settime},
+    [SYS_clock_getres] =
+        {_SYS_clock_getres, SYSCALL_NOBLOCK, "clk_id=%u tp=%p"},
+    [SYS_epoll_wait] =
+        {_SYS_epoll_wait, 0, "edpf=%d events=%p maxevents=%d timeout=%d"},
+    [SYS_epoll_ctl] = {_SYS_epoll_ctl, 0, "edpf=%d op=%d fd=%d event=%p"},
+    [SYS_tgkill] = {_SYS_tgkill, 0, "tgid=%d tid=%d sig=%d"},
+    [SYS_mbind] =
+        {_SYS_mbind,
+         0,
+         "addr=%p len=%lu mode=%d nodemask=%p maxnode=%lu flags=%u"},
+    [SYS_waitid] = {_SYS_waitid, 0, "idtype=%i id=%i infop=%p options=%x"},
+    [SYS_inotify_init] = {_SYS_inotify_init},
+    [SYS_inotify_add_watch] = {_SYS_inotify_add_watch},
+    [SYS_inotify_rm_watch] = {_SYS_inotify_rm_watch, 0, "fd=%d wd=%d"},
+    [SYS_openat] = {_SYS_openat},
+    [SYS_futimesat] = {_SYS_futimesat},
+    [SYS_newfstatat] =
+        {_SYS_newfstatat, 0, "dirfd=%d pathname=%s statbuf=%p flags=%d"},
+    [SYS_unlinkat] = {_SYS_unlinkat, 0, "dirfd=%d pathname=%s flags=%d"},
+    [SYS_renameat] =
+        {_SYS_renameat,
+         0,
+         "olddirfd=%d oldpath=\"%s\" newdirfd=%d newpath=\"%s\""},
+    [SYS_linkat] =
+        {_SYS_linkat,
+         0,
+         "olddirfd=%d oldpath=%s newdirfd=%d newpath=%s flags=%d"},
+    [SYS_symlinkat] = {_SYS_symlinkat, 0, "target=%s newdirfd=%d linkpath=%s"},
+    [SYS_readlinkat] =
+        {_SYS_readlinkat, 0, "dirfd=%d pathname=%s buf=%p bufsize=%ld"},
+    [SYS_fchmodat] =
+        {_SYS_fchmodat, 0, "dirfd=%d pathname=\"%s\" mode=0%o flags=0%o"},
+    [SYS_faccessat] =
+        {_SYS_faccessat, 0, "dirfd=%d pathname=%s mode=%d flags=%d"},
+    [SYS_set_robust_list] = {_SYS_set_robust_list, 0, "head=%p len=%zu"},
+    [SYS_get_robust_list] = {_SYS_get_robust_list, 0, "pid=%d head=%p len=%p"},
+    [SYS_utimensat] =
+        {_SYS_utimensat, 0, "dirfd=%d pathname=%s times=%p flags=%o"},
+    [SYS_epoll_pwait] =
+        {_SYS_epoll_pwait,
+         0,
+         "edpf=%d events=%p maxevents=%d timeout=%d sigmask=%p"},
+    [SYS_fallocate] = {_SYS_fallocate, 0, "fd=%d mode=%d offset=%ld len=%ld"},
+    [SYS_accept4] = {_SYS_accept4},
+    [SYS_eventfd2] = {_SYS_eventfd2, 0, "initval=%u flags=%d"},
+    [SYS_epoll_create1] = {_SYS_epoll_create1, 0, "flags=%d"},
+    [SYS_pipe2] = {_SYS_pipe2},
+    [SYS_inotify_init1] = {_SYS_inotify_init1, 0, "flags=%x"},
+    [SYS_preadv] = {_SYS_preadv, 0, "fd=%d iov=%p iovcnt=%d offset=%zu"},
+    [SYS_pwritev] = {_SYS_pwritev, 0, "fd=%d iov=%p iovcnt=%d offset=%zu"},
+    [SYS_recvmmsg] = {_SYS_recvmmsg},
+    [SYS_prlimit64] =
+        {_SYS_prlimit64, 0, "pid=%d resource=%d new_rlim=%p old_rlim=%p"},
+    [SYS_getcpu] = {_SYS_getcpu, 0, "cpu=%p node=%p, tcache=%p"},
+    [SYS_getrandom] =
+        {_SYS_getrandom, SYSCALL_NOBLOCK, "buf=%p buflen=%zu flags=%d"},
+    [SYS_membarrier] = {_SYS_membarrier, 0, "cmd=%d flags=%d"},
+    [SYS_copy_file_range] = {_SYS_copy_file_range},
+    [SYS_preadv2] = {_SYS_preadv2, 0, "fd=%d iov=%p iovcnt=%d offset=%zu"},
+    [SYS_pwritev2] = {_SYS_pwritev2, 0, "fd=%d iov=%p iovcnt=%d offset=%zu"},
+    [SYS_futex_waitv] = {_SYS_futex_waitv},
+    [SYS_bind] = {_SYS_bind},
+    [SYS_connect] = {_SYS_connect},
+    [SYS_recvfrom] = {_SYS_recvfrom},
+    [SYS_socket] = {_SYS_socket},
+    [SYS_accept] = {_SYS_accept},
+    [SYS_recvmsg] = {_SYS_recvmsg, 0, "sockfd=%d msg=%p flags=%d"},
+    [SYS_shutdown] = {_SYS_shutdown, 0, "sockfd=%d how=%d"},
+    [SYS_listen] = {_SYS_listen, 0, "sockfd=%d backlog=%d"},
+    [SYS_getsockname] = {_SYS_getsockname},
+    [SYS_getpeername] = {_SYS_getpeername},
+    [SYS_socketpair] = {_SYS_socketpair},
+    [SYS_setsockopt] =
+        {_SYS_setsockopt,
+         0,
+         "sockfd=%d level=%d optname=%d optval=%p optlen=%u"},
+    [SYS_getsockopt] =
+        {_SYS_getsockopt,
+         0,
+         "sockfd=%d level=%d optname=%d optval=%p optlen=%p"},
+    [SYS_sendfile] = {_SYS_sendfile},
+    [SYS_myst_pre_launch_hook] = {_SYS_myst_pre_launch_hook},
+    [SYS_myst_get_vdso] = {_SYS_myst_get_vdso, SYSCALL_FAST},
+    /* forward Open Enclave extensions to the target */
+    [SYS_myst_oe_get_report_v2] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_free_report] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_get_target_info_v2] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_free_target_info] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_parse_report] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_verify_report] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_get_seal_key_by_policy_v2] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_get_public_key_by_policy] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_get_public_key] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_get_private_key_by_policy] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_get_private_key] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_free_key] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_get_seal_key_v2] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_free_seal_key] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_generate_attestation_certificate] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_free_attestation_certificate] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_verify_attestation_certificate] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_result_str] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_get_enclave_start_address] = {_SYS_myst_oe_forward},
+    [SYS_myst_oe_get_enclave_base_address] = {_SYS_myst_oe_forward},
+    [SYS_myst_batch] = {_SYS_myst_batch},
+};
+
+static long _call_syscall(long n, long params[6])
+{
+    const syscall_entry_t* entry = &_syscall_table[n];
+
+    if (entry->args)
+        _strace_params(n, entry->args, params);
+
+    return entry->handler(n, params);
+}
+
+/*
+**==============================================================================
+**
+** SYS_myst_batch:
+**
+**     Runs an array of syscalls (see myst_batch_entry_t) within a single
+**     kernel entry. Only table syscalls may be batched, since the others need
+**     the state that _syscall() resolves on entry (and may not return).
+**
+**==============================================================================
+*/
+
+static long _SYS_myst_batch(long n, long params[6])
+{
+    long ret = 0;
+    myst_batch_entry_t* entries = (myst_batch_entry_t*)params[0];
+    size_t count = (size_t)params[1];
+    int flags = (int)params[2];
+    const size_t esize = sizeof(myst_batch_entry_t);
+    bool cancel = false;
+    size_t i;
+
+    _strace(n, "entries=%p count=%zu flags=%d", entries, count, flags);
+
+    if (count > MYST_BATCH_MAX || (flags & ~MYST_BATCH_STOP_ON_ERROR))
+        ERAISE(-EINVAL);
+
+    if (count && myst_is_bad_addr_read_write(entries, count * esize))
+        ERAISE(-EFAULT);
+
+    for (i = 0; i < count; i++)
+    {
+        myst_batch_entry_t* e = &entries[i];
+
+        /* a failed entry cancels the rest of its link chain */
+        if (cancel)
+        {
+            e->ret = -ECANCELED;
+        }
+        else if (
+            e->n < 0 || e->n >= MYST_MAX_SYSCALLS || e->n == SYS_myst_batch ||
+            !_syscall_table[e->n].handler)
+        {
+            e->ret = -ENOSYS;
+        }
+        else
+        {
+            e->ret = _call_syscall(e->n, e->params);
+        }
+
+        if (e->ret < 0 && (flags & MYST_BATCH_STOP_ON_ERROR))
+        {
+            i++;
+            break;
+        }
+
+        /* an entry without the link flag ends the chain */
+        cancel = e->ret < 0 && (e->flags & MYST_BATCH_LINK);
+    }
+
+    ret = (long)i;
+
+    /* mark the entries that were never reached */
+    for (; i < count; i++)
+        entries[i].ret = -ECANCELED;
+
+done:
+    return (_return(n, ret));
+}
+
 #define BREAK(RET)           \
     do                       \
     {                        \
@@ -6466,220 +6790,25 @@ static long _syscall(void* args_)
     myst_assume(target_td != NULL);
     myst_assume(thread != NULL);
 
+    /* dispatch syscalls that only need their parameters through the table */
+    if (n >= 0 && n < MYST_MAX_SYSCALLS && _syscall_table[n].handler)
+        BREAK(_call_syscall(n, params));
+
+    /* handle syscalls that need the state of the calling thread */
     switch (n)
     {
-        case SYS_myst_trace:
-        {
-            BREAK(_SYS_myst_trace(n, params));
-        }
-        case SYS_myst_trace_ptr:
-        {
-            BREAK(_SYS_myst_trace_ptr(n, params));
-        }
-        case SYS_myst_dump_stack:
-        {
-            BREAK(_SYS_myst_dump_stack(n, params));
-        }
-        case SYS_myst_dump_ehdr:
-        {
-            BREAK(_SYS_myst_dump_ehdr(n, params));
-        }
-        case SYS_myst_dump_argv:
-        {
-            BREAK(_SYS_myst_dump_argv(n, params));
-        }
-        case SYS_myst_add_symbol_file:
-        {
-            BREAK(_SYS_myst_add_symbol_file(n, params));
-        }
-        case SYS_myst_load_symbols:
-        {
-            BREAK(_SYS_myst_load_symbols(n, params));
-        }
-        case SYS_myst_unload_symbols:
-        {
-            BREAK(_SYS_myst_unload_symbols(n, params));
-        }
-        case SYS_myst_gen_creds:
-        {
-            BREAK(_SYS_myst_gen_creds(n, params));
-        }
-        case SYS_myst_free_creds:
-        {
-            BREAK(_SYS_myst_free_creds(n, params));
-        }
-        case SYS_myst_gen_creds_ex:
-        {
-            BREAK(_SYS_myst_gen_creds_ex(n, params));
-        }
-        case SYS_myst_verify_cert:
-        {
-            BREAK(_SYS_myst_verify_cert(n, params));
-        }
-        case SYS_myst_max_threads:
-        {
-            BREAK(_SYS_myst_max_threads(n, params));
-        }
-        case SYS_myst_poll_wake:
-        {
-            BREAK(_SYS_myst_poll_wake(n, params));
-        }
-#ifdef MYST_ENABLE_GCOV
-        case SYS_myst_gcov:
-        {
-            BREAK(_SYS_myst_gcov(n, params));
-        }
-#endif
         case SYS_myst_unmap_on_exit:
         {
             BREAK(_SYS_myst_unmap_on_exit(n, params, thread));
         }
-        case SYS_myst_get_exec_stack_option:
-        {
-            BREAK(_SYS_myst_get_exec_stack_option(n, params));
-        }
-        case SYS_myst_get_process_thread_stack:
-        {
-            BREAK(_SYS_myst_get_process_thread_stack(n, params));
-        }
-        case SYS_read:
-        {
-            BREAK(_SYS_read(n, params));
-        }
-        case SYS_write:
-        {
-            BREAK(_SYS_write(n, params));
-        }
-        case SYS_pread64:
-        {
-            BREAK(_SYS_pread64(n, params));
-        }
-        case SYS_pwrite64:
-        {
-            BREAK(_SYS_pwrite64(n, params));
-        }
-        case SYS_open:
-        {
-            BREAK(_SYS_open(n, params));
-        }
-        case SYS_close:
-        {
-            BREAK(_SYS_close(n, params));
-        }
-        case SYS_stat:
-        {
-            BREAK(_SYS_stat(n, params));
-        }
-        case SYS_fstat:
-        {
-            BREAK(_SYS_fstat(n, params));
-        }
-        case SYS_lstat:
-        {
-            BREAK(_SYS_lstat(n, params));
-        }
-        case SYS_poll:
-        {
-            BREAK(_SYS_poll(n, params));
-        }
-        case SYS_lseek:
-        {
-            BREAK(_SYS_lseek(n, params));
-        }
         case SYS_mmap:
         {
             BREAK(_SYS_mmap(n, params, process));
         }
-        case SYS_mprotect:
-        {
-            BREAK(_SYS_mprotect(n, params));
-        }
         case SYS_munmap:
         {
             BREAK(_SYS_munmap(n, params, thread, crt_td));
         }
-        case SYS_brk:
-        {
-            BREAK(_SYS_brk(n, params));
-        }
-        case SYS_rt_sigaction:
-        {
-            BREAK(_SYS_rt_sigaction(n, params));
-        }
-        case SYS_rt_sigprocmask:
-        {
-            BREAK(_SYS_rt_sigprocmask(n, params));
-        }
-        case SYS_rt_sigreturn:
-            break;
-        case SYS_ioctl:
-        {
-            BREAK(_SYS_ioctl(n, params));
-        }
-        case SYS_readv:
-        {
-            BREAK(_SYS_readv(n, params));
-        }
-        case SYS_writev:
-        {
-            BREAK(_SYS_writev(n, params));
-        }
-        case SYS_access:
-        {
-            BREAK(_SYS_access(n, params));
-        }
-        case SYS_pipe:
-        {
-            BREAK(_SYS_pipe(n, params));
-        }
-        case SYS_select:
-        {
-            BREAK(_SYS_select(n, params));
-        }
-        case SYS_sched_yield:
-        {
-            BREAK(_SYS_sched_yield(n, params));
-        }
-        case SYS_mremap:
-        {
-            BREAK(_SYS_mremap(n, params));
-        }
-        case SYS_msync:
-        {
-            BREAK(_SYS_msync(n, params));
-        }
-        case SYS_mincore:
-            break;
-        case SYS_madvise:
-        {
-            BREAK(_SYS_madvise(n, params));
-        }
-        case SYS_shmget:
-            break;
-        case SYS_shmat:
-            break;
-        case SYS_shmctl:
-            break;
-        case SYS_dup:
-        {
-            BREAK(_SYS_dup(n, params));
-        }
-        case SYS_dup2:
-        {
-            BREAK(_SYS_dup2(n, params));
-        }
-        case SYS_dup3:
-        {
-            BREAK(_SYS_dup3(n, params));
-        }
-        case SYS_pause:
-        {
-            BREAK(_SYS_pause(n, params));
-        }
-        case SYS_nanosleep:
-        {
-            BREAK(_SYS_nanosleep(n, params));
-        }
         case SYS_myst_run_itimer:
         {
             BREAK(_SYS_myst_run_itimer(n, params, process));
@@ -6688,33 +6817,19 @@ static long _syscall(void* args_)
         {
             BREAK(_SYS_getitimer(n, params, process));
         }
-        case SYS_alarm:
-            break;
         case SYS_setitimer:
         {
             BREAK(_SYS_setitimer(n, params, process));
         }
-        case SYS_getpid:
-        {
-            BREAK(_SYS_getpid(n, params));
-        }
         case SYS_clone:
         {
             /* unsupported: using SYS_myst_clone instead */
             break;
         }
-        case SYS_myst_clone:
-        {
-            BREAK(_SYS_myst_clone(n, params));
-        }
         case SYS_myst_get_fork_info:
         {
             BREAK(_SYS_myst_get_fork_info(n, params, process));
         }
-        case SYS_myst_interrupt_thread:
-        {
-            BREAK(_SYS_myst_interrupt_thread(n, params));
-        }
         case SYS_myst_fork_wait_exec_exit:
         {
             BREAK(_SYS_myst_fork_wait_exec_exit(n, params, thread));
@@ -6723,19 +6838,6 @@ static long _syscall(void* args_)
         {
             BREAK(_SYS_myst_kill_wait_child_forks(n, params, process));
         }
-        case SYS_myst_pre_launch_hook:
-        {
-            _strace(n, NULL);
-
-            if (__myst_kernel_args.perf || __myst_kernel_args.trace_times)
-                _print_app_load_time();
-
-            BREAK(_return(n, 0));
-        }
-        case SYS_fork:
-            break;
-        case SYS_vfork:
-            break;
         case SYS_execve:
         {
             BREAK(_SYS_execve(n, params, thread, args));
@@ -6745,918 +6847,80 @@ static long _syscall(void* args_)
         {
             BREAK(_SYS_exit_group(n, params, args, thread, process));
         }
-        case SYS_wait4:
+        case SYS_times:
         {
-            BREAK(_SYS_wait4(n, params));
+            BREAK(_SYS_times(n, params, process));
         }
-        case SYS_kill:
+        case SYS_setpgid:
         {
-            BREAK(_SYS_kill(n, params));
+            BREAK(_SYS_setpgid(n, params, thread));
         }
-        case SYS_uname:
+        case SYS_getpgid:
         {
-            BREAK(_SYS_uname(n, params));
+            BREAK(_SYS_getpgid(n, params, thread));
         }
-        case SYS_semget:
-            break;
-        case SYS_semop:
-            break;
-        case SYS_semctl:
-            break;
-        case SYS_shmdt:
-            break;
-        case SYS_msgget:
-            break;
-        case SYS_msgsnd:
-            break;
-        case SYS_msgrcv:
-            break;
-        case SYS_msgctl:
-            break;
-        case SYS_fcntl:
+        case SYS_getpgrp:
         {
-            BREAK(_SYS_fcntl(n, params));
+            BREAK(_SYS_getpgrp(n, params, process, thread));
         }
-        case SYS_flock:
+        case SYS_arch_prctl:
         {
-            BREAK(_SYS_flock(n, params));
+            /* this is handled in myst_syscall() */
+            break;
         }
-        case SYS_fsync:
+        case SYS_tkill:
         {
-            BREAK(_SYS_fsync(n, params));
+            BREAK(_SYS_tkill(n, params, process));
         }
-        case SYS_fdatasync:
+        case SYS_set_thread_area:
         {
-            BREAK(_SYS_fdatasync(n, params));
+            BREAK(_SYS_set_thread_area(
+                n,
+                params,
+                &crt_td,
+                target_td,
+                thread,
+                &_set_thread_area_called));
         }
-        case SYS_truncate:
+        case SYS_clock_gettime:
         {
-            BREAK(_SYS_truncate(n, params));
+            /* this is handled in myst_syscall() */
+            break;
         }
-        case SYS_ftruncate:
+        case SYS_mkdirat:
         {
-            BREAK(_SYS_ftruncate(n, params));
+            BREAK(_SYS_mkdirat(n, params, process));
         }
-        case SYS_getdents:
-            break;
-        case SYS_getcwd:
+        case SYS_ppoll:
         {
-            BREAK(_SYS_getcwd(n, params));
+            BREAK(_SYS_ppoll(n, params, process));
         }
-        case SYS_chdir:
-        {
-            BREAK(_SYS_chdir(n, params));
-        }
-        case SYS_fchdir:
-        {
-            BREAK(_SYS_fchdir(n, params));
-        }
-        case SYS_rename:
-        {
-            BREAK(_SYS_rename(n, params));
-        }
-        case SYS_mkdir:
-        {
-            BREAK(_SYS_mkdir(n, params));
-        }
-        case SYS_rmdir:
-        {
-            BREAK(_SYS_rmdir(n, params));
-        }
-        case SYS_creat:
-        {
-            BREAK(_SYS_creat(n, params));
-        }
-        case SYS_link:
-        {
-            BREAK(_SYS_link(n, params));
-        }
-        case SYS_unlink:
-        {
-            BREAK(_SYS_unlink(n, params));
-        }
-        case SYS_symlink:
-        {
-            BREAK(_SYS_symlink(n, params));
-        }
-        case SYS_readlink:
-        {
-            BREAK(_SYS_readlink(n, params));
-        }
-        case SYS_chmod:
-        {
-            BREAK(_SYS_chmod(n, params));
-        }
-        case SYS_fchmod:
-        {
-            BREAK(_SYS_fchmod(n, params));
-        }
-        case SYS_chown:
-        {
-            BREAK(_SYS_chown(n, params));
-        }
-        case SYS_fchown:
-        {
-            BREAK(_SYS_fchown(n, params));
-        }
-        case SYS_fchownat:
-        {
-            BREAK(_SYS_fchownat(n, params));
-        }
-        case SYS_lchown:
-        {
-            BREAK(_SYS_lchown(n, params));
-        }
-        case SYS_umask:
-        {
-            BREAK(_SYS_umask(n, params));
-        }
-        case SYS_gettimeofday:
-        {
-            BREAK(_SYS_gettimeofday(n, params));
-        }
-        case SYS_getrlimit:
-            break;
-        case SYS_getrusage:
-        {
-            BREAK(_SYS_getrusage(n, params));
-        }
-        case SYS_sysinfo:
-        {
-            BREAK(_SYS_sysinfo(n, params));
-        }
-        case SYS_times:
-        {
-            BREAK(_SYS_times(n, params, process));
-        }
-        case SYS_ptrace:
-            break;
-        case SYS_syslog:
-        {
-            BREAK(_SYS_syslog(n, params));
-        }
-        case SYS_setpgid:
-        {
-            BREAK(_SYS_setpgid(n, params, thread));
-        }
-        case SYS_getpgid:
-        {
-            BREAK(_SYS_getpgid(n, params, thread));
-        }
-        case SYS_getpgrp:
-        {
-            BREAK(_SYS_getpgrp(n, params, process, thread));
-        }
-        case SYS_getppid:
-        {
-            BREAK(_SYS_getppid(n, params));
-        }
-        case SYS_getsid:
-        {
-            BREAK(_SYS_getsid(n, params));
-        }
-        case SYS_setsid:
-        {
-            BREAK(_SYS_setsid(n, params));
-        }
-        case SYS_getgroups:
-        {
-            BREAK(_SYS_getgroups(n, params));
-        }
-        case SYS_setgroups:
-        {
-            BREAK(_SYS_setgroups(n, params));
-        }
-        case SYS_getuid:
-        {
-            BREAK(_SYS_getuid(n, params));
-        }
-        case SYS_setuid:
-        {
-            BREAK(_SYS_setuid(n, params));
-        }
-        case SYS_getgid:
-        {
-            BREAK(_SYS_getgid(n, params));
-        }
-        case SYS_setgid:
-        {
-            BREAK(_SYS_setgid(n, params));
-        }
-        case SYS_geteuid:
-        {
-            BREAK(_SYS_geteuid(n, params));
-        }
-        case SYS_getegid:
-        {
-            BREAK(_SYS_getegid(n, params));
-        }
-        case SYS_setreuid:
-        {
-            BREAK(_SYS_setreuid(n, params));
-        }
-        case SYS_setregid:
-        {
-            BREAK(_SYS_setregid(n, params));
-        }
-        case SYS_setresuid:
-        {
-            BREAK(_SYS_setresuid(n, params));
-        }
-        case SYS_getresuid:
-        {
-            BREAK(_SYS_getresuid(n, params));
-        }
-        case SYS_setresgid:
-        {
-            BREAK(_SYS_setresgid(n, params));
-        }
-        case SYS_getresgid:
-        {
-            BREAK(_SYS_getresgid(n, params));
-        }
-        case SYS_setfsuid:
-        {
-            BREAK(_SYS_setfsuid(n, params));
-        }
-        case SYS_setfsgid:
-        {
-            BREAK(_SYS_setfsgid(n, params));
-        }
-        case SYS_capget:
-            break;
-        case SYS_capset:
-            break;
-        case SYS_rt_sigpending:
-        {
-            BREAK(_SYS_rt_sigpending(n, params));
-        }
-        case SYS_rt_sigtimedwait:
-            break;
-        case SYS_rt_sigqueueinfo:
-            break;
-        case SYS_rt_sigsuspend:
-            break;
-        case SYS_sigaltstack:
-        {
-            BREAK(_SYS_sigaltstack(n, params));
-        }
-        case SYS_utime:
-            break;
-        case SYS_mknod:
-        {
-            BREAK(_SYS_mknod(n, params));
-        }
-        case SYS_uselib:
-            break;
-        case SYS_personality:
-            break;
-        case SYS_ustat:
-            break;
-        case SYS_statfs:
-        {
-            BREAK(_SYS_statfs(n, params));
-        }
-        case SYS_fstatfs:
-        {
-            BREAK(_SYS_fstatfs(n, params));
-        }
-        case SYS_sysfs:
-            break;
-        case SYS_getpriority:
-            break;
-        case SYS_setpriority:
-            break;
-        case SYS_sched_setparam:
-        {
-            BREAK(_SYS_sched_setparam(n, params));
-        }
-        case SYS_sched_getparam:
-        {
-            BREAK(_SYS_sched_getparam(n, params));
-        }
-        case SYS_sched_setscheduler:
-        {
-            BREAK(_SYS_sched_setscheduler(n, params));
-        }
-        case SYS_sched_getscheduler:
-        {
-            BREAK(_SYS_sched_getscheduler(n, params));
-        }
-        case SYS_sched_get_priority_max:
-        {
-            BREAK(_SYS_sched_get_priority_max(n, params));
-        }
-        case SYS_sched_get_priority_min:
-        {
-            BREAK(_SYS_sched_get_priority_min(n, params));
-        }
-        case SYS_sched_rr_get_interval:
-            break;
-        case SYS_mlock:
-        {
-            BREAK(_SYS_mlock(n, params));
-        }
-        case SYS_munlock:
-            break;
-        case SYS_mlockall:
-            break;
-        case SYS_munlockall:
-            break;
-        case SYS_vhangup:
-            break;
-        case SYS_modify_ldt:
-            break;
-        case SYS_pivot_root:
-            break;
-        case SYS__sysctl:
-            break;
-        case SYS_prctl:
-        {
-            BREAK(_SYS_prctl(n, params));
-        }
-        case SYS_arch_prctl:
-        {
-            /* this is handled in myst_syscall() */
-            break;
-        }
-        case SYS_adjtimex:
-            break;
-        case SYS_setrlimit:
-            break;
-        case SYS_chroot:
-            break;
-        case SYS_sync:
-        {
-            BREAK(_SYS_sync(n, params));
-        }
-        case SYS_acct:
-            break;
-        case SYS_settimeofday:
-            break;
-        case SYS_mount:
-        {
-            BREAK(_SYS_mount(n, params));
-        }
-        case SYS_umount2:
-        {
-            BREAK(_SYS_umount2(n, params));
-        }
-        case SYS_swapon:
-            break;
-        case SYS_swapoff:
-            break;
-        case SYS_reboot:
-            break;
-        case SYS_sethostname:
-        {
-            BREAK(_SYS_sethostname(n, params));
-        }
-        case SYS_setdomainname:
-            break;
-        case SYS_iopl:
-            break;
-        case SYS_ioperm:
-            break;
-        case SYS_create_module:
-            break;
-        case SYS_init_module:
-            break;
-        case SYS_delete_module:
-            break;
-        case SYS_get_kernel_syms:
-            break;
-        case SYS_query_module:
-            break;
-        case SYS_quotactl:
-            break;
-        case SYS_nfsservctl:
-            break;
-        case SYS_getpmsg:
-            break;
-        case SYS_putpmsg:
-            break;
-        case SYS_afs_syscall:
-            break;
-        case SYS_tuxcall:
-            break;
-        case SYS_security:
-            break;
-        case SYS_gettid:
-        {
-            BREAK(_SYS_gettid(n, params));
-        }
-        case SYS_readahead:
-            break;
-        case SYS_setxattr:
-            break;
-        case SYS_lsetxattr:
-            break;
-        case SYS_fsetxattr:
-        {
-            BREAK(_SYS_fsetxattr(n, params));
-        }
-        case SYS_getxattr:
-            break;
-        case SYS_lgetxattr:
-            break;
-        case SYS_fgetxattr:
-            break;
-        case SYS_listxattr:
-            break;
-        case SYS_llistxattr:
-            break;
-        case SYS_flistxattr:
-            break;
-        case SYS_removexattr:
-            break;
-        case SYS_lremovexattr:
-            break;
-        case SYS_fremovexattr:
-            break;
-        case SYS_tkill:
-        {
-            BREAK(_SYS_tkill(n, params, process));
-        }
-        case SYS_time:
-        {
-            BREAK(_SYS_time(n, params));
-        }
-        case SYS_futex:
-        {
-            BREAK(_SYS_futex(n, params));
-        }
-        case SYS_sched_setaffinity:
-        {
-            BREAK(_SYS_sched_setaffinity(n, params));
-        }
-        case SYS_sched_getaffinity:
-        {
-            BREAK(_SYS_sched_getaffinity(n, params));
-        }
-        case SYS_set_thread_area:
-        {
-            BREAK(_SYS_set_thread_area(
-                n,
-                params,
-                &crt_td,
-                target_td,
-                thread,
-                &_set_thread_area_called));
-        }
-        case SYS_io_setup:
-            break;
-        case SYS_io_destroy:
-            break;
-        case SYS_io_getevents:
-            break;
-        case SYS_io_submit:
-            break;
-        case SYS_io_cancel:
-            break;
-        case SYS_get_thread_area:
-            break;
-        case SYS_lookup_dcookie:
-            break;
-        case SYS_epoll_create:
-        {
-            BREAK(_SYS_epoll_create(n, params));
-        }
-        case SYS_epoll_ctl_old:
-            break;
-        case SYS_epoll_wait_old:
-            break;
-        case SYS_remap_file_pages:
-            break;
-        case SYS_getdents64:
-        {
-            BREAK(_SYS_getdents64(n, params));
-        }
-        case SYS_set_tid_address:
-        {
-            BREAK(_SYS_set_tid_address(n, params));
-        }
-        case SYS_restart_syscall:
-            break;
-        case SYS_semtimedop:
-            break;
-        case SYS_fadvise64:
-        {
-            BREAK(_SYS_fadvise64(n, params));
-        }
-        case SYS_timer_create:
-            break;
-        case SYS_timer_settime:
-            break;
-        case SYS_timer_gettime:
-            break;
-        case SYS_timer_getoverrun:
-            break;
-        case SYS_timer_delete:
-            break;
-        case SYS_clock_settime:
-        {
-            BREAK(_SYS_clock_settime(n, params));
-        }
-        case SYS_clock_gettime:
-        {
-            /* this is handled in myst_syscall() */
-            break;
-        }
-        case SYS_clock_getres:
-        {
-            BREAK(_SYS_clock_getres(n, params));
-        }
-        case SYS_clock_nanosleep:
-            break;
-        case SYS_epoll_wait:
-        {
-            BREAK(_SYS_epoll_wait(n, params));
-        }
-        case SYS_epoll_ctl:
-        {
-            BREAK(_SYS_epoll_ctl(n, params));
-        }
-        case SYS_tgkill:
-        {
-            BREAK(_SYS_tgkill(n, params));
-        }
-        case SYS_utimes:
-            break;
-        case SYS_vserver:
-            break;
-        case SYS_mbind:
-        {
-            BREAK(_SYS_mbind(n, params));
-        }
-        case SYS_set_mempolicy:
-            break;
-        case SYS_get_mempolicy:
-            break;
-        case SYS_mq_open:
-            break;
-        case SYS_mq_unlink:
-            break;
-        case SYS_mq_timedsend:
-            break;
-        case SYS_mq_timedreceive:
-            break;
-        case SYS_mq_notify:
-            break;
-        case SYS_mq_getsetattr:
-            break;
-        case SYS_kexec_load:
-            break;
-        case SYS_waitid:
-        {
-            BREAK(_SYS_waitid(n, params));
-        }
-        case SYS_add_key:
-            break;
-        case SYS_request_key:
-            break;
-        case SYS_keyctl:
-            break;
-        case SYS_ioprio_set:
-            break;
-        case SYS_ioprio_get:
-            break;
-        case SYS_inotify_init:
-        {
-            BREAK(_SYS_inotify_init(n, params));
-        }
-        case SYS_inotify_add_watch:
-        {
-            BREAK(_SYS_inotify_add_watch(n, params));
-        }
-        case SYS_inotify_rm_watch:
-        {
-            BREAK(_SYS_inotify_rm_watch(n, params));
-        }
-        case SYS_migrate_pages:
-            break;
-        case SYS_openat:
-        {
-            BREAK(_SYS_openat(n, params));
-        }
-        case SYS_mkdirat:
-        {
-            BREAK(_SYS_mkdirat(n, params, process));
-        }
-        case SYS_mknodat:
-            break;
-        case SYS_futimesat:
-        {
-            BREAK(_SYS_futimesat(n, params));
-        }
-        case SYS_newfstatat:
-        {
-            BREAK(_SYS_newfstatat(n, params));
-        }
-        case SYS_unlinkat:
-        {
-            BREAK(_SYS_unlinkat(n, params));
-        }
-        case SYS_renameat:
-        {
-            BREAK(_SYS_renameat(n, params));
-        }
-        case SYS_linkat:
-        {
-            BREAK(_SYS_linkat(n, params));
-        }
-        case SYS_symlinkat:
-        {
-            BREAK(_SYS_symlinkat(n, params));
-        }
-        case SYS_readlinkat:
-        {
-            BREAK(_SYS_readlinkat(n, params));
-        }
-        case SYS_fchmodat:
-        {
-            BREAK(_SYS_fchmodat(n, params));
-        }
-        case SYS_faccessat:
-        {
-            BREAK(_SYS_faccessat(n, params));
-        }
-        case SYS_pselect6:
-            break;
-        case SYS_ppoll:
-        {
-            BREAK(_SYS_ppoll(n, params, process));
-        }
-        case SYS_unshare:
-            break;
-        case SYS_set_robust_list:
-        {
-            BREAK(_SYS_set_robust_list(n, params));
-        }
-        case SYS_get_robust_list:
-        {
-            BREAK(_SYS_get_robust_list(n, params));
-        }
-        case SYS_splice:
-            break;
-        case SYS_tee:
-            break;
-        case SYS_sync_file_range:
-            break;
-        case SYS_vmsplice:
-            break;
-        case SYS_move_pages:
-            break;
-        case SYS_utimensat:
-        {
-            BREAK(_SYS_utimensat(n, params));
-        }
-        case SYS_epoll_pwait:
-        {
-            BREAK(_SYS_epoll_pwait(n, params));
-        }
-        case SYS_signalfd:
-            break;
-        case SYS_timerfd_create:
-            break;
-        case SYS_eventfd:
-            break;
-        case SYS_fallocate:
-        {
-            BREAK(_SYS_fallocate(n, params));
-        }
-        case SYS_timerfd_settime:
-            break;
-        case SYS_timerfd_gettime:
-            break;
-        case SYS_accept4:
-        {
-            BREAK(_SYS_accept4(n, params));
-        }
-        case SYS_signalfd4:
-            break;
-        case SYS_eventfd2:
-        {
-            BREAK(_SYS_eventfd2(n, params));
-        }
-        case SYS_epoll_create1:
-        {
-            BREAK(_SYS_epoll_create1(n, params));
-        }
-        case SYS_pipe2:
-        {
-            BREAK(_SYS_pipe2(n, params));
-        }
-        case SYS_inotify_init1:
-        {
-            BREAK(_SYS_inotify_init1(n, params));
-        }
-        case SYS_preadv:
-        {
-            BREAK(_SYS_preadv(n, params));
-        }
-        case SYS_pwritev:
-        {
-            BREAK(_SYS_pwritev(n, params));
-        }
-        case SYS_rt_tgsigqueueinfo:
-            break;
-        case SYS_perf_event_open:
-            break;
-        case SYS_recvmmsg:
-        {
-            BREAK(_SYS_recvmmsg(n, params));
-        }
-        case SYS_fanotify_init:
-            break;
-        case SYS_fanotify_mark:
-            break;
-        case SYS_prlimit64:
-        {
-            BREAK(_SYS_prlimit64(n, params));
-        }
-        case SYS_name_to_handle_at:
-            break;
-        case SYS_open_by_handle_at:
-            break;
-        case SYS_clock_adjtime:
-            break;
-        case SYS_syncfs:
-            break;
-        case SYS_sendmmsg:
+        case SYS_sendmmsg:
         {
             BREAK(_SYS_sendmmsg(n, params, thread));
         }
-        case SYS_setns:
-            break;
-        case SYS_getcpu:
-        {
-            BREAK(_SYS_getcpu(n, params));
-        }
-        case SYS_process_vm_readv:
-            break;
-        case SYS_process_vm_writev:
-            break;
-        case SYS_kcmp:
-            break;
-        case SYS_finit_module:
-            break;
-        case SYS_sched_setattr:
-            break;
-        case SYS_sched_getattr:
-            break;
-        case SYS_renameat2:
-            break;
-        case SYS_seccomp:
-            break;
-        case SYS_getrandom:
-        {
-            BREAK(_SYS_getrandom(n, params));
-        }
-        case SYS_memfd_create:
-            break;
-        case SYS_kexec_file_load:
-            break;
-        case SYS_bpf:
-            break;
         case SYS_execveat:
         {
             BREAK(_SYS_execveat(n, params, thread, args));
         }
-        case SYS_userfaultfd:
-            break;
-        case SYS_membarrier:
-        {
-            BREAK(_SYS_membarrier(n, params));
-        }
-        case SYS_mlock2:
-            break;
-        case SYS_copy_file_range:
-        {
-            BREAK(_SYS_copy_file_range(n, params));
-        }
-        case SYS_preadv2:
-        {
-            BREAK(_SYS_preadv2(n, params));
-        }
-        case SYS_pwritev2:
-        {
-            BREAK(_SYS_pwritev2(n, params));
-        }
-        case SYS_pkey_mprotect:
-            break;
-        case SYS_pkey_alloc:
-            break;
-        case SYS_pkey_free:
-            break;
-        case SYS_statx:
-            break;
-        case SYS_io_pgetevents:
-            break;
-        case SYS_rseq:
-            break;
-        case SYS_bind:
-        {
-            BREAK(_SYS_bind(n, params));
-        }
-        case SYS_connect:
-        {
-            BREAK(_SYS_connect(n, params));
-        }
-        case SYS_recvfrom:
-        {
-            BREAK(_SYS_recvfrom(n, params));
-        }
         case SYS_sendto:
         {
             BREAK(_SYS_sendto(n, params, thread));
         }
-        case SYS_socket:
-        {
-            BREAK(_SYS_socket(n, params));
-        }
-        case SYS_accept:
-        {
-            BREAK(_SYS_accept(n, params));
-        }
         case SYS_sendmsg:
         {
             BREAK(_SYS_sendmsg(n, params, thread));
         }
-        case SYS_recvmsg:
-        {
-            BREAK(_SYS_recvmsg(n, params));
-        }
-        case SYS_shutdown:
-        {
-            BREAK(_SYS_shutdown(n, params));
-        }
-        case SYS_listen:
-        {
-            BREAK(_SYS_listen(n, params));
-        }
-        case SYS_getsockname:
-        {
-            BREAK(_SYS_getsockname(n, params));
-        }
-        case SYS_getpeername:
-        {
-            BREAK(_SYS_getpeername(n, params));
-        }
-        case SYS_socketpair:
-        {
-            BREAK(_SYS_socketpair(n, params));
-        }
-        case SYS_setsockopt:
-        {
-            BREAK(_SYS_setsockopt(n, params));
-        }
-        case SYS_getsockopt:
-        {
-            BREAK(_SYS_getsockopt(n, params));
-        }
-        case SYS_sendfile:
-        {
-            BREAK(_SYS_sendfile(n, params));
-        }
-        /* forward Open Enclave extensions to the target */
-        case SYS_myst_oe_get_report_v2:
-        case SYS_myst_oe_free_report:
-        case SYS_myst_oe_get_target_info_v2:
-        case SYS_myst_oe_free_target_info:
-        case SYS_myst_oe_parse_report:
-        case SYS_myst_oe_verify_report:
-        case SYS_myst_oe_get_seal_key_by_policy_v2:
-        case SYS_myst_oe_get_public_key_by_policy:
-        case SYS_myst_oe_get_public_key:
-        case SYS_myst_oe_get_private_key_by_policy:
-        case SYS_myst_oe_get_private_key:
-        case SYS_myst_oe_free_key:
-        case SYS_myst_oe_get_seal_key_v2:
-        case SYS_myst_oe_free_seal_key:
-        case SYS_myst_oe_generate_attestation_certificate:
-        case SYS_myst_oe_free_attestation_certificate:
-        case SYS_myst_oe_verify_attestation_certificate:
-        case SYS_myst_oe_result_str:
-        case SYS_myst_oe_get_enclave_start_address:
-        case SYS_myst_oe_get_enclave_base_address:
-        {
-            _strace(n, "forwarded");
-            BREAK(_return(n, _forward_syscall(n, params)));
-        }
         default:
-        {
-            if (__myst_kernel_args.unhandled_syscall_enosys == true)
-                syscall_ret = -ENOSYS;
-            else
-                myst_panic("unknown syscall: %s(): %ld", _syscall_str(n), n);
-        }
+            break;
     }
 
     if (__myst_kernel_args.unhandled_syscall_enosys == true)
         syscall_ret = -ENOSYS;
-    else
+    else if (myst_syscall_name(n))
         myst_panic("unhandled syscall: %s()", _syscall_str(n));
+    else
+        myst_panic("unknown syscall: %s(): %ld", _syscall_str(n), n);
 
 done:
 
@@ -7668,20 +6932,59 @@ done:
      * thread descriptor. */
     myst_signal_process(thread);
 
+    /* publish changes (e.g., credentials) once the C-runtime has the page */
+    if (thread->vdso.crt_td)
+        myst_update_vdso(thread);
+
     /* the C-runtime must execute on its own thread descriptor */
     if (crt_td)
         myst_set_fsbase(crt_td);
 
     myst_times_leave_kernel(n);
 
+    if (__myst_kernel_args.strace_config.binary)
+        myst_strace_record(n, params, syscall_ret);
+
+    if (__myst_kernel_args.trace_spans)
+    {
+        myst_span_record(
+            "syscall",
+            NULL,
+            n,
+            thread->enter_kernel_ticks,
+            thread->leave_kernel_ticks);
+    }
+
     return syscall_ret;
 }
 
+/* whether the syscall may skip the prologue and epilogue of _syscall() */
+static bool _is_fast_syscall(long n)
+{
+    if (n < 0 || n >= MYST_MAX_SYSCALLS)
+        return false;
+
+    if ((_syscall_table[n].flags & SYSCALL_FAST) != SYSCALL_FAST)
+        return false;
+
+    /* keep the syscalls visible to the tracers, which hook into _syscall() */
+    if (__myst_kernel_args.strace_config.trace_syscalls ||
+        __myst_kernel_args.strace_config.binary ||
+        __myst_kernel_args.trace_spans)
+    {
+        return false;
+    }
+
+    return true;
+}
+
 long myst_syscall(long n, long params[6])
 {
     long ret;
     uint64_t rsp;
-    myst_kstack_t* kstack;
+    myst_kstack_t* kstack = NULL;
+    myst_thread_t* thread = NULL;
+    uint64_t tsd = 0;
     void* saved_fs;
     void* base_fs;
 
@@ -7717,12 +7020,31 @@ long myst_syscall(long n, long params[6])
         return myst_syscall_arch_prctl(code, addr);
     }
 
+    /* Run syscalls that never wait and never leave the kernel on the caller's
+     * stack and thread descriptor. This skips the FS switch, the kernel stack,
+     * the thread descriptor switch, signal processing and the time accounting
+     * (the time spent counts as user time and is left out of the syscall
+     * latency histograms). */
+    if (_is_fast_syscall(n))
+        return _syscall_table[n].handler(n, params);
+
     /* Switch FS before myst_get_kstack, which could make OCALLs because of
      * myst_mmap and myst_mprotect */
     if (saved_fs != base_fs)
         myst_set_fsbase(base_fs);
 
-    if (!(kstack = myst_get_kstack()))
+    /* Use the kernel stack cached by this thread to avoid contending for the
+     * global free list. The thread may be unset during kernel startup. */
+    if (myst_tcall_get_tsd(&tsd) == 0 && tsd)
+    {
+        thread = (myst_thread_t*)tsd;
+
+        /* a nested syscall finds the cache empty and uses the free list */
+        if ((kstack = thread->kstack_cache))
+            thread->kstack_cache = NULL;
+    }
+
+    if (!kstack && !(kstack = myst_get_kstack()))
         myst_panic("no more kernel stacks");
 
     /* Restore FS */
@@ -7736,7 +7058,10 @@ long myst_syscall(long n, long params[6])
         .n = n, .params = params, .kstack = kstack, .user_rsp = rsp};
     ret = myst_call_on_stack(myst_kstack_end(kstack), _syscall, &args);
 
-    myst_put_kstack(kstack);
+    if (thread && !thread->kstack_cache)
+        thread->kstack_cache = kstack;
+    else
+        myst_put_kstack(kstack);
 
     return ret;
 }
@@ -7850,10 +7175,15 @@ long myst_syscall_tgkill(int tgid, int tid, int sig)
 {
     long ret = 0;
     myst_thread_t* thread = myst_thread_self();
-    myst_thread_t* target = myst_find_thread(tid);
-    siginfo_t* siginfo;
+    myst_thread_t* target = NULL;
+    siginfo_t* siginfo = NULL;
+
+    if (tid <= 0)
+        ERAISE(-EINVAL);
 
-    if (target == NULL)
+    /* delivery may block (see myst_futex_wake), so hold a reference to the
+     * target rather than myst_tid_hash_lock */
+    if (!(target = myst_get_thread(tid)))
         ERAISE(-ESRCH);
 
     // Only allow a thread to kill other threads in the same group.
@@ -7868,6 +7198,10 @@ long myst_syscall_tgkill(int tgid, int tid, int sig)
     myst_signal_deliver(target, sig, siginfo);
 
 done:
+
+    if (target)
+        myst_put_thread(target);
+
     return ret;
 }
 
@@ -7897,7 +7231,7 @@ long myst_syscall_kill(int pid, int signum)
     myst_process_t* process = myst_main_process;
     bool delivered_any = false;
 
-    myst_spin_lock(&myst_process_list_lock);
+    myst_rw_read_lock(&myst_process_list_lock);
 
     while (process)
     {
@@ -7947,7 +7281,7 @@ long myst_syscall_kill(int pid, int signum)
         ERAISE(-ESRCH);
 
 done:
-    myst_spin_unlock(&myst_process_list_lock);
+    myst_rw_read_unlock(&myst_process_list_lock);
 
     return ret;
 }
@@ -7970,6 +7304,16 @@ long myst_syscall_add_symbol_file(
 
     ECHECK(myst_load_file(path, &file_data, &file_size));
 
+    /* keep the function symbols for symbolizing the profiling samples */
+    if (__myst_kernel_args.profile)
+    {
+        ECHECK(myst_profile_add_symbol_file(
+            path, file_data, file_size, text, text_size));
+    }
+
+    if (!__myst_kernel_args.debug_symbols)
+        goto done;
+
     params[0] = (long)file_data;
     params[1] = (long)file_size;
     params[2] = (long)text;
@@ -8,6 +8,7 @@
 #include <myst/blockdevice.h>
 #include <myst/fsgs.h>
 #include <myst/luks.h>
+#include <myst/mnsched.h>
 #include <myst/sha256.h>
 #include <myst/signal.h>
 #include <myst/strings.h>
@@ -61,6 +62,9 @@ long myst_tcall_create_thread(uint64_t cookie)
 
 long myst_tcall_wait(uint64_t event, const struct timespec* timeout)
 {
+    if (myst_mn_is_event(event))
+        return myst_mn_wait(event, timeout);
+
     long params[6] = {0};
     params[0] = (long)event;
     params[1] = (long)timeout;
@@ -70,16 +74,62 @@ long myst_tcall_wait(uint64_t event, const struct timespec* timeout)
 
 long myst_tcall_wake(uint64_t event)
 {
+    if (myst_mn_is_event(event))
+        return myst_mn_wake(event);
+
     long params[6] = {0};
     params[0] = (long)event;
     return myst_tcall(MYST_TCALL_WAKE, params);
 }
 
+long myst_tcall_wake_many(const uint64_t* events, size_t count)
+{
+    /* the events may belong to multiplexed threads */
+    if (myst_mn_enabled())
+    {
+        long ret = 0;
+        long err = 0;
+
+        /* a failed wake must not leave the remaining waiters asleep */
+        for (size_t i = 0; i < count; i++)
+        {
+            long r;
+
+            if ((r = myst_tcall_wake(events[i])) < 0)
+            {
+                if (err == 0)
+                    err = r;
+            }
+            else
+            {
+                ret += r;
+            }
+        }
+
+        return err ? err : ret;
+    }
+
+    long params[6] = {0};
+    params[0] = (long)events;
+    params[1] = (long)count;
+    return myst_tcall(MYST_TCALL_WAKE_MANY, params);
+}
+
 long myst_tcall_wake_wait(
     uint64_t waiter_event,
     uint64_t self_event,
     const struct timespec* timeout)
 {
+    if (myst_mn_is_event(waiter_event) || myst_mn_is_event(self_event))
+    {
+        long ret;
+
+        if ((ret = myst_tcall_wake(waiter_event)) < 0 && ret != -EAGAIN)
+            return ret;
+
+        return myst_tcall_wait(self_event, timeout);
+    }
+
     long params[6] = {0};
     params[0] = (long)waiter_event;
     params[1] = (long)self_event;
@@ -279,6 +329,39 @@ long myst_tcall_write(int fd, const void* buf, size_t count)
     return myst_tcall(SYS_write, params);
 }
 
+long myst_tcall_readv(int fd, const struct iovec* iov, int iovcnt)
+{
+    long params[6] = {fd, (long)iov, iovcnt};
+    return myst_tcall(SYS_readv, params);
+}
+
+long myst_tcall_writev(int fd, const struct iovec* iov, int iovcnt)
+{
+    long params[6] = {fd, (long)iov, iovcnt};
+    return myst_tcall(SYS_writev, params);
+}
+
+/* the high word of the offset (params[4]) is zero on x86-64 */
+long myst_tcall_preadv(
+    int fd,
+    const struct iovec* iov,
+    int iovcnt,
+    off_t offset)
+{
+    long params[6] = {fd, (long)iov, iovcnt, offset};
+    return myst_tcall(SYS_preadv, params);
+}
+
+long myst_tcall_pwritev(
+    int fd,
+    const struct iovec* iov,
+    int iovcnt,
+    off_t offset)
+{
+    long params[6] = {fd, (long)iov, iovcnt, offset};
+    return myst_tcall(SYS_pwritev, params);
+}
+
 long myst_tcall_pipe2(int pipefd[2], int flags)
 {
     long params[6] = {(long)pipefd, flags};
@@ -356,6 +439,26 @@ ssize_t myst_tcall_recvmsg(int sockfd, struct msghdr* msg, int flags)
     return myst_tcall(SYS_recvmsg, params);
 }
 
+long myst_tcall_sendmmsg(
+    int sockfd,
+    struct mmsghdr* msgvec,
+    unsigned int vlen,
+    int flags)
+{
+    long params[6] = {(long)sockfd, (long)msgvec, (long)vlen, (long)flags};
+    return myst_tcall(SYS_sendmmsg, params);
+}
+
+long myst_tcall_recvmmsg(
+    int sockfd,
+    struct mmsghdr* msgvec,
+    unsigned int vlen,
+    int flags)
+{
+    long params[6] = {(long)sockfd, (long)msgvec, (long)vlen, (long)flags};
+    return myst_tcall(SYS_recvmmsg, params);
+}
+
 long myst_tcall_read_block(int fd, void* buf, size_t count)
 {
     long params[6] = {fd, (long)buf, count};
@@ -436,6 +539,26 @@ ssize_t myst_tcall_recvmsg_block(int sockfd, struct msghdr* msg, int flags)
     return myst_tcall(MYST_TCALL_RECVMSG_BLOCK, params);
 }
 
+long myst_tcall_sendmmsg_block(
+    int sockfd,
+    struct mmsghdr* msgvec,
+    unsigned int vlen,
+    int flags)
+{
+    long params[6] = {(long)sockfd, (long)msgvec, (long)vlen, (long)flags};
+    return myst_tcall(MYST_TCALL_SENDMMSG_BLOCK, params);
+}
+
+long myst_tcall_recvmmsg_block(
+    int sockfd,
+    struct mmsghdr* msgvec,
+    unsigned int vlen,
+    int flags)
+{
+    long params[6] = {(long)sockfd, (long)msgvec, (long)vlen, (long)flags};
+    return myst_tcall(MYST_TCALL_RECVMMSG_BLOCK, params);
+}
+
 long myst_tcall_td_set_exception_handler_stack(
     void* td,
     void* stack,
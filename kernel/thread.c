@@ -42,11 +42,35 @@
 
 //#define TRACE
 
-myst_spinlock_t myst_process_list_lock = MYST_SPINLOCK_INITIALIZER;
+myst_rwspinlock_t myst_process_list_lock = MYST_RWSPINLOCK_INITIALIZER;
 
 /* The total number of threads running (including the main thread) */
 static _Atomic(size_t) _num_threads = 1;
 
+/* The number of threads that run on a host thread of their own, i.e., all
+ * but the multiplexed ones (including the main thread) */
+static _Atomic(size_t) _num_host_threads = 1;
+
+/* Admit a thread that needs a host thread of its own. The max_threads kernel
+ * argument (also reported as RLIMIT_NPROC, see limit.c) bounds host threads,
+ * not application threads: with M:N scheduling, mn_threads host threads are
+ * set aside for the carriers and the multiplexed threads themselves count
+ * only against the scheduler's slots (see mnsched.c). */
+static bool _admit_host_thread(void)
+{
+    const size_t max = __myst_kernel_args.max_threads;
+    const size_t carriers =
+        myst_mn_enabled() ? __myst_kernel_args.mn_threads : 0;
+
+    if (++_num_host_threads + carriers > max)
+    {
+        _num_host_threads--;
+        return false;
+    }
+
+    return true;
+}
+
 /* Main top-level process. This process is the last process object to be
  * deleved. */
 myst_process_t* myst_main_process = 0;
@@ -82,6 +106,61 @@ pid_t myst_generate_tid(void)
     return tid;
 }
 
+/*
+**==============================================================================
+**
+** TID hash
+**
+**     Kernel-wide index of live threads by tid. Threads are inserted once
+**     their tid is assigned and removed (under the write lock) before they
+**     are freed, so a reader holding myst_tid_hash_lock may safely use the
+**     thread returned by myst_find_thread().
+**
+**==============================================================================
+*/
+
+#define TID_HASH_SIZE 1024
+
+myst_rwspinlock_t myst_tid_hash_lock = MYST_RWSPINLOCK_INITIALIZER;
+static myst_thread_t* _tid_hash[TID_HASH_SIZE];
+
+/* hash unsigned so that a negative tid cannot index outside the table */
+MYST_INLINE myst_thread_t** _tid_bucket(pid_t tid)
+{
+    return &_tid_hash[(uint32_t)tid % TID_HASH_SIZE];
+}
+
+void myst_tid_hash_insert(myst_thread_t* thread)
+{
+    /* tids are allocated sequentially so the low bits spread evenly */
+    myst_thread_t** head = _tid_bucket(thread->tid);
+
+    myst_rw_write_lock(&myst_tid_hash_lock);
+    thread->tid_hash_next = *head;
+    *head = thread;
+    myst_rw_write_unlock(&myst_tid_hash_lock);
+}
+
+void myst_tid_hash_remove(myst_thread_t* thread)
+{
+    myst_thread_t** p = _tid_bucket(thread->tid);
+
+    myst_rw_write_lock(&myst_tid_hash_lock);
+    {
+        for (; *p; p = &(*p)->tid_hash_next)
+        {
+            if (*p == thread)
+            {
+                *p = thread->tid_hash_next;
+                break;
+            }
+        }
+
+        thread->tid_hash_next = NULL;
+    }
+    myst_rw_write_unlock(&myst_tid_hash_lock);
+}
+
 /*
 **==============================================================================
 **
@@ -145,30 +224,71 @@ done:
 **         _get_cookie() -- assigns and returns a cookie for the new pointer.
 **         _put_cookie() -- deletes a cookie and returns the thread pointer.
 **
-**     Both operations are O(1)
+**     Both operations are O(1) and lock-free. The array is allocated on
+**     first use and sized from the max_threads kernel argument. Entries are
+**     first handed out from the unused tail of the array (_cookie_map_next)
+**     and afterwards from a free stack (_cookie_map_free). The top of the
+**     free stack packs a generation count (upper 32 bits) with a one-based
+**     index (lower 32 bits) so that a compare-and-swap cannot succeed with
+**     a stale top (the ABA problem).
 **
 **==============================================================================
 */
 
-#define MAX_COOKIE_MAP_ENTRIES (1024 + 256)
+/* minimum, slack, and maximum number of entries in the cookie map */
+#define MIN_COOKIE_MAP_ENTRIES (1024 + 256)
+#define COOKIE_MAP_SLACK 256
+#define MAX_COOKIE_MAP_ENTRIES (16 * 1024)
 
 typedef struct cookie_map_entry
 {
-    uint64_t cookie;
-    myst_thread_t* thread;
-    size_t next1; /* one-based next pointer */
+    volatile uint64_t cookie;
+    myst_thread_t* volatile thread;
+    volatile uint32_t next1; /* one-based next pointer */
 } cookie_map_entry_t;
 
-static cookie_map_entry_t _cookie_map[MAX_COOKIE_MAP_ENTRIES];
-static size_t _cookie_map_next;  /* next available entry */
-static size_t _cookie_map_free1; /* free list of cookie entries (one-based) */
-static myst_spinlock_t _cookie_map_lock;
+static cookie_map_entry_t* volatile _cookie_map;
+static size_t _cookie_map_size;
+static volatile uint32_t _cookie_map_next; /* next never-used entry */
+static volatile uint64_t _cookie_map_free; /* generation:next1 */
+
+static cookie_map_entry_t* _get_cookie_map(void)
+{
+    cookie_map_entry_t* map;
+    size_t n = __myst_kernel_args.max_threads;
+
+    if ((map = _cookie_map))
+        return map;
+
+    /* the Linux target passes an unlimited max_threads */
+    if (n > MAX_COOKIE_MAP_ENTRIES - COOKIE_MAP_SLACK)
+        n = MAX_COOKIE_MAP_ENTRIES;
+    else if ((n += COOKIE_MAP_SLACK) < MIN_COOKIE_MAP_ENTRIES)
+        n = MIN_COOKIE_MAP_ENTRIES;
+
+    if (!(map = calloc(n, sizeof(cookie_map_entry_t))))
+        myst_panic("out of memory");
+
+    /* set the size before publishing the map (the size never changes) */
+    _cookie_map_size = n;
+
+    /* another thread may have raced to allocate the map */
+    if (!__sync_bool_compare_and_swap(&_cookie_map, NULL, map))
+    {
+        free(map);
+        map = _cookie_map;
+    }
+
+    return map;
+}
 
 /* assign a cookie for the given thread pointer and return the cookie */
 static uint64_t _get_cookie(myst_thread_t* thread)
 {
+    cookie_map_entry_t* map = _get_cookie_map();
     uint32_t rand;
     uint64_t cookie;
+    uint32_t index;
 
     /* generate a random number (any value is fine except zero) */
     do
@@ -177,35 +297,49 @@ static uint64_t _get_cookie(myst_thread_t* thread)
             myst_panic("getrandom failed");
     } while (rand == 0);
 
-    /* add a new entry to the cookie map */
-    myst_spin_lock(&_cookie_map_lock);
+    /* take a never-used entry if any remain */
+    for (;;)
     {
-        uint32_t index;
+        const uint32_t next = _cookie_map_next;
 
-        if (_cookie_map_next < MAX_COOKIE_MAP_ENTRIES)
+        if (next >= _cookie_map_size)
         {
-            index = (uint32_t)_cookie_map_next++;
+            index = UINT32_MAX;
+            break;
         }
-        else if (_cookie_map_free1 != 0)
-        {
-            /* take first entry on the free list (adjust to zero-based) */
-            index = (uint32_t)(_cookie_map_free1 - 1);
 
-            /* remove this entry from the free list */
-            _cookie_map_free1 = _cookie_map[index].next1;
-        }
-        else
+        if (__sync_bool_compare_and_swap(&_cookie_map_next, next, next + 1))
         {
-            myst_panic("cookie map exhausted");
+            index = next;
+            break;
         }
+    }
+
+    /* else pop the top entry from the free stack */
+    while (index == UINT32_MAX)
+    {
+        const uint64_t top = _cookie_map_free;
+        const uint32_t top1 = (uint32_t)top;
+        uint64_t new_top;
 
-        cookie = ((uint64_t)index << 32) | (uint64_t)rand;
+        if (top1 == 0)
+            myst_panic("cookie map exhausted");
+
+        /* increment the generation and link to the next free entry */
+        new_top = ((top >> 32) + 1) << 32 | map[top1 - 1].next1;
 
-        _cookie_map[index].cookie = cookie;
-        _cookie_map[index].thread = thread;
-        _cookie_map[index].next1 = 0;
+        if (__sync_bool_compare_and_swap(&_cookie_map_free, top, new_top))
+            index = top1 - 1;
     }
-    myst_spin_unlock(&_cookie_map_lock);
+
+    cookie = ((uint64_t)index << 32) | (uint64_t)rand;
+
+    map[index].thread = thread;
+    map[index].next1 = 0;
+
+    /* publish the cookie last: _put_cookie() matches on it */
+    __sync_synchronize();
+    map[index].cookie = cookie;
 
     return cookie;
 }
@@ -213,6 +347,7 @@ static uint64_t _get_cookie(myst_thread_t* thread)
 /* fetch the cookie form the cookie map, while deleting the entry */
 static myst_thread_t* _put_cookie(uint64_t cookie)
 {
+    cookie_map_entry_t* map = _cookie_map;
     uint32_t index;
     myst_thread_t* thread = NULL;
 
@@ -224,29 +359,115 @@ static myst_thread_t* _put_cookie(uint64_t cookie)
     /* extract the index from the cookie */
     index = (uint32_t)((cookie & 0xffffffff00000000) >> 32);
 
-    myst_spin_lock(&_cookie_map_lock);
-    {
-        if (index >= _cookie_map_next)
-            myst_panic("bad cookie index");
+    if (!map || index >= _cookie_map_next)
+        myst_panic("bad cookie index");
+
+    /* claim the entry so that a replayed cookie cannot match it again */
+    thread = map[index].thread;
 
-        if (_cookie_map[index].cookie != cookie)
-            myst_panic("cookie mismatch");
+    if (!__sync_bool_compare_and_swap(&map[index].cookie, cookie, 0))
+        myst_panic("cookie mismatch");
 
-        thread = _cookie_map[index].thread;
+    map[index].thread = NULL;
+
+    /* push the entry onto the free stack */
+    for (;;)
+    {
+        const uint64_t top = _cookie_map_free;
+        const uint64_t new_top = ((top >> 32) + 1) << 32 | (index + 1);
 
-        /* clear the entry */
-        _cookie_map[index].cookie = 0;
-        _cookie_map[index].thread = NULL;
+        map[index].next1 = (uint32_t)top;
 
-        /* add the entry to the free list */
-        _cookie_map[index].next1 = _cookie_map_free1;
-        _cookie_map_free1 = index + 1;
+        if (__sync_bool_compare_and_swap(&_cookie_map_free, top, new_top))
+            break;
     }
-    myst_spin_unlock(&_cookie_map_lock);
 
     return thread;
 }
 
+/*
+**==============================================================================
+**
+** PID hash and children index:
+**
+**     Live and zombie processes are indexed by pid, and each process keeps a
+**     list of its children (live and zombie) so that wait() only visits the
+**     caller's own children. Lock with myst_process_list_lock.
+**
+**==============================================================================
+*/
+
+#define PID_HASH_SIZE 1024
+
+static myst_process_t* _pid_hash[PID_HASH_SIZE];
+
+/* hash unsigned so that a negative pid cannot index outside the table */
+MYST_INLINE myst_process_t** _pid_bucket(pid_t pid)
+{
+    return &_pid_hash[(uint32_t)pid % PID_HASH_SIZE];
+}
+
+void myst_pid_hash_insert(myst_process_t* process, myst_process_t* parent)
+{
+    myst_process_t** head = _pid_bucket(process->pid);
+
+    process->pid_hash_next = *head;
+    *head = process;
+
+    if ((process->parent = parent))
+    {
+        process->sibling_prev = NULL;
+        process->sibling_next = parent->children;
+
+        if (parent->children)
+            parent->children->sibling_prev = process;
+
+        parent->children = process;
+    }
+}
+
+/* remove a process that is about to be freed from the pid hash and from its
+ * parent's children and orphan its own children */
+static void _pid_hash_remove(myst_process_t* process)
+{
+    myst_process_t** p = _pid_bucket(process->pid);
+
+    for (; *p; p = &(*p)->pid_hash_next)
+    {
+        if (*p == process)
+        {
+            *p = process->pid_hash_next;
+            break;
+        }
+    }
+
+    if (process->parent)
+    {
+        if (process->sibling_prev)
+            process->sibling_prev->sibling_next = process->sibling_next;
+        else
+            process->parent->children = process->sibling_next;
+
+        if (process->sibling_next)
+            process->sibling_next->sibling_prev = process->sibling_prev;
+
+        process->parent = NULL;
+    }
+
+    for (myst_process_t* c = process->children; c;)
+    {
+        myst_process_t* next = c->sibling_next;
+
+        c->parent = NULL;
+        c->sibling_prev = NULL;
+        c->sibling_next = NULL;
+
+        c = next;
+    }
+
+    process->children = NULL;
+}
+
 /*
 **==============================================================================
 **
@@ -276,6 +497,7 @@ static void _free_zombies(void* arg)
     }
 
     _zombies_head = NULL;
+    memset(_pid_hash, 0, sizeof(_pid_hash));
 }
 
 void send_sigchld_to_parent(myst_process_t* process)
@@ -323,6 +545,7 @@ void myst_zombify_process(myst_process_t* process)
     }
 
     process->main_process_thread = NULL;
+    process->is_zombie = true;
 
     // remove from process list
     if (process->prev_process)
@@ -344,12 +567,12 @@ void myst_send_sigchld_and_zombify_process(myst_process_t* process)
     process->vfork_parent_tid = 0;
     process->vfork_parent_pid = 0;
 
-    myst_spin_lock(&myst_process_list_lock);
+    myst_rw_write_lock(&myst_process_list_lock);
     {
         send_sigchld_to_parent(process);
         myst_zombify_process(process);
     }
-    myst_spin_unlock(&myst_process_list_lock);
+    myst_rw_write_unlock(&myst_process_list_lock);
 
     /* If this process was created as part of a fork() and the parent is
      * running in wait-exec mode, signal that thread for wakeup */
@@ -561,22 +784,19 @@ long myst_wait(
     if (rusage)
         memset(rusage, 0, sizeof(*rusage));
 
-    /* If this is the only process then raise ECHILD */
-    if (process->next_process == NULL && process->prev_process == NULL &&
-        _zombies_head == NULL)
-    {
-        ERAISE(-ECHILD);
-    }
-
-    myst_spin_lock(&myst_process_list_lock);
+    myst_rw_write_lock(&myst_process_list_lock);
     locked = true;
 
+    /* If this process has no children then raise ECHILD */
+    if (process->children == NULL)
+        ERAISE(-ECHILD);
+
     for (;;)
     {
-        /* search the zombie list for a process thread */
-        for (p = _zombies_head; p; p = p->zombie_next)
+        /* search the children for a zombie process */
+        for (p = process->children; p; p = p->sibling_next)
         {
-            if (_wait_matcher("zombie", pid, process, p))
+            if (p->is_zombie && _wait_matcher("zombie", pid, process, p))
             {
                 if (wstatus)
                 {
@@ -645,6 +865,7 @@ long myst_wait(
                     myst_times_add_child_times_to_parent_times(process, p);
 
                     // free zombie process
+                    _pid_hash_remove(p);
                     free(p);
                 }
 
@@ -655,23 +876,15 @@ long myst_wait(
         if (options & WUNTRACED)
         {
             /* If we have a match and it is sleeping we can return */
-            p = process->prev_process;
-            while (p && !_wait_matcher("stopped", pid, process, p) &&
-                   (p->sigstop_futex == 0))
+            for (p = process->children; p; p = p->sibling_next)
             {
-                p = p->prev_process;
-            }
-            if (p == NULL)
-            {
-                // now processes right
-                p = process->next_process;
-                while (p && !_wait_matcher("stopped", pid, process, p) &&
-                       (p->sigstop_futex == 0))
+                if (!p->is_zombie && p->sigstop_futex == 1 &&
+                    _wait_matcher("stopped", pid, process, p))
                 {
-                    p = p->next_process;
+                    break;
                 }
             }
-            if (p != NULL && p->sigstop_futex == 1)
+            if (p != NULL)
             {
                 if (wstatus)
                 {
@@ -697,21 +910,10 @@ long myst_wait(
 
         /* no zombies found, but are there any running childred? If not then
          * ECHILD returned */
-
-        // first processes left
-        p = process->prev_process;
-        while (p && !_wait_matcher("active", pid, process, p))
-        {
-            p = p->prev_process;
-        }
-        if (p == NULL)
+        for (p = process->children; p; p = p->sibling_next)
         {
-            // now processes right
-            p = process->next_process;
-            while (p && !_wait_matcher("active", pid, process, p))
-            {
-                p = p->next_process;
-            }
+            if (!p->is_zombie && _wait_matcher("active", pid, process, p))
+                break;
         }
         if (p == NULL)
         {
@@ -760,10 +962,10 @@ long myst_wait(
                 process->pid);
         }
 #endif
-        myst_spin_unlock(&myst_process_list_lock);
+        myst_rw_write_unlock(&myst_process_list_lock);
         locked = false;
         myst_sleep_msec(100, true);
-        myst_spin_lock(&myst_process_list_lock);
+        myst_rw_write_lock(&myst_process_list_lock);
         locked = true;
 
         // current implementation does not cause all waiters to wake up
@@ -773,7 +975,7 @@ long myst_wait(
 done:
 
     if (locked)
-        myst_spin_unlock(&myst_process_list_lock);
+        myst_rw_write_unlock(&myst_process_list_lock);
 
 #ifdef TRACE
     printf("myst_waitpid() returning %ld\n", ret);
@@ -781,59 +983,59 @@ done:
     return ret;
 }
 
+// Caller should hold myst_tid_hash_lock (read) while using the result!
 myst_thread_t* myst_find_thread(int tid)
 {
-    myst_thread_t* thread = myst_thread_self();
-    myst_thread_t* target = NULL;
-    myst_thread_t* t = NULL;
+    myst_process_t* process = myst_process_self();
+    myst_thread_t* t;
 
-    myst_spin_lock(thread->thread_lock);
+    if (tid <= 0)
+        return NULL;
 
-    // Search forward in the doubly linked list for a match
-    for (t = thread; t != NULL; t = t->group_next)
+    for (t = *_tid_bucket(tid); t; t = t->tid_hash_next)
     {
+        /* only threads in the caller's thread group are visible */
         if (t->tid == tid)
-        {
-            target = t;
-            break;
-        }
+            return t->process == process ? t : NULL;
     }
 
-    if (target == NULL)
+    return NULL;
+}
+
+myst_thread_t* myst_get_thread(int tid)
+{
+    myst_thread_t* thread;
+
+    myst_rw_read_lock(&myst_tid_hash_lock);
     {
-        // Search backward in the doubly linked list for a match
-        for (t = thread->group_prev; t != NULL; t = t->group_prev)
-        {
-            if (t->tid == tid)
-            {
-                target = t;
-                break;
-            }
-        }
+        if ((thread = myst_find_thread(tid)))
+            __atomic_add_fetch(&thread->tid_hash_refs, 1, __ATOMIC_ACQ_REL);
     }
+    myst_rw_read_unlock(&myst_tid_hash_lock);
 
-    myst_spin_unlock(thread->thread_lock);
-    return target;
+    return thread;
+}
+
+void myst_put_thread(myst_thread_t* thread)
+{
+    __atomic_sub_fetch(&thread->tid_hash_refs, 1, __ATOMIC_ACQ_REL);
 }
 
 // Caller should hold myst_proces_list_lock!
 myst_process_t* myst_find_process_from_pid(pid_t pid, bool include_zombies)
 {
-    myst_process_t* p = NULL;
+    myst_process_t* p;
 
-    // Search forward in the doubly linked list for a match
-    p = myst_main_process;
-    while (p && p->pid != pid)
-        p = p->next_process;
+    if (pid <= 0)
+        return NULL;
 
-    if ((p == NULL) && include_zombies)
+    for (p = *_pid_bucket(pid); p; p = p->pid_hash_next)
     {
-        p = _zombies_head;
-        while (p && p->pid != pid)
-            p = p->zombie_next;
+        if (p->pid == pid)
+            return (include_zombies || !p->is_zombie) ? p : NULL;
     }
 
-    return p;
+    return NULL;
 }
 
 /* Find the thread that may be waiting for the fork-exec wait and wake it */
@@ -842,7 +1044,7 @@ void myst_fork_exec_futex_wake(pid_t pid, pid_t tid)
     myst_process_t* waiter_process = NULL;
     myst_thread_t* waiter_thread = NULL;
 
-    myst_spin_lock(&myst_process_list_lock);
+    myst_rw_read_lock(&myst_process_list_lock);
 
     waiter_process = myst_find_process_from_pid(pid, false);
 
@@ -873,7 +1075,7 @@ void myst_fork_exec_futex_wake(pid_t pid, pid_t tid)
     }
 
 done:
-    myst_spin_unlock(&myst_process_list_lock);
+    myst_rw_read_unlock(&myst_process_list_lock);
     return;
 }
 
@@ -1003,6 +1205,13 @@ static long _run_thread(void* arg_)
             thread->exec_kstack = NULL;
         }
 
+        /* release the kernel stack cached by myst_syscall() */
+        if (thread->kstack_cache)
+        {
+            myst_put_kstack(thread->kstack_cache);
+            thread->kstack_cache = NULL;
+        }
+
         if (is_child_thread)
         {
             /* Wake up any thread waiting on ctid */
@@ -1081,6 +1290,12 @@ static long _run_thread(void* arg_)
         {
             myst_assume(_num_threads > 1);
             _num_threads--;
+
+            if (!thread->mn.enabled)
+            {
+                myst_assume(_num_host_threads > 1);
+                _num_host_threads--;
+            }
         }
 
         /* Free up the thread unmap-on-exit for child threads. */
@@ -1119,7 +1334,20 @@ static long _run_thread(void* arg_)
             myst_spin_unlock(&process->thread_group_lock);
         }
 
+        myst_times_release_thread(thread);
+        myst_tid_hash_remove(thread);
+
+        /* no new references can be taken once the thread is off the hash;
+         * sleep (rather than spin) so that a multiplexed holder can run */
+        while (__atomic_load_n(&thread->tid_hash_refs, __ATOMIC_ACQUIRE))
+            myst_sleep_msec(1, false);
+
         myst_signal_free_siginfos(thread);
+
+        /* the carrier frees a multiplexed thread once off its stack */
+        if (thread->mn.enabled)
+            myst_mn_exit_thread(thread);
+
         free(thread);
 
         /* Return to target, which will exit this thread */
@@ -1154,6 +1382,12 @@ static long _run_thread(void* arg_)
     return 0;
 }
 
+long myst_enter_thread(myst_thread_t* thread, uint64_t event, pid_t target_tid)
+{
+    struct run_thread_arg arg = {thread, 0, event, target_tid};
+    return _run_thread(&arg);
+}
+
 long myst_run_thread(uint64_t cookie, uint64_t event, pid_t target_tid)
 {
     long ret = 0;
@@ -1162,6 +1396,10 @@ long myst_run_thread(uint64_t cookie, uint64_t event, pid_t target_tid)
     if (!(thread = _put_cookie(cookie)))
         ERAISE(-EINVAL);
 
+    /* this host thread becomes a carrier of multiplexed threads */
+    if (thread->mn.enabled)
+        return myst_mn_run_carrier(thread, event, target_tid);
+
     /* run the thread on the transient stack */
     struct run_thread_arg arg = {thread, cookie, event, target_tid};
     /* ATTN: We need to keep the entry stack for the myst_call_on_stack
@@ -1204,8 +1442,8 @@ static long _syscall_clone(
 
     /* Check whether the maximum number of threads has been reached */
     {
-        /* if too many threads already running */
-        if (_num_threads == __myst_kernel_args.max_threads)
+        /* multiplexed threads do not need their own host thread */
+        if (!myst_mn_enabled() && !_admit_host_thread())
             ERAISE(-EAGAIN);
 
         _num_threads++;
@@ -1255,6 +1493,18 @@ static long _syscall_clone(
         /* generate a thread id for this new thread and return on success*/
         new_thread->tid = myst_generate_tid();
         ret = new_thread->tid;
+        myst_tid_hash_insert(new_thread);
+    }
+
+    if (myst_mn_enabled())
+    {
+        bool need_carrier;
+
+        ECHECK(myst_mn_start_thread(new_thread, &need_carrier));
+
+        /* queued for an existing carrier */
+        if (!need_carrier)
+            goto done;
     }
 
     cookie = _get_cookie(new_thread);
@@ -1286,8 +1536,8 @@ static long _syscall_clone_vfork(
 
     /* Check whether the maximum number of threads has been reached */
     {
-        /* if too many threads already running */
-        if (_num_threads == __myst_kernel_args.max_threads)
+        /* the main thread of a process always has its own host thread */
+        if (!_admit_host_thread())
             ERAISE(-EAGAIN);
 
         _num_threads++;
@@ -1385,14 +1635,16 @@ static long _syscall_clone_vfork(
         parent_thread->fork_exec_futex_wait = 0;
 
         /* add this main process thread to the process linked list */
-        myst_spin_lock(&myst_process_list_lock);
+        myst_rw_write_lock(&myst_process_list_lock);
         child_process->next_process = parent_process->next_process;
         if (parent_process->next_process)
             parent_process->next_process->prev_process = child_process;
         child_process->prev_process = parent_process;
         parent_process->next_process = child_process;
-        myst_spin_unlock(&myst_process_list_lock);
+        myst_pid_hash_insert(child_process, parent_process);
+        myst_rw_write_unlock(&myst_process_list_lock);
         added_to_process_list = true;
+        myst_tid_hash_insert(child_thread);
 
         /* Create /proc/[pid]/fd directory for new process thread */
         ECHECK(procfs_pid_setup(child_process->pid));
@@ -1439,14 +1691,16 @@ done:
     {
         if (added_to_process_list)
         {
-            myst_spin_lock(&myst_process_list_lock);
+            myst_rw_write_lock(&myst_process_list_lock);
             if (child_process->prev_process)
                 child_process->prev_process->next_process =
                     child_process->next_process;
             if (child_process->next_process)
                 child_process->next_process->prev_process =
                     child_process->prev_process;
-            myst_spin_unlock(&myst_process_list_lock);
+            _pid_hash_remove(child_process);
+            myst_rw_write_unlock(&myst_process_list_lock);
+            myst_tid_hash_remove(child_thread);
         }
         if (child_process->cwd)
             free(child_process->cwd);
@@ -1483,6 +1737,26 @@ pid_t myst_gettid(void)
     return myst_thread_self()->tid;
 }
 
+void myst_update_vdso(myst_thread_t* thread)
+{
+    myst_vdso_t* vdso = &thread->vdso;
+
+    vdso->crt_td = thread->crt_td;
+    vdso->pid = thread->process->pid;
+    vdso->ppid = thread->process->ppid;
+
+    /* same as myst_gettid() */
+    if (__options.report_native_tids)
+        vdso->tid = thread->target_tid;
+    else
+        vdso->tid = thread->tid;
+
+    vdso->uid = thread->uid;
+    vdso->euid = thread->euid;
+    vdso->gid = thread->gid;
+    vdso->egid = thread->egid;
+}
+
 size_t myst_get_num_threads(void)
 {
     return _num_threads;
@@ -1490,24 +1764,19 @@ size_t myst_get_num_threads(void)
 
 bool myst_have_child_forked_processes(myst_process_t* process)
 {
-    pid_t pid = process->pid;
     myst_process_t* p;
 
     if (!process->is_parent_of_pseudo_fork_process)
         return false;
 
-    myst_spin_lock(&myst_process_list_lock);
-    p = process->next_process;
+    myst_rw_read_lock(&myst_process_list_lock);
 
-    while (p)
+    for (p = process->children; p; p = p->sibling_next)
     {
-        if ((p->ppid == pid) && (p->is_pseudo_fork_process))
-        {
+        if (!p->is_zombie && p->is_pseudo_fork_process)
             break;
-        }
-        p = p->next_process;
     }
-    myst_spin_unlock(&myst_process_list_lock);
+    myst_rw_read_unlock(&myst_process_list_lock);
 
     return p == NULL ? false : true;
 }
@@ -1520,28 +1789,16 @@ long kill_child_fork_processes(myst_process_t* process)
     if (!process->is_parent_of_pseudo_fork_process)
         return false;
 
-    myst_spin_lock(&myst_process_list_lock);
-    myst_process_t* p = process->prev_process;
-    pid_t pid = process->pid;
+    myst_rw_read_lock(&myst_process_list_lock);
 
     /* Send signal to all children that are forks of us */
-    while (p)
-    {
-        if ((p->ppid == pid) && (p->is_pseudo_fork_process))
-            myst_signal_deliver(p->main_process_thread, SIGHUP, NULL);
-        p = p->prev_process;
-    }
-
-    p = process->next_process;
-
-    while (p)
+    for (myst_process_t* p = process->children; p; p = p->sibling_next)
     {
-        if ((p->ppid == pid) && (p->is_pseudo_fork_process))
+        if (!p->is_zombie && p->is_pseudo_fork_process)
             myst_signal_deliver(p->main_process_thread, SIGHUP, NULL);
-        p = p->next_process;
     }
 
-    myst_spin_unlock(&myst_process_list_lock);
+    myst_rw_read_unlock(&myst_process_list_lock);
 
     return 0;
 }
@@ -1600,9 +1857,9 @@ size_t myst_kill_thread_group()
          * so lets do it again to be sure */
         if (process->fdtable)
         {
-            myst_spin_lock(&process->fdtable->lock);
+            myst_rw_read_lock(&process->fdtable->lock);
             myst_fdtable_interrupt(process->fdtable);
-            myst_spin_unlock(&process->fdtable->lock);
+            myst_rw_read_unlock(&process->fdtable->lock);
         }
 
         /* wait for all other threads except ours and the process thread to go
@@ -1661,67 +1918,33 @@ done:
 /* Send SIGHUP to child processes */
 int myst_send_sighup_child_processes(myst_process_t* process)
 {
-    pid_t pid = process->pid;
+    myst_rw_read_lock(&myst_process_list_lock);
 
-    myst_spin_lock(&myst_process_list_lock);
-
-    // first processes left
-    myst_process_t* p = process->prev_process;
-    while (p)
+    for (myst_process_t* p = process->children; p; p = p->sibling_next)
     {
-        if (p->ppid == pid)
+        if (!p->is_zombie)
             myst_signal_deliver(p->main_process_thread, SIGHUP, NULL);
-
-        p = p->prev_process;
     }
-
-    // now processes right
-    p = process->next_process;
-    while (p)
-    {
-        if (p->ppid == pid)
-            myst_signal_deliver(p->main_process_thread, SIGHUP, NULL);
-
-        p = p->next_process;
-    }
-    myst_spin_unlock(&myst_process_list_lock);
+    myst_rw_read_unlock(&myst_process_list_lock);
 
     return 0;
 }
 
 void myst_wait_on_child_processes(myst_process_t* process)
 {
-    pid_t pid = process->pid;
     myst_process_t* p;
 
     do
     {
-        myst_spin_lock(&myst_process_list_lock);
+        myst_rw_read_lock(&myst_process_list_lock);
 
-        // first processes left
-        p = process->prev_process;
-        while (p)
+        for (p = process->children; p; p = p->sibling_next)
         {
-            if (p->ppid == pid)
+            if (!p->is_zombie)
                 break;
-
-            p = p->prev_process;
-        }
-
-        if (p == NULL)
-        {
-            // now processes right
-            p = process->next_process;
-            while (p)
-            {
-                if (p->ppid == pid)
-                    break;
-
-                p = p->next_process;
-            }
         }
 
-        myst_spin_unlock(&myst_process_list_lock);
+        myst_rw_read_unlock(&myst_process_list_lock);
 
         if (p == NULL)
             break;
@@ -1740,6 +1963,11 @@ int myst_interrupt_thread(myst_thread_t* thread)
     if (!thread)
         ERAISE(-EINVAL);
 
+    /* a switched-out multiplexed thread is woken through its event; its
+     * carrier may be running another thread */
+    if (thread->mn.enabled && thread->mn.state != MYST_MN_RUNNING)
+        goto done;
+
     ECHECK(myst_tcall_interrupt_thread(thread->target_tid));
 
 done:
@@ -1,9 +1,11 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 
+#include <myst/mnsched.h>
 #include <myst/signal.h>
 #include <myst/syscall.h>
 #include <myst/tcall.h>
+#include <myst/thread.h>
 #include <myst/time.h>
 
 void myst_sleep_msec(uint64_t milliseconds, bool process_signals)
@@ -20,6 +22,23 @@ void myst_sleep_msec(uint64_t milliseconds, bool process_signals)
     params[0] = (long)req;
     params[1] = (long)NULL;
 
+    /* a multiplexed thread releases its carrier while sleeping */
+    if (myst_mn_enabled())
+    {
+        uint64_t tsd = 0;
+        myst_thread_t* thread;
+
+        if (myst_tcall_get_tsd(&tsd) == 0 && (thread = (myst_thread_t*)tsd) &&
+            thread->mn.enabled)
+        {
+            /* returns early if a signal is pending */
+            if (myst_mn_sleep(req, NULL) == -EINTR && process_signals)
+                myst_signal_process(thread);
+
+            return;
+        }
+    }
+
     while (myst_tcall(SYS_nanosleep, params) == -EINTR)
     {
         if (process_signals)
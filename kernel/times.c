@@ -10,6 +10,8 @@
 #include <myst/kernel.h>
 #include <myst/mmanutils.h>
 #include <myst/printf.h>
+#include <myst/spinlock.h>
+#include <myst/strings.h>
 #include <myst/syscall.h>
 #include <myst/thread.h>
 #include <myst/times.h>
@@ -21,13 +23,337 @@ struct tms process_times;
 
 bool __myst_trace_syscall_times = true;
 
-typedef struct syscall_time
+/*
+**==============================================================================
+**
+** syscall latency histograms:
+**
+**     Each thread records the latency of its syscalls in its own histograms,
+**     so recording needs no locks or atomics and touches no shared cache
+**     lines. Readers merge the histograms of all live threads with those of
+**     the exited ones. The counters of live threads are read without
+**     synchronization, so a merged result may be off by the syscalls that
+**     are being recorded at that moment.
+**
+**==============================================================================
+*/
+
+/* Linux syscalls plus the two ranges of Mystikos syscalls (see _slot()) */
+#define NUM_LINUX_SLOTS 512
+#define NUM_MYST_SLOTS 64
+#define NUM_SLOTS (NUM_LINUX_SLOTS + 2 * NUM_MYST_SLOTS)
+#define MYST_SLOTS_BASE1 1000
+#define MYST_SLOTS_BASE2 2000
+
+/* two buckets per power of two; the last one is open-ended (from ~3.2 secs) */
+#define NUM_BUCKETS 64
+
+typedef struct syscall_hist
 {
-    long nsec;
-    size_t ncalls;
-} syscall_time_t;
+    uint64_t ncalls;
+    uint64_t nsec;
+    uint64_t max;
+    uint32_t buckets[NUM_BUCKETS];
+} syscall_hist_t;
 
-static syscall_time_t _syscall_times[MYST_MAX_SYSCALLS];
+typedef struct myst_syscall_stats
+{
+    struct myst_syscall_stats* prev;
+    struct myst_syscall_stats* next;
+
+    /* allocated on the first call of each syscall */
+    syscall_hist_t* hists[NUM_SLOTS];
+} myst_syscall_stats_t;
+
+/* the statistics of live threads and the sum of those of exited threads */
+static myst_syscall_stats_t* _stats_list;
+static myst_syscall_stats_t _retired_stats;
+static myst_spinlock_t _stats_lock = MYST_SPINLOCK_INITIALIZER;
+
+static long _slot(long n)
+{
+    if (n >= 0 && n < NUM_LINUX_SLOTS)
+        return n;
+
+    if (n >= MYST_SLOTS_BASE1 && n < MYST_SLOTS_BASE1 + NUM_MYST_SLOTS)
+        return NUM_LINUX_SLOTS + (n - MYST_SLOTS_BASE1);
+
+    if (n >= MYST_SLOTS_BASE2 && n < MYST_SLOTS_BASE2 + NUM_MYST_SLOTS)
+        return NUM_LINUX_SLOTS + NUM_MYST_SLOTS + (n - MYST_SLOTS_BASE2);
+
+    return -1;
+}
+
+static long _slot_to_syscall(size_t slot)
+{
+    if (slot < NUM_LINUX_SLOTS)
+        return slot;
+
+    if (slot < NUM_LINUX_SLOTS + NUM_MYST_SLOTS)
+        return MYST_SLOTS_BASE1 + (slot - NUM_LINUX_SLOTS);
+
+    return MYST_SLOTS_BASE2 + (slot - NUM_LINUX_SLOTS - NUM_MYST_SLOTS);
+}
+
+static size_t _bucket(uint64_t nsec)
+{
+    size_t exp;
+    size_t bucket;
+
+    if (nsec < 4)
+        return nsec;
+
+    /* split [2^exp, 2^(exp+1)) in two halves */
+    exp = 63 - __builtin_clzl(nsec);
+    bucket = 2 * exp + ((nsec >> (exp - 1)) & 1);
+
+    return bucket < NUM_BUCKETS ? bucket : NUM_BUCKETS - 1;
+}
+
+/* the smallest latency above the given bucket */
+static uint64_t _bucket_limit(size_t bucket)
+{
+    const size_t next = bucket + 1;
+    const size_t exp = next / 2;
+
+    if (next < 4)
+        return next;
+
+    return (1UL << exp) | ((uint64_t)(next & 1) << (exp - 1));
+}
+
+static void _record_syscall_time(myst_thread_t* thread, long n, long nsec)
+{
+    myst_syscall_stats_t* stats = thread->syscall_stats;
+    syscall_hist_t* hist;
+    long slot;
+
+    if ((slot = _slot(n)) < 0)
+        return;
+
+    if (!stats)
+    {
+        if (!(stats = calloc(1, sizeof(myst_syscall_stats_t))))
+            return;
+
+        myst_spin_lock(&_stats_lock);
+        {
+            if ((stats->next = _stats_list))
+                _stats_list->prev = stats;
+            _stats_list = stats;
+        }
+        myst_spin_unlock(&_stats_lock);
+
+        thread->syscall_stats = stats;
+    }
+
+    if (!(hist = stats->hists[slot]))
+    {
+        if (!(hist = calloc(1, sizeof(syscall_hist_t))))
+            return;
+
+        stats->hists[slot] = hist;
+    }
+
+    hist->ncalls++;
+    hist->nsec += nsec;
+    hist->buckets[_bucket(nsec)]++;
+
+    if ((uint64_t)nsec > hist->max)
+        hist->max = nsec;
+}
+
+static void _add_hist(syscall_hist_t* dest, const syscall_hist_t* src)
+{
+    dest->ncalls += src->ncalls;
+    dest->nsec += src->nsec;
+
+    if (src->max > dest->max)
+        dest->max = src->max;
+
+    for (size_t i = 0; i < NUM_BUCKETS; i++)
+        dest->buckets[i] += src->buckets[i];
+}
+
+void myst_times_release_thread(myst_thread_t* thread)
+{
+    myst_syscall_stats_t* stats;
+
+    if (!(stats = thread->syscall_stats))
+        return;
+
+    thread->syscall_stats = NULL;
+
+    myst_spin_lock(&_stats_lock);
+    {
+        if (stats->prev)
+            stats->prev->next = stats->next;
+        else
+            _stats_list = stats->next;
+
+        if (stats->next)
+            stats->next->prev = stats->prev;
+
+        for (size_t i = 0; i < NUM_SLOTS; i++)
+        {
+            syscall_hist_t* hist = stats->hists[i];
+
+            if (!hist)
+                continue;
+
+            /* keep the histogram if this syscall has not been retired yet */
+            if (!_retired_stats.hists[i])
+                _retired_stats.hists[i] = hist;
+            else
+            {
+                _add_hist(_retired_stats.hists[i], hist);
+                free(hist);
+            }
+        }
+    }
+    myst_spin_unlock(&_stats_lock);
+
+    free(stats);
+}
+
+/* merge the histograms of all threads into an array of NUM_SLOTS elements */
+static syscall_hist_t* _merge_syscall_hists(void)
+{
+    syscall_hist_t* hists;
+
+    if (!(hists = calloc(NUM_SLOTS, sizeof(syscall_hist_t))))
+        return NULL;
+
+    myst_spin_lock(&_stats_lock);
+    {
+        for (size_t i = 0; i < NUM_SLOTS; i++)
+        {
+            if (_retired_stats.hists[i])
+                _add_hist(&hists[i], _retired_stats.hists[i]);
+        }
+
+        for (myst_syscall_stats_t* p = _stats_list; p; p = p->next)
+        {
+            for (size_t i = 0; i < NUM_SLOTS; i++)
+            {
+                if (p->hists[i])
+                    _add_hist(&hists[i], p->hists[i]);
+            }
+        }
+    }
+    myst_spin_unlock(&_stats_lock);
+
+    return hists;
+}
+
+/* the latency below which the given fraction of the calls completed */
+static uint64_t _percentile(const syscall_hist_t* hist, double fraction)
+{
+    const uint64_t target = (uint64_t)(fraction * (double)hist->ncalls);
+    uint64_t count = 0;
+
+    for (size_t i = 0; i < NUM_BUCKETS; i++)
+    {
+        if ((count += hist->buckets[i]) > target)
+        {
+            const uint64_t limit = _bucket_limit(i);
+            return limit < hist->max ? limit : hist->max;
+        }
+    }
+
+    return hist->max;
+}
+
+/* sort the nonempty slots in descending order of their total time */
+static size_t _sort_slots(const syscall_hist_t* hists, size_t* slots)
+{
+    size_t nslots = 0;
+
+    for (size_t i = 0; i < NUM_SLOTS; i++)
+    {
+        if (hists[i].ncalls)
+            slots[nslots++] = i;
+    }
+
+    /* insertion sort */
+    for (size_t i = 1; i < nslots; i++)
+    {
+        const size_t slot = slots[i];
+        size_t j = i;
+
+        for (; j > 0 && hists[slots[j - 1]].nsec < hists[slot].nsec; j--)
+            slots[j] = slots[j - 1];
+
+        slots[j] = slot;
+    }
+
+    return nslots;
+}
+
+int myst_format_syscall_times(myst_buf_t* buf)
+{
+    int ret = 0;
+    syscall_hist_t* hists = NULL;
+    size_t* slots = NULL;
+    size_t nslots;
+    char tmp[256];
+
+    if (!buf)
+        ERAISE(-EINVAL);
+
+    if (!(hists = _merge_syscall_hists()))
+        ERAISE(-ENOMEM);
+
+    if (!(slots = calloc(NUM_SLOTS, sizeof(size_t))))
+        ERAISE(-ENOMEM);
+
+    nslots = _sort_slots(hists, slots);
+
+    ECHECK(myst_snprintf(
+        tmp,
+        sizeof(tmp),
+        "%-28s %10s %14s %10s %10s %10s %12s\n",
+        "syscall",
+        "calls",
+        "total_ns",
+        "avg_ns",
+        "p50_ns",
+        "p99_ns",
+        "max_ns"));
+
+    if (myst_buf_append(buf, tmp, strlen(tmp)) < 0)
+        ERAISE(-ENOMEM);
+
+    for (size_t i = 0; i < nslots; i++)
+    {
+        const syscall_hist_t* p = &hists[slots[i]];
+
+        ECHECK(myst_snprintf(
+            tmp,
+            sizeof(tmp),
+            "%-28s %10lu %14lu %10lu %10lu %10lu %12lu\n",
+            myst_syscall_str(_slot_to_syscall(slots[i])),
+            p->ncalls,
+            p->nsec,
+            p->nsec / p->ncalls,
+            _percentile(p, 0.50),
+            _percentile(p, 0.99),
+            p->max));
+
+        if (myst_buf_append(buf, tmp, strlen(tmp)) < 0)
+            ERAISE(-ENOMEM);
+    }
+
+done:
+
+    if (hists)
+        free(hists);
+
+    if (slots)
+        free(slots);
+
+    return ret;
+}
 
 long myst_lapsed_nsecs(const struct timespec* t0, const struct timespec* t1)
 {
@@ -39,15 +365,106 @@ long myst_lapsed_nsecs(const struct timespec* t0, const struct timespec* t1)
     return (long)(t1_ns - t0_ns);
 }
 
-static bool is_zero_tp(struct timespec* tp)
+/*
+**==============================================================================
+**
+** kernel time accounting:
+**
+**     The user and system times are accounted in ticks, which are TSC cycles
+**     when the target can execute RDTSC (see myst_times_init()) and
+**     monotonic nanoseconds otherwise. Ticks are converted to nanoseconds
+**     only when the times are read, so that entering and leaving the kernel
+**     costs no clock reads.
+**
+**==============================================================================
+*/
+
+/* how long myst_times_init() measures the TSC against the monotonic clock */
+#define TSC_CALIBRATION_NSECS (10 * 1000 * 1000)
+
+/* nanoseconds per TSC cycle as a 32.32 fixed-point number (zero if unused) */
+static uint64_t _tsc_mult;
+
+MYST_INLINE uint64_t _rdtsc(void)
+{
+    uint32_t lo;
+    uint32_t hi;
+
+    __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static uint64_t _monotonic_nsecs(void)
+{
+    struct timespec ts;
+
+    myst_syscall_clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)timespec_to_nanos(&ts);
+}
+
+static uint64_t _now_ticks(void)
+{
+    if (_tsc_mult)
+        return _rdtsc();
+
+    return _monotonic_nsecs();
+}
+
+static long _ticks_to_nsecs(uint64_t ticks)
+{
+    if (_tsc_mult)
+        return (long)(((__uint128_t)ticks * _tsc_mult) >> 32);
+
+    return (long)ticks;
+}
+
+/* ticks elapsed from t0 to t1 (the TSCs of two cores may be slightly off) */
+static uint64_t _lapsed_ticks(uint64_t t0, uint64_t t1)
+{
+    return t1 > t0 ? t1 - t0 : 0;
+}
+
+uint64_t myst_times_ticks(void)
 {
-    return tp->tv_sec == 0 && tp->tv_nsec == 0;
+    return _now_ticks();
+}
+
+uint64_t myst_times_ticks_mult(void)
+{
+    return _tsc_mult;
+}
+
+void myst_times_init(void)
+{
+    uint64_t t0;
+    uint64_t t1;
+    uint64_t c0;
+    uint64_t c1;
+
+    /* RDTSC traps in SGX1 enclaves, which is slower than reading the clock */
+    if (!__myst_kernel_args.have_rdtsc_instruction)
+        return;
+
+    t0 = _monotonic_nsecs();
+    c0 = _rdtsc();
+
+    do
+    {
+        t1 = _monotonic_nsecs();
+    } while (t1 - t0 < TSC_CALIBRATION_NSECS);
+
+    c1 = _rdtsc();
+
+    if (c1 > c0)
+        _tsc_mult = (uint64_t)(((__uint128_t)(t1 - t0) << 32) / (c1 - c0));
 }
 
 void myst_times_start()
 {
     myst_thread_t* thread = myst_thread_self();
     myst_syscall_clock_gettime(CLOCK_MONOTONIC, &thread->start_ts);
+    thread->start_ticks = _now_ticks();
 }
 
 void myst_times_enter_kernel(long syscall_num)
@@ -57,47 +474,41 @@ void myst_times_enter_kernel(long syscall_num)
 
     (void)syscall_num;
 
-    myst_syscall_clock_gettime(CLOCK_MONOTONIC, &current->enter_kernel_ts);
+    current->enter_kernel_ticks = _now_ticks();
 
     // Thread might be entering the kernel for the first time
-    if (is_zero_tp(&current->leave_kernel_ts))
-        current->leave_kernel_ts = current->start_ts;
+    if (!current->leave_kernel_ticks)
+        current->leave_kernel_ticks = current->start_ticks;
 
-    long lapsed =
-        myst_lapsed_nsecs(&current->leave_kernel_ts, &current->enter_kernel_ts);
-    myst_assume(lapsed >= 0);
+    uint64_t lapsed = _lapsed_ticks(
+        current->leave_kernel_ticks, current->enter_kernel_ticks);
 
-    __atomic_fetch_add(&process_times.tms_utime, lapsed, __ATOMIC_SEQ_CST);
+    /* these are plain totals, so the adds need no ordering */
+    __atomic_fetch_add(&process_times.tms_utime, lapsed, __ATOMIC_RELAXED);
     __atomic_fetch_add(
-        &process->process_times.tms_utime, lapsed, __ATOMIC_SEQ_CST);
+        &process->process_times.tms_utime, lapsed, __ATOMIC_RELAXED);
 }
 
 void myst_times_leave_kernel(long syscall_num)
 {
     myst_thread_t* current = myst_thread_self();
-    myst_syscall_clock_gettime(CLOCK_MONOTONIC, &current->leave_kernel_ts);
 
-    long lapsed =
-        myst_lapsed_nsecs(&current->enter_kernel_ts, &current->leave_kernel_ts);
+    current->leave_kernel_ticks = _now_ticks();
 
-    if (__myst_trace_syscall_times)
-    {
-        _syscall_times[syscall_num].nsec += lapsed;
-        _syscall_times[syscall_num].ncalls++;
-    }
+    // Tolerate zero lapsed time on very fast syscalls.
+    uint64_t lapsed = _lapsed_ticks(
+        current->enter_kernel_ticks, current->leave_kernel_ticks);
 
-    // Tolerate zero lapsed time since enter_kernel_ts has been observed to be
-    // equal to leave_kernel_ts on occassion on very fast syscalls (when using
-    // the VSDO version of clock_gettime() on Linux).
-    myst_assume(lapsed >= 0);
+    if (__myst_trace_syscall_times)
+        _record_syscall_time(current, syscall_num, _ticks_to_nsecs(lapsed));
 
     if (lapsed)
     {
-        __atomic_fetch_add(&process_times.tms_stime, lapsed, __ATOMIC_SEQ_CST);
+        __atomic_fetch_add(&process_times.tms_stime, lapsed, __ATOMIC_RELAXED);
         __atomic_fetch_add(
             &myst_process_self()->process_times.tms_stime,
             lapsed,
-            __ATOMIC_SEQ_CST);
+            __ATOMIC_RELAXED);
     }
 }
 
@@ -105,25 +516,29 @@ void myst_times_process_times(myst_process_t* process, struct tms* tm)
 {
     if (tm)
     {
-        *tm = process->process_times;
+        tm->tms_utime = _ticks_to_nsecs(process->process_times.tms_utime);
+        tm->tms_stime = _ticks_to_nsecs(process->process_times.tms_stime);
+        tm->tms_cutime = _ticks_to_nsecs(process->process_times.tms_cutime);
+        tm->tms_cstime = _ticks_to_nsecs(process->process_times.tms_cstime);
     }
 }
 
 long myst_times_process_time(myst_process_t* process)
 {
-    return process->process_times.tms_stime + process->process_times.tms_utime +
-           process->process_times.tms_cstime +
-           process->process_times.tms_cutime;
+    return _ticks_to_nsecs(
+        process->process_times.tms_stime + process->process_times.tms_utime +
+        process->process_times.tms_cstime + process->process_times.tms_cutime);
 }
 
 long myst_times_thread_time(myst_thread_t* thread)
 {
-    return myst_lapsed_nsecs(&thread->start_ts, &thread->enter_kernel_ts);
+    return _ticks_to_nsecs(
+        _lapsed_ticks(thread->start_ticks, thread->enter_kernel_ticks));
 }
 
 long myst_times_uptime()
 {
-    return process_times.tms_stime + process_times.tms_utime;
+    return _ticks_to_nsecs(process_times.tms_stime + process_times.tms_utime);
 }
 
 long myst_times_get_cpu_clock_time(clockid_t clk_id, struct timespec* tp)
@@ -134,13 +549,24 @@ long myst_times_get_cpu_clock_time(clockid_t clk_id, struct timespec* tp)
     if (per_thread)
     {
         myst_thread_t* thread = myst_thread_self();
-        if (tid != thread->tid)
+        long nanos;
+
+        if (tid == thread->tid)
+            nanos = myst_times_thread_time(thread);
+        else
         {
-            thread = myst_find_thread(tid);
+            myst_rw_read_lock(&myst_tid_hash_lock);
+            {
+                if ((thread = myst_find_thread(tid)))
+                    nanos = myst_times_thread_time(thread);
+            }
+            myst_rw_read_unlock(&myst_tid_hash_lock);
+
             if (!thread)
                 return -EINVAL;
         }
-        nanos_to_timespec(tp, myst_times_thread_time(thread));
+
+        nanos_to_timespec(tp, nanos);
     }
     else
     {
@@ -181,27 +607,24 @@ static void _print_line(size_t nchars)
 
 void myst_print_syscall_times(const char* message, size_t count)
 {
-    typedef struct times
-    {
-        long num;
-        long nsec;
-        size_t ncalls;
-    } times_t;
-    size_t ntimes = 0;
-    struct locals
-    {
-        times_t times[MYST_MAX_SYSCALLS];
-    };
-    struct locals* locals = NULL;
+    syscall_hist_t* hists = NULL;
+    size_t* slots = NULL;
+    size_t nslots;
     double nsecs = 0;
     int nchars = 1;
-    static const char fmt[] = "%-*s %8.4lfsec %5.2lf%% %5.2lf%% (%zu calls)\n";
+    int name_width = 0;
+    static const char fmt[] =
+        "%-*s %8.4lfsec %5.2lf%% (%zu calls) p50=%.1lfus p99=%.1lfus "
+        "max=%.1lfus\n";
     double elapsed_secs = 0.0;
 
     if (!message || count == 0)
         return;
 
-    if (!(locals = malloc(sizeof(struct locals))))
+    if (!(hists = _merge_syscall_hists()))
+        goto done;
+
+    if (!(slots = calloc(NUM_SLOTS, sizeof(size_t))))
         goto done;
 
     /* calculate total elapsed time from boot */
@@ -218,74 +641,41 @@ void myst_print_syscall_times(const char* message, size_t count)
         }
     }
 
-    for (size_t i = 0; i < MYST_MAX_SYSCALLS; i++)
-    {
-        if (_syscall_times[i].nsec)
-        {
-            locals->times[ntimes].num = i;
-            locals->times[ntimes].nsec = _syscall_times[i].nsec;
-            locals->times[ntimes].ncalls = _syscall_times[i].ncalls;
-            nsecs += (double)_syscall_times[i].nsec;
-            ntimes++;
-        }
-    }
-
-    /* sort the times in desending order */
-    for (size_t i = 0; i < ntimes - 1; i++)
-    {
-        for (size_t j = 0; j < ntimes - 1; j++)
-        {
-            if (locals->times[j].nsec < locals->times[j + 1].nsec)
-            {
-                times_t tmp = locals->times[j];
-                locals->times[j] = locals->times[j + 1];
-                locals->times[j + 1] = tmp;
-            }
-        }
-    }
-
-    int name_width = 0;
-    int nsec_width = 0;
-    char buf[64];
+    nslots = _sort_slots(hists, slots);
 
-    /* find the longest syscall name */
-    for (size_t i = 0; i < ntimes; i++)
+    /* find the longest syscall name and the total time */
+    for (size_t i = 0; i < nslots; i++)
     {
-        const times_t* p = &locals->times[i];
-        const char* name = myst_syscall_str(p->num);
+        const char* name = myst_syscall_str(_slot_to_syscall(slots[i]));
         size_t len = strlen(name);
 
-        int n = snprintf(buf, sizeof(buf), "%ld", p->nsec);
-
-        if (n > nsec_width)
-            nsec_width = n;
-
         if (len > (size_t)name_width)
             name_width = len;
+
+        nsecs += (double)hists[slots[i]].nsec;
     }
 
-    if (ntimes > count)
-        ntimes = count;
+    if (nslots > count)
+        nslots = count;
 
     /* determine the longest printed line */
-    for (size_t i = 0; i < ntimes; i++)
+    for (size_t i = 0; i < nslots; i++)
     {
-        const times_t* p = &locals->times[i];
-        double percent = (p->nsec / nsecs) * 100.0;
-        const char* name = myst_syscall_str(p->num);
-        double percent2 = ((p->nsec / p->ncalls) / nsecs) * 100.0;
-        char buf[128];
+        const syscall_hist_t* p = &hists[slots[i]];
+        char buf[256];
 
         int n = snprintf(
             buf,
             sizeof(buf),
             fmt,
             name_width,
-            name,
+            myst_syscall_str(_slot_to_syscall(slots[i])),
             ((double)p->nsec / (double)NANO_IN_SECOND),
-            percent,
-            percent2,
-            p->ncalls);
+            (p->nsec / nsecs) * 100.0,
+            p->ncalls,
+            (double)_percentile(p, 0.50) / 1000.0,
+            (double)_percentile(p, 0.99) / 1000.0,
+            (double)p->max / 1000.0);
 
         /* don't count the newline */
         if (n > 1)
@@ -300,21 +690,20 @@ void myst_print_syscall_times(const char* message, size_t count)
     myst_eprintf("%s: %.4lf seconds elapsed\n", message, elapsed_secs);
     _print_line(nchars);
 
-    for (size_t i = 0; i < ntimes; i++)
+    for (size_t i = 0; i < nslots; i++)
     {
-        const times_t* p = &locals->times[i];
-        double percent = (p->nsec / nsecs) * 100.0;
-        const char* name = myst_syscall_str(p->num);
-        double percent2 = ((p->nsec / p->ncalls) / nsecs) * 100.0;
+        const syscall_hist_t* p = &hists[slots[i]];
 
         myst_eprintf(
             fmt,
             name_width,
-            name,
+            myst_syscall_str(_slot_to_syscall(slots[i])),
             ((double)p->nsec / (double)NANO_IN_SECOND),
-            percent,
-            percent2,
-            p->ncalls);
+            (p->nsec / nsecs) * 100.0,
+            p->ncalls,
+            (double)_percentile(p, 0.50) / 1000.0,
+            (double)_percentile(p, 0.99) / 1000.0,
+            (double)p->max / 1000.0);
     }
 
     myst_eprintf("\n");
@@ -323,6 +712,9 @@ void myst_print_syscall_times(const char* message, size_t count)
 
 done:
 
-    if (locals)
-        free(locals);
+    if (hists)
+        free(hists);
+
+    if (slots)
+        free(slots);
 }
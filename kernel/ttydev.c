@@ -13,7 +13,10 @@
 #include <myst/assume.h>
 #include <myst/eraise.h>
 #include <myst/id.h>
+#include <myst/kernel.h>
+#include <myst/spinlock.h>
 #include <myst/tcall.h>
+#include <myst/times.h>
 #include <myst/ttydev.h>
 
 #define MAGIC 0xc436d7e6
@@ -31,6 +34,223 @@ MYST_INLINE bool _valid_tty(const myst_tty_t* tty)
     return tty && tty->magic == MAGIC;
 }
 
+/*
+**==============================================================================
+**
+** console output buffering (see myst/ttydev.h):
+**
+**==============================================================================
+*/
+
+typedef struct console_buffer
+{
+    char* data;
+    size_t size;
+    size_t len;
+    uint64_t first; /* time (in ticks) of the oldest buffered write */
+} console_buffer_t;
+
+/* buffers of STDOUT_FILENO and STDERR_FILENO (index zero is unused) */
+static console_buffer_t _buffers[STDERR_FILENO + 1];
+
+/* the buffer that the flushing thread swaps in for the one it writes out */
+static char* _spare;
+
+/* Serializes access to the buffers. The locked regions only copy data or
+ * swap buffers; MYST_TCALL_WRITE_CONSOLE is performed after releasing the
+ * lock, so writers never spin while the target writes. */
+static myst_spinlock_t _buffers_lock;
+
+/* Set while a thread writes buffered output to the target. Only this thread
+ * writes to the console, so the output reaches the target in the order it was
+ * buffered, while the other threads keep appending to the buffers. The
+ * flushing thread never prints or blocks in the target (either would flush
+ * and so wait for itself). */
+static bool _flushing;
+
+volatile bool __myst_ttydev_pending;
+
+static int _alloc_buffer(int fd)
+{
+    int ret = 0;
+    const size_t size = __myst_kernel_args.console_buffer_size;
+    console_buffer_t* b = &_buffers[fd];
+
+    if (size == 0 || fd == STDIN_FILENO || b->data)
+        goto done;
+
+    if (!_spare && !(_spare = malloc(size)))
+        ERAISE(-ENOMEM);
+
+    if (!(b->data = malloc(size)))
+        ERAISE(-ENOMEM);
+
+    b->size = size;
+
+done:
+    return ret;
+}
+
+static uint64_t _lapsed_nsecs(uint64_t t0)
+{
+    const uint64_t t1 = myst_times_ticks();
+    const uint64_t mult = myst_times_ticks_mult();
+    const uint64_t lapsed = t1 > t0 ? t1 - t0 : 0;
+
+    /* the ticks are nanoseconds when there is no multiplier */
+    return mult ? (uint64_t)(((__uint128_t)lapsed * mult) >> 32) : lapsed;
+}
+
+/* called with _buffers_lock held */
+static void _update_pending_locked(void)
+{
+    /* output that is being written is still pending for myst_eprintf() */
+    __myst_ttydev_pending = _flushing || _buffers[STDOUT_FILENO].len ||
+                            _buffers[STDERR_FILENO].len;
+}
+
+static void _write_console(int fd, const char* data, size_t len)
+{
+    size_t off = 0;
+
+    while (off < len)
+    {
+        long n = myst_tcall_write_console(fd, data + off, len - off);
+
+        /* the output is dropped if the host fails to take it */
+        if (n <= 0)
+            break;
+
+        off += (size_t)n;
+    }
+}
+
+/* Become the flushing thread, waiting for the current one to finish. Called
+ * with _buffers_lock held, which is released while waiting. */
+static void _begin_flush_locked(void)
+{
+    while (_flushing)
+    {
+        myst_spin_unlock(&_buffers_lock);
+
+        while (__atomic_load_n(&_flushing, __ATOMIC_ACQUIRE))
+            __asm__ __volatile__("pause" : : : "memory");
+
+        myst_spin_lock(&_buffers_lock);
+    }
+
+    _flushing = true;
+    _update_pending_locked();
+}
+
+/* Write out the buffers until both are empty. Called by the flushing thread
+ * with _buffers_lock held, which is released while the target writes. At
+ * most one of the buffers holds data at a time (see _buffered_write()), so
+ * writing whichever is not empty keeps the two streams in order. */
+static void _drain_locked(void)
+{
+    for (;;)
+    {
+        int fd;
+        console_buffer_t* b;
+        char* data;
+        size_t len;
+
+        if (_buffers[STDOUT_FILENO].len)
+            fd = STDOUT_FILENO;
+        else if (_buffers[STDERR_FILENO].len)
+            fd = STDERR_FILENO;
+        else
+            break;
+
+        /* take the buffered data and let the writers continue in the spare */
+        b = &_buffers[fd];
+        data = b->data;
+        len = b->len;
+        b->data = _spare;
+        b->len = 0;
+
+        myst_spin_unlock(&_buffers_lock);
+        _write_console(fd, data, len);
+        myst_spin_lock(&_buffers_lock);
+
+        _spare = data;
+    }
+}
+
+/* Write out what was buffered meanwhile and stop being the flushing thread.
+ * Called with _buffers_lock held. */
+static void _end_flush_locked(void)
+{
+    _drain_locked();
+    __atomic_store_n(&_flushing, false, __ATOMIC_RELEASE);
+    _update_pending_locked();
+}
+
+/* Write all buffered output to the target. Called with _buffers_lock held;
+ * on return the buffers are empty and no other thread is writing. */
+static void _flush_locked(void)
+{
+    _begin_flush_locked();
+    _end_flush_locked();
+}
+
+void myst_ttydev_flush(void)
+{
+    myst_spin_lock(&_buffers_lock);
+    _flush_locked();
+    myst_spin_unlock(&_buffers_lock);
+}
+
+static ssize_t _buffered_write(int fd, const void* buf, size_t count)
+{
+    ssize_t ret = (ssize_t)count;
+    console_buffer_t* b = &_buffers[fd];
+    const int other = (fd == STDOUT_FILENO) ? STDERR_FILENO : STDOUT_FILENO;
+
+    myst_spin_lock(&_buffers_lock);
+
+    if (count >= b->size)
+    {
+        /* too large to be worth buffering: write it as the flushing thread,
+         * after the output that is already buffered */
+        _begin_flush_locked();
+        _drain_locked();
+
+        myst_spin_unlock(&_buffers_lock);
+        ret = myst_tcall_write_console(fd, buf, count);
+        myst_spin_lock(&_buffers_lock);
+
+        _end_flush_locked();
+        goto done;
+    }
+
+    /* keep the output of the two streams in order: only buffer while the
+     * other stream has nothing buffered */
+    if (_buffers[other].len || b->len + count > b->size)
+        _flush_locked();
+
+    if (b->len == 0)
+        b->first = myst_times_ticks();
+
+    memcpy(b->data + b->len, buf, count);
+    b->len += count;
+    __myst_ttydev_pending = true;
+
+    if ((__myst_kernel_args.console_isatty && memchr(buf, '\n', count)) ||
+        _lapsed_nsecs(b->first) >= MYST_TTYDEV_FLUSH_MSEC * 1000000UL)
+    {
+        /* a flushing thread writes out this data before it finishes */
+        if (!_flushing)
+            _flush_locked();
+    }
+
+done:
+    myst_spin_unlock(&_buffers_lock);
+
+    return ret;
+}
+
 static int _td_create(myst_ttydev_t* ttydev, int fd, myst_tty_t** tty_out)
 {
     int ret = 0;
@@ -51,6 +271,8 @@ static int _td_create(myst_ttydev_t* ttydev, int fd, myst_tty_t** tty_out)
         tty->fd = fd;
     }
 
+    ECHECK(_alloc_buffer(fd));
+
     *tty_out = tty;
     tty = NULL;
 
@@ -101,7 +323,10 @@ static ssize_t _td_write(
     if (count == 0)
         goto done;
 
-    ERAISE(myst_tcall_write_console(tty->fd, buf, count));
+    if (tty->fd != STDIN_FILENO && _buffers[tty->fd].data)
+        ERAISE(_buffered_write(tty->fd, buf, count));
+    else
+        ERAISE(myst_tcall_write_console(tty->fd, buf, count));
 done:
     return ret;
 }
@@ -1496,7 +1496,8 @@ static int _udsdev_close(myst_sockdev_t* dev, myst_sock_t* sock)
         if (_obj(sock)->peer)
         {
             _obj(sock)->peer->closed = true;
-            myst_cond_signal(&_obj(sock)->peer->cond, FUTEX_BITSET_MATCH_ANY);
+            myst_cond_broadcast(
+                &_obj(sock)->peer->cond, SIZE_MAX, FUTEX_BITSET_MATCH_ANY);
             _unref_sock(_obj(sock)->peer);
         }
     }
@@ -531,6 +531,12 @@ long myst_tcall(long n, long params[6])
             uint64_t event = (uint64_t)x1;
             return myst_tcall_wake(event);
         }
+        case MYST_TCALL_WAKE_MANY:
+        {
+            const uint64_t* events = (const uint64_t*)x1;
+            size_t count = (size_t)x2;
+            return myst_tcall_wake_many(events, count);
+        }
         case MYST_TCALL_WAKE_WAIT:
         {
             uint64_t waiter_event = (uint64_t)x1;
@@ -735,6 +741,8 @@ long myst_tcall(long n, long params[6])
         case SYS_dup:
         case SYS_pread64:
         case SYS_pwrite64:
+        case SYS_preadv:
+        case SYS_pwritev:
         case SYS_link:
         case SYS_linkat:
         case SYS_unlink:
@@ -762,6 +770,8 @@ long myst_tcall(long n, long params[6])
         case SYS_sendto:
         case SYS_sendmsg:
         case SYS_recvmsg:
+        case SYS_sendmmsg:
+        case SYS_recvmmsg:
         {
             return _forward_syscall(n, x1, x2, x3, x4, x5, x6);
         }
@@ -948,6 +958,50 @@ long myst_tcall(long n, long params[6])
             return myst_interruptible_syscall(
                 SYS_recvmsg, sockfd, POLLIN, retry, sockfd, msg, flags);
         }
+        case MYST_TCALL_SENDMMSG_BLOCK:
+        {
+            int sockfd = (int)x1;
+            struct mmsghdr* msgvec = (struct mmsghdr*)x2;
+            unsigned int vlen = (unsigned int)x3;
+            int flags = (int)x4;
+            bool retry = true;
+
+            /* Don't retry EAGAIN|EINPPROGRESS if this flag is present */
+            if ((flags & MSG_DONTWAIT))
+                retry = false;
+
+            return myst_interruptible_syscall(
+                SYS_sendmmsg,
+                sockfd,
+                POLLOUT,
+                retry,
+                sockfd,
+                msgvec,
+                vlen,
+                flags);
+        }
+        case MYST_TCALL_RECVMMSG_BLOCK:
+        {
+            int sockfd = (int)x1;
+            struct mmsghdr* msgvec = (struct mmsghdr*)x2;
+            unsigned int vlen = (unsigned int)x3;
+            int flags = (int)x4;
+            bool retry = true;
+
+            /* Don't retry EAGAIN|EINPPROGRESS if these flags are present */
+            if ((flags & (MSG_ERRQUEUE | MSG_DONTWAIT)))
+                retry = false;
+
+            return myst_interruptible_syscall(
+                SYS_recvmmsg,
+                sockfd,
+                POLLIN,
+                retry,
+                sockfd,
+                msgvec,
+                vlen,
+                flags);
+        }
         default:
         {
             fprintf(stderr, "unhandled tcall: %ld\n", n);
@@ -186,6 +186,16 @@ long myst_tcall_wake(uint64_t event)
     return -ENOTSUP;
 }
 
+/* Must be overriden by enclave application */
+MYST_WEAK
+long myst_tcall_wake_many(const uint64_t* events, size_t count)
+{
+    (void)events;
+    (void)count;
+    assert("sgx: unimplemented: implement in enclave" == NULL);
+    return -ENOTSUP;
+}
+
 /* Must be overriden by enclave application */
 MYST_WEAK
 long myst_tcall_wake_wait(
@@ -428,6 +438,12 @@ long myst_tcall(long n, long params[6])
             uint64_t event = (uint64_t)x1;
             return myst_tcall_wake(event);
         }
+        case MYST_TCALL_WAKE_MANY:
+        {
+            const uint64_t* events = (const uint64_t*)x1;
+            size_t count = (size_t)x2;
+            return myst_tcall_wake_many(events, count);
+        }
         case MYST_TCALL_WAKE_WAIT:
         {
             uint64_t waiter_event = (uint64_t)x1;
@@ -564,6 +580,8 @@ long myst_tcall(long n, long params[6])
         }
         case SYS_read:
         case SYS_write:
+        case SYS_readv:
+        case SYS_writev:
         case SYS_close:
         case SYS_nanosleep:
         case SYS_fcntl:
@@ -576,6 +594,8 @@ long myst_tcall(long n, long params[6])
         case SYS_accept4:
         case SYS_sendmsg:
         case SYS_recvmsg:
+        case SYS_sendmmsg:
+        case SYS_recvmmsg:
         case SYS_shutdown:
         case SYS_listen:
         case SYS_getsockname:
@@ -595,6 +615,8 @@ long myst_tcall(long n, long params[6])
         case SYS_dup:
         case SYS_pread64:
         case SYS_pwrite64:
+        case SYS_preadv:
+        case SYS_pwritev:
         case SYS_link:
         case SYS_linkat:
         case SYS_unlink:
@@ -634,6 +656,8 @@ long myst_tcall(long n, long params[6])
         case MYST_TCALL_RECVFROM_BLOCK:
         case MYST_TCALL_SENDMSG_BLOCK:
         case MYST_TCALL_RECVMSG_BLOCK:
+        case MYST_TCALL_SENDMMSG_BLOCK:
+        case MYST_TCALL_RECVMMSG_BLOCK:
         {
             extern long myst_handle_tcall(long n, long params[6]);
             return myst_handle_tcall(n, params);
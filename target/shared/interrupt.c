@@ -88,6 +88,20 @@ long myst_interruptible_syscall(long n, int fd, short events, bool retry, ...)
                     syscall_ret = recvmsg((int)a, (void*)b, (int)c);
                     break;
                 }
+                case SYS_sendmmsg:
+                {
+                    syscall_ret =
+                        sendmmsg((int)a, (void*)b, (unsigned int)c, (int)d);
+                    break;
+                }
+                case SYS_recvmmsg:
+                {
+                    /* the host socket is non-blocking, so a receive timeout
+                     * would have no effect */
+                    syscall_ret = recvmmsg(
+                        (int)a, (void*)b, (unsigned int)c, (int)d, NULL);
+                    break;
+                }
                 case SYS_sendto:
                 {
                     syscall_ret = sendto(
@@ -57,6 +57,33 @@ long myst_tcall_wake(uint64_t event)
     return ret;
 }
 
+long myst_tcall_wake_many(const uint64_t* events, size_t count)
+{
+    long ret = 0;
+    long err = 0;
+
+    if (!events && count)
+        return -EINVAL;
+
+    /* a failed wake must not leave the remaining waiters asleep */
+    for (size_t i = 0; i < count; i++)
+    {
+        long r;
+
+        if ((r = myst_tcall_wake(events[i])) < 0)
+        {
+            if (err == 0)
+                err = r;
+        }
+        else
+        {
+            ret += r;
+        }
+    }
+
+    return err ? err : ret;
+}
+
 long myst_tcall_wake_wait(
     uint64_t waiter_event,
     uint64_t self_event,
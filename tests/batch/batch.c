@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <myst/syscallext.h>
+
+#define DEFAULT_ITERATIONS 10000
+#define BATCH_SIZE 16
+
+static size_t _iterations = DEFAULT_ITERATIONS;
+
+static uint64_t _nanos(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000UL + (uint64_t)ts.tv_nsec;
+}
+
+static long _batch(myst_batch_entry_t* entries, size_t count, int flags)
+{
+    return syscall(SYS_myst_batch, entries, count, flags);
+}
+
+static void _set(myst_batch_entry_t* e, long n, long a0, long a1, long a2)
+{
+    memset(e, 0, sizeof(myst_batch_entry_t));
+    e->n = n;
+    e->params[0] = a0;
+    e->params[1] = a1;
+    e->params[2] = a2;
+}
+
+static void _test_basic(void)
+{
+    myst_batch_entry_t e[3];
+    struct stat st;
+    int fd;
+
+    assert((fd = open("/", O_RDONLY | O_DIRECTORY)) >= 0);
+
+    _set(&e[0], SYS_fstat, fd, (long)&st, 0);
+    _set(&e[1], SYS_fcntl, fd, F_SETFD, FD_CLOEXEC);
+    _set(&e[2], SYS_fcntl, fd, F_GETFD, 0);
+
+    assert(_batch(e, 3, 0) == 3);
+    assert(e[0].ret == 0);
+    assert(S_ISDIR(st.st_mode));
+    assert(e[1].ret == 0);
+    assert(e[2].ret == FD_CLOEXEC);
+
+    /* empty batches are allowed */
+    assert(_batch(NULL, 0, 0) == 0);
+
+    assert(close(fd) == 0);
+    printf("=== passed test (%s)\n", __FUNCTION__);
+}
+
+static void _test_errors(void)
+{
+    myst_batch_entry_t e[4];
+    struct stat st;
+
+    /* a failed entry does not stop the batch by default */
+    _set(&e[0], SYS_fstat, -1, (long)&st, 0);
+    _set(&e[1], SYS_fstat, STDIN_FILENO, (long)&st, 0);
+    assert(_batch(e, 2, 0) == 2);
+    assert(e[0].ret == -EBADF);
+    assert(e[1].ret == 0);
+
+    /* ... unless asked to */
+    _set(&e[0], SYS_fstat, STDIN_FILENO, (long)&st, 0);
+    _set(&e[1], SYS_fstat, -1, (long)&st, 0);
+    _set(&e[2], SYS_fstat, STDIN_FILENO, (long)&st, 0);
+    assert(_batch(e, 3, MYST_BATCH_STOP_ON_ERROR) == 2);
+    assert(e[0].ret == 0);
+    assert(e[1].ret == -EBADF);
+    assert(e[2].ret == -ECANCELED);
+
+    /* a failed linked entry cancels the rest of its chain only */
+    _set(&e[0], SYS_fstat, -1, (long)&st, 0);
+    e[0].flags = MYST_BATCH_LINK;
+    _set(&e[1], SYS_fstat, STDIN_FILENO, (long)&st, 0);
+    e[1].flags = MYST_BATCH_LINK;
+    _set(&e[2], SYS_fstat, STDIN_FILENO, (long)&st, 0);
+    _set(&e[3], SYS_fstat, STDIN_FILENO, (long)&st, 0);
+    assert(_batch(e, 4, 0) == 4);
+    assert(e[0].ret == -EBADF);
+    assert(e[1].ret == -ECANCELED);
+    assert(e[2].ret == -ECANCELED);
+    assert(e[3].ret == 0);
+
+    /* syscalls that need the calling thread's state cannot be batched */
+    _set(&e[0], SYS_mmap, 0, 4096, 0);
+    _set(&e[1], SYS_myst_batch, 0, 0, 0);
+    assert(_batch(e, 2, 0) == 2);
+    assert(e[0].ret == -ENOSYS);
+    assert(e[1].ret == -ENOSYS);
+
+    assert(_batch(e, MYST_BATCH_MAX + 1, 0) == -1 && errno == EINVAL);
+    assert(_batch(e, 1, 0x100) == -1 && errno == EINVAL);
+    assert(_batch(NULL, 1, 0) == -1 && errno == EFAULT);
+
+    printf("=== passed test (%s)\n", __FUNCTION__);
+}
+
+static void _bench(void)
+{
+    myst_batch_entry_t e[BATCH_SIZE];
+    struct stat st;
+    uint64_t start;
+    double single;
+    double batched;
+
+    start = _nanos();
+    for (size_t i = 0; i < _iterations; i++)
+    {
+        for (size_t j = 0; j < BATCH_SIZE; j++)
+            assert(fstat(STDIN_FILENO, &st) == 0);
+    }
+    single = (double)(_nanos() - start);
+
+    start = _nanos();
+    for (size_t i = 0; i < _iterations; i++)
+    {
+        for (size_t j = 0; j < BATCH_SIZE; j++)
+            _set(&e[j], SYS_fstat, STDIN_FILENO, (long)&st, 0);
+
+        assert(_batch(e, BATCH_SIZE, MYST_BATCH_STOP_ON_ERROR) == BATCH_SIZE);
+    }
+    batched = (double)(_nanos() - start);
+
+    printf(
+        "fstat x %d: ns/call single=%.1f batched=%.1f\n",
+        BATCH_SIZE,
+        single / (double)(_iterations * BATCH_SIZE),
+        batched / (double)(_iterations * BATCH_SIZE));
+}
+
+int main(int argc, const char* argv[])
+{
+    if (argc == 2)
+        _iterations = strtoul(argv[1], NULL, 10);
+
+    _test_basic();
+    _test_errors();
+    _bench();
+
+    printf("=== passed test (%s)\n", argv[0]);
+
+    return 0;
+}
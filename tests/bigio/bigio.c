@@ -0,0 +1,205 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <arpa/inet.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mount.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_CHUNK_SIZE (1024 * 1024)
+static size_t _total;
+static const size_t _chunk_sizes[] = {4096, 65536, MAX_CHUNK_SIZE};
+
+static uint64_t _nanos(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000UL + (uint64_t)ts.tv_nsec;
+}
+
+static void _report(const char* what, size_t chunk, uint64_t elapsed)
+{
+    printf(
+        "%s: chunk=%7zu bytes=%zu MB/sec=%.1f\n",
+        what,
+        chunk,
+        _total,
+        ((double)_total / (1024.0 * 1024.0)) / ((double)elapsed / 1e9));
+}
+
+typedef struct reader_args
+{
+    int sock;
+    size_t chunk;
+} reader_args_t;
+
+static void* _reader(void* arg)
+{
+    reader_args_t* args = arg;
+    uint8_t* buf;
+    size_t n = 0;
+    uint8_t expect = 0;
+
+    assert((buf = malloc(args->chunk)));
+
+    while (n < _total)
+    {
+        ssize_t r = read(args->sock, buf, args->chunk);
+        assert(r > 0);
+
+        /* the writer sends the bytes 0, 1, 2, ... 255, 0, 1, ... */
+        for (ssize_t i = 0; i < r; i++)
+            assert(buf[i] == expect++);
+
+        n += (size_t)r;
+    }
+
+    free(buf);
+    return NULL;
+}
+
+static void _fill(uint8_t* buf, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+        buf[i] = (uint8_t)i;
+}
+
+/* stream _total bytes over a loopback TCP connection (host sockets) */
+static void _bench_socket(size_t chunk)
+{
+    int lsock;
+    int sock;
+    struct sockaddr_in addr;
+    socklen_t addrlen = sizeof(addr);
+    reader_args_t args = {.chunk = chunk};
+    pthread_t thread;
+    uint8_t* buf;
+    uint64_t start;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    assert((lsock = socket(AF_INET, SOCK_STREAM, 0)) >= 0);
+    assert(bind(lsock, (struct sockaddr*)&addr, sizeof(addr)) == 0);
+    assert(listen(lsock, 1) == 0);
+    assert(getsockname(lsock, (struct sockaddr*)&addr, &addrlen) == 0);
+
+    assert((sock = socket(AF_INET, SOCK_STREAM, 0)) >= 0);
+    assert(connect(sock, (struct sockaddr*)&addr, sizeof(addr)) == 0);
+    assert((args.sock = accept(lsock, NULL, NULL)) >= 0);
+
+    assert((buf = malloc(chunk)));
+    _fill(buf, chunk);
+
+    start = _nanos();
+    assert(pthread_create(&thread, NULL, _reader, &args) == 0);
+
+    for (size_t n = 0; n < _total;)
+    {
+        /* resume the byte pattern after a partial write (the chunk size is
+         * a multiple of 256) */
+        size_t off = n % 256;
+        size_t len = chunk - off;
+        ssize_t r;
+
+        if (len > _total - n)
+            len = _total - n;
+
+        assert((r = write(sock, buf + off, len)) > 0);
+        n += (size_t)r;
+    }
+
+    assert(pthread_join(thread, NULL) == 0);
+    _report("socket", chunk, _nanos() - start);
+
+    free(buf);
+    close(sock);
+    close(args.sock);
+    close(lsock);
+}
+
+/* write and read back a file of _total bytes on the host file system */
+static void _bench_file(const char* path, size_t chunk)
+{
+    int fd;
+    uint8_t* buf;
+    uint64_t start;
+
+    assert((buf = malloc(chunk)));
+    _fill(buf, chunk);
+
+    start = _nanos();
+    assert((fd = open(path, O_CREAT | O_TRUNC | O_WRONLY, 0666)) >= 0);
+
+    for (size_t n = 0; n < _total; n += chunk)
+        assert(write(fd, buf, chunk) == (ssize_t)chunk);
+
+    assert(close(fd) == 0);
+    _report("file write", chunk, _nanos() - start);
+
+    start = _nanos();
+    assert((fd = open(path, O_RDONLY)) >= 0);
+
+    for (size_t n = 0; n < _total; n += chunk)
+    {
+        memset(buf, 0, chunk);
+        assert(read(fd, buf, chunk) == (ssize_t)chunk);
+        assert(buf[chunk - 1] == (uint8_t)(chunk - 1));
+    }
+
+    assert(read(fd, buf, chunk) == 0);
+    assert(close(fd) == 0);
+    _report("file read", chunk, _nanos() - start);
+
+    assert(unlink(path) == 0);
+    free(buf);
+}
+
+int main(int argc, const char* argv[])
+{
+    const size_t nchunks = sizeof(_chunk_sizes) / sizeof(_chunk_sizes[0]);
+    const char* hostdir = NULL;
+
+    if (argc < 2 || argc > 3)
+    {
+        fprintf(stderr, "Usage: %s total-bytes [host-directory]\n", argv[0]);
+        exit(1);
+    }
+
+    /* a multiple of the largest chunk, so every read and write is whole */
+    _total = strtoul(argv[1], NULL, 10);
+    _total = (_total + MAX_CHUNK_SIZE - 1) / MAX_CHUNK_SIZE * MAX_CHUNK_SIZE;
+
+    if (argc == 3)
+        hostdir = argv[2];
+
+    for (size_t i = 0; i < nchunks; i++)
+        _bench_socket(_chunk_sizes[i]);
+
+    if (hostdir)
+    {
+        assert(mkdir("/mnt", 0777) == 0);
+        assert(mkdir("/mnt/host", 0777) == 0);
+        assert(mount(hostdir, "/mnt/host", "hostfs", 0, NULL) == 0);
+
+        for (size_t i = 0; i < nchunks; i++)
+            _bench_file("/mnt/host/bigio", _chunk_sizes[i]);
+
+        assert(umount("/mnt/host") == 0);
+    }
+
+    printf("=== passed test (%s)\n", argv[0]);
+
+    return 0;
+}
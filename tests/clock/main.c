@@ -5,8 +5,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
 #include <sys/time.h>
 #include <time.h>
+#include <unistd.h>
 
 #define NANO_IN_SECOND 1000000000
 #define SGX_TARGET "sgx"
@@ -173,6 +175,48 @@ static int test_clock_getres()
     return 0;
 }
 
+static long _rusage_nsecs(void)
+{
+    struct rusage usage;
+
+    assert(getrusage(RUSAGE_SELF, &usage) == 0);
+
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * NANO_IN_SECOND +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000L;
+}
+
+static long _monotonic_nsecs(void)
+{
+    struct timespec tp;
+
+    assert(clock_gettime(CLOCK_MONOTONIC, &tp) == 0);
+
+    return tp.tv_sec * NANO_IN_SECOND + tp.tv_nsec;
+}
+
+/* the kernel accounts process times in TSC cycles, so check the conversion */
+static int test_process_times()
+{
+    const long duration = NANO_IN_SECOND / 2;
+    long start = _monotonic_nsecs();
+    long usage = _rusage_nsecs();
+    long elapsed;
+
+    /* stay busy in and out of the kernel */
+    do
+    {
+        getppid();
+    } while ((elapsed = _monotonic_nsecs() - start) < duration);
+
+    usage = _rusage_nsecs() - usage;
+
+    printf("elapsed=%ldns usage=%ldns\n", elapsed, usage);
+    assert(usage > elapsed / 2);
+    assert(usage < elapsed * 2);
+
+    return 0;
+}
+
 int main(int argc, const char* argv[])
 {
     assert(argc == 3);
@@ -190,6 +234,8 @@ int main(int argc, const char* argv[])
 
     assert(test_clock_getres() == 0);
 
+    assert(test_process_times() == 0);
+
     printf("=== passed test (%s)\n", argv[0]);
 
     return 0;
@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <assert.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mount.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/* run with --console-buffer-size and the console redirected to a file */
+
+#define TIMEOUT_SEC 10
+
+/* the file that receives the console output, when reachable through hostfs */
+static char _path[PATH_MAX];
+
+static int _pipe[2];
+
+static void _put(int fd, const char* s)
+{
+    const size_t n = strlen(s);
+    assert(write(fd, s, n) == (ssize_t)n);
+}
+
+/* whether the console output that reached the host ends with s */
+static bool _ends_with(const char* s)
+{
+    const size_t n = strlen(s);
+    char buf[256];
+    struct stat st;
+    bool ret = false;
+    int fd;
+
+    assert(n <= sizeof(buf));
+    assert((fd = open(_path, O_RDONLY)) >= 0);
+    assert(fstat(fd, &st) == 0);
+
+    if ((size_t)st.st_size >= n &&
+        pread(fd, buf, n, st.st_size - (off_t)n) == (ssize_t)n)
+    {
+        ret = memcmp(buf, s, n) == 0;
+    }
+
+    close(fd);
+    return ret;
+}
+
+/* Poll until the console output ends with s. This never blocks in the host,
+ * since blocking would flush the console buffers by itself. */
+static bool _wait_for(const char* s)
+{
+    struct timespec t0;
+    struct timespec t;
+
+    assert(clock_gettime(CLOCK_MONOTONIC, &t0) == 0);
+
+    while (!_ends_with(s))
+    {
+        assert(clock_gettime(CLOCK_MONOTONIC, &t) == 0);
+
+        if (t.tv_sec - t0.tv_sec > TIMEOUT_SEC)
+            return false;
+    }
+
+    return true;
+}
+
+static void _test_order(void)
+{
+    char buf[64];
+
+    /* runs of writes on each stream, with many switches between them */
+    for (int i = 0; i < 100; i++)
+    {
+        const int fd = (i % 4 == 3) ? STDERR_FILENO : STDOUT_FILENO;
+
+        snprintf(buf, sizeof(buf), "consolebuf: line %d (fd %d)\n", i, fd);
+        _put(fd, buf);
+    }
+}
+
+static void _test_fsync(void)
+{
+    const char s[] = "consolebuf: before fsync\n";
+
+    _put(STDOUT_FILENO, s);
+
+    /* the output is buffered until something flushes it */
+    assert(!_ends_with(s));
+
+    /* fsync() on a tty fails as before but flushes the buffer */
+    fsync(STDOUT_FILENO);
+    assert(_ends_with(s));
+
+    _put(STDERR_FILENO, "consolebuf: before fdatasync\n");
+    fdatasync(STDERR_FILENO);
+    assert(_ends_with("consolebuf: before fdatasync\n"));
+}
+
+static void* _thread_func(void* arg)
+{
+    char c;
+
+    (void)arg;
+
+    _put(STDOUT_FILENO, "consolebuf: before blocking\n");
+
+    /* blocks in the host until the main thread has seen the output */
+    assert(read(_pipe[0], &c, 1) == 1);
+
+    return NULL;
+}
+
+static void _test_blocking(void)
+{
+    pthread_t t;
+
+    assert(pipe(_pipe) == 0);
+    assert(pthread_create(&t, NULL, _thread_func, NULL) == 0);
+
+    assert(_wait_for("consolebuf: before blocking\n"));
+
+    assert(write(_pipe[1], "x", 1) == 1);
+    assert(pthread_join(t, NULL) == 0);
+
+    close(_pipe[0]);
+    close(_pipe[1]);
+}
+
+int main(int argc, const char* argv[])
+{
+    if (argc != 1 && argc != 3)
+    {
+        fprintf(stderr, "Usage: %s [host-directory output-file]\n", argv[0]);
+        return 1;
+    }
+
+    _test_order();
+
+    /* the flushing checks read the console output through hostfs */
+    if (argc == 3)
+    {
+        assert(mkdir("/mnt", 0777) == 0);
+        assert(mkdir("/mnt/host", 0777) == 0);
+        assert(mount(argv[1], "/mnt/host", "hostfs", 0, NULL) == 0);
+        snprintf(_path, sizeof(_path), "/mnt/host/%s", argv[2]);
+
+        _test_fsync();
+        _test_blocking();
+
+        assert(umount("/mnt/host") == 0);
+    }
+
+    /* left in the buffers for the kernel to flush at exit (stdio is not used
+     * since it would write stdout at exit, after the write to stderr) */
+    _put(STDOUT_FILENO, "consolebuf: passed\n");
+    _put(STDERR_FILENO, "consolebuf: exiting\n");
+
+    return 0;
+}
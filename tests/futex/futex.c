@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include <assert.h>
+#include <errno.h>
 #include <limits.h>
 #include <pthread.h>
 #include <stdint.h>
@@ -19,6 +20,20 @@
 #define FUTEX_WAKE_BITSET 10
 #define FUTEX_CLOCK_REALTIME 256
 #define FUTEX_BITSET_MATCH_ANY 0xffffffff
+#define FUTEX_32 2
+#define FUTEX_PRIVATE 128
+
+#ifndef SYS_futex_waitv
+#define SYS_futex_waitv 449
+#endif
+
+struct futex_waitv
+{
+    uint64_t val;
+    uint64_t uaddr;
+    uint32_t flags;
+    uint32_t __reserved;
+};
 
 /* get the timestamp in nanoseconds */
 uint64_t timestamp_nsec(void)
@@ -219,6 +234,102 @@ static void test_wait_and_wake_n_bitset(void)
     printf("=== passed test (%s)\n", __FUNCTION__);
 }
 
+#define NUM_WAITV 64
+
+static int _waitv_words[NUM_WAITV];
+
+static void* _waitv_thread(void* arg)
+{
+    struct futex_waitv waiters[NUM_WAITV];
+
+    for (size_t i = 0; i < NUM_WAITV; i++)
+    {
+        waiters[i].val = 1;
+        waiters[i].uaddr = (uint64_t)&_waitv_words[i];
+        waiters[i].flags = FUTEX_32 | FUTEX_PRIVATE;
+        waiters[i].__reserved = 0;
+    }
+
+    long r = syscall(SYS_futex_waitv, waiters, NUM_WAITV, 0, NULL, 0);
+    return (void*)r;
+}
+
+static void test_waitv(void)
+{
+    const size_t index = 42;
+    struct futex_waitv waiter;
+    struct timespec to;
+    pthread_t t1;
+    void* result;
+    uint64_t t0;
+    long r;
+
+    printf("=== start test (%s)\n", __FUNCTION__);
+
+    /* skip if the host kernel predates futex_waitv (Linux 5.16) */
+    waiter.val = 1;
+    waiter.uaddr = (uint64_t)&_waitv_words[0];
+    waiter.flags = FUTEX_32;
+    waiter.__reserved = 0;
+    _waitv_words[0] = 0;
+
+    if (syscall(SYS_futex_waitv, &waiter, 1, 0, NULL, 0) == -1 &&
+        errno == ENOSYS)
+    {
+        printf("=== skipped test (%s)\n", __FUNCTION__);
+        return;
+    }
+
+    /* fails immediately when a futex does not have the expected value */
+    assert(errno == EAGAIN);
+
+    /* times out when nothing wakes the waiter */
+    _waitv_words[0] = 1;
+    clock_gettime(CLOCK_MONOTONIC, &to);
+    to.tv_nsec += 100000000;
+    if (to.tv_nsec >= 1000000000)
+    {
+        to.tv_sec++;
+        to.tv_nsec -= 1000000000;
+    }
+    t0 = timestamp_nsec();
+    r = syscall(SYS_futex_waitv, &waiter, 1, 0, &to, CLOCK_MONOTONIC);
+    assert(r == -1 && errno == ETIMEDOUT);
+
+    /* the deadline holds across wakeups (allow generous slop) */
+    assert(timestamp_nsec() - t0 < 1000000000);
+
+    /* rejects unsupported flags */
+    waiter.flags = 0;
+    r = syscall(SYS_futex_waitv, &waiter, 1, 0, NULL, 0);
+    assert(r == -1 && errno == EINVAL);
+
+    /* a wake on any one of the futexes wakes the waiter with its index */
+    for (size_t i = 0; i < NUM_WAITV; i++)
+        _waitv_words[i] = 1;
+
+    assert(pthread_create(&t1, NULL, _waitv_thread, NULL) == 0);
+
+    /* wait until thread is asleep */
+    sleep_msec(100);
+
+    _waitv_words[index] = 0;
+    r = syscall(
+        SYS_futex,
+        &_waitv_words[index],
+        FUTEX_WAKE | FUTEX_PRIVATE,
+        1,
+        NULL,
+        NULL,
+        0);
+    assert(r == 1);
+
+    assert(pthread_join(t1, &result) == 0);
+    assert((long)result == index);
+
+    printf("=== passed test (%s)\n", __FUNCTION__);
+}
+
 int main(int argc, const char* argv[])
 {
     unsigned long count = 1;
@@ -252,6 +363,7 @@ int main(int argc, const char* argv[])
         test_wait_realtime();
         test_wait_and_wake_bitset();
         test_wait_and_wake_n_bitset();
+        test_waitv();
     }
 
     printf("=== passed test (%s)\n", argv[0]);
@@ -2,18 +2,130 @@
 // Licensed under the MIT License.
 
 #include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
+#include <sys/wait.h>
 #include <syscall.h>
+#include <time.h>
 #include <unistd.h>
 
+#define DEFAULT_ITERATIONS 100000
+
+static size_t _iterations = DEFAULT_ITERATIONS;
+
+static uint64_t _nanos(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000UL + (uint64_t)ts.tv_nsec;
+}
+
+static void* _thread_func(void* arg)
+{
+    pid_t* ids = (pid_t*)arg;
+
+    ids[0] = getpid();
+    ids[1] = (pid_t)syscall(SYS_gettid);
+
+    return NULL;
+}
+
+/* check that the answers follow the calling thread and process */
+static void _test_threads_and_fork(pid_t pid, pid_t ppid)
+{
+    pid_t ids[2][2];
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        pthread_t t;
+        assert(pthread_create(&t, NULL, _thread_func, ids[i]) == 0);
+        assert(pthread_join(t, NULL) == 0);
+        assert(ids[i][0] == pid);
+        assert(ids[i][1] != pid);
+    }
+
+    /* the second thread may reuse the thread descriptor of the first */
+    assert(ids[0][1] != ids[1][1]);
+
+    pid_t child = fork();
+    assert(child >= 0);
+
+    if (child == 0)
+    {
+        if (getpid() == pid || getppid() != pid)
+            _exit(1);
+
+        if ((pid_t)syscall(SYS_gettid) != getpid())
+            _exit(2);
+
+        _exit(0);
+    }
+
+    int status;
+    assert(waitpid(child, &status, 0) == child);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    assert(getpid() == pid);
+    assert(getppid() == ppid);
+}
+
+/* negative and unknown pids must fail cleanly (they index the pid hash) */
+static void _test_bad_pids(void)
+{
+    assert(setpgid(-1, 0) == -1 && errno == EINVAL);
+    assert(setpgid(INT_MIN, 0) == -1 && errno == EINVAL);
+    assert(setpgid(1000000, 0) == -1 && errno == ESRCH);
+    assert(kill(1000000, 0) == -1 && errno == ESRCH);
+}
+
+#define BENCH(EXPR)                                           \
+    do                                                        \
+    {                                                         \
+        uint64_t start = _nanos();                            \
+        for (size_t i = 0; i < _iterations; i++)              \
+            sum += (long)(EXPR);                              \
+        uint64_t elapsed = _nanos() - start;                  \
+        printf(                                               \
+            "%-36s calls=%zu ns/call=%.1f\n",                 \
+            #EXPR,                                            \
+            _iterations,                                      \
+            (double)elapsed / (double)_iterations);           \
+    } while (0)
+
+static void _bench(void)
+{
+    volatile long sum = 0;
+    struct timespec ts;
+
+    BENCH(getpid());
+    BENCH(syscall(SYS_gettid));
+    BENCH(getppid());
+    BENCH(getuid());
+    BENCH(geteuid());
+    BENCH(getgid());
+    BENCH(getegid());
+
+    /* for comparison: this one still enters the kernel */
+    BENCH(clock_gettime(CLOCK_MONOTONIC, &ts));
+
+    (void)sum;
+}
+
 int main(int argc, const char* argv[])
 {
     pid_t ppid = getppid();
     pid_t pid = getpid();
     pid_t tid = (pid_t)syscall(SYS_gettid);
 
+    if (argc == 2)
+        _iterations = strtoul(argv[1], NULL, 10);
+
 #if 0
     printf("ppid=%d pid=%d tid=%d\n", ppid, pid, tid);
 #endif
@@ -24,6 +136,12 @@ int main(int argc, const char* argv[])
     assert(ppid != pid);
     assert(tid == pid);
 
+    _test_threads_and_fork(pid, ppid);
+
+    _test_bad_pids();
+
+    _bench();
+
     printf("=== passed test (%s)\n", argv[0]);
 
     return 0;
@@ -124,6 +124,43 @@ int main(int argc, const char* argv[])
         assert(close(fd) == 0);
     }
 
+    /* test pwritev() */
+    {
+        struct iovec iov[2];
+        const int iovcnt = sizeof(iov) / sizeof(iov[0]);
+        const size_t n = 13;
+
+        iov[0].iov_base = (void*)ALPHA;
+        iov[0].iov_len = n;
+        iov[1].iov_base = (void*)(ALPHA + n);
+        iov[1].iov_len = 3;
+
+        assert((fd = open(filename, O_WRONLY, 0)) >= 0);
+        assert(pwritev(fd, iov, iovcnt, 5) == n + 3);
+        assert(lseek(fd, 0, SEEK_CUR) == 0);
+        assert(close(fd) == 0);
+    }
+
+    /* test preadv() */
+    {
+        struct iovec iov[2];
+        const int iovcnt = sizeof(iov) / sizeof(iov[0]);
+        char buf[sizeof(alpha)];
+
+        iov[0].iov_base = (void*)buf;
+        iov[0].iov_len = 5;
+        iov[1].iov_base = (void*)(buf + 5);
+        iov[1].iov_len = sizeof(buf) - 5;
+
+        assert((fd = open(filename, O_RDONLY, 0)) >= 0);
+        assert(preadv(fd, iov, iovcnt, 0) == sizeof(alpha));
+        assert(memcmp(buf, alpha, 5) == 0);
+        assert(memcmp(buf + 5, ALPHA, 16) == 0);
+        assert(memcmp(buf + 21, alpha + 21, sizeof(alpha) - 21) == 0);
+        assert(lseek(fd, 0, SEEK_CUR) == 0);
+        assert(close(fd) == 0);
+    }
+
     /* test ioctl(FIONBIO) */
     {
         assert((fd = open(filename, O_RDONLY, 0)) >= 0);
@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_NTHREADS 10000
+#define STACK_SIZE (32 * 1024)
+
+static pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t _arrived_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t _go_cond = PTHREAD_COND_INITIALIZER;
+static size_t _arrived;
+static int _go;
+static size_t _done;
+
+static void* _thread_func(void* arg)
+{
+    const size_t i = (size_t)arg;
+
+    /* a few threads sleep so that timed waits are mixed in */
+    if (i % 1000 == 0)
+    {
+        struct timespec req = {0, 1000000};
+        assert(nanosleep(&req, NULL) == 0);
+    }
+
+    pthread_mutex_lock(&_mutex);
+    {
+        if (++_arrived % 1000 == 0)
+            pthread_cond_signal(&_arrived_cond);
+
+        /* every thread stays blocked until all of them exist */
+        while (!_go)
+            pthread_cond_wait(&_go_cond, &_mutex);
+
+        _done++;
+    }
+    pthread_mutex_unlock(&_mutex);
+
+    sched_yield();
+
+    return arg;
+}
+
+int main(int argc, const char* argv[])
+{
+    size_t nthreads = DEFAULT_NTHREADS;
+    pthread_t* threads;
+    pthread_attr_t attr;
+
+    if (argc == 2)
+        nthreads = strtoul(argv[1], NULL, 10);
+
+    assert((threads = calloc(nthreads, sizeof(pthread_t))));
+
+    assert(pthread_attr_init(&attr) == 0);
+    assert(pthread_attr_setstacksize(&attr, STACK_SIZE) == 0);
+
+    for (size_t i = 0; i < nthreads; i++)
+    {
+        void* arg = (void*)i;
+        int r = pthread_create(&threads[i], &attr, _thread_func, arg);
+
+        if (r != 0)
+        {
+            fprintf(stderr, "pthread_create() failed: %zu: %d\n", i, r);
+            abort();
+        }
+    }
+
+    /* wait for all threads to block */
+    pthread_mutex_lock(&_mutex);
+    {
+        while (_arrived != nthreads)
+        {
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_sec++;
+            pthread_cond_timedwait(&_arrived_cond, &_mutex, &ts);
+        }
+
+        printf("=== %zu threads blocked\n", nthreads);
+
+        _go = 1;
+        pthread_cond_broadcast(&_go_cond);
+    }
+    pthread_mutex_unlock(&_mutex);
+
+    for (size_t i = 0; i < nthreads; i++)
+    {
+        void* ret = NULL;
+        assert(pthread_join(threads[i], &ret) == 0);
+        assert(ret == (void*)i);
+    }
+
+    assert(_done == nthreads);
+
+    pthread_attr_destroy(&attr);
+    free(threads);
+
+    printf("=== passed test (%s)\n", argv[0]);
+
+    return 0;
+}
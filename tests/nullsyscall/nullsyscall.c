@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_THREADS 32
+#define DEFAULT_ITERATIONS 100000
+
+static size_t _iterations = DEFAULT_ITERATIONS;
+static volatile int _start;
+
+static uint64_t _nanos(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000UL + (uint64_t)ts.tv_nsec;
+}
+
+static void* _thread_func(void* arg)
+{
+    const long n = *(const long*)arg;
+
+    while (!_start)
+        ;
+
+    /* the syscalls do no work in the kernel beyond syscall entry and exit */
+    for (size_t i = 0; i < _iterations; i++)
+        assert(syscall(n, 0) > 0);
+
+    return NULL;
+}
+
+static void _bench(long n, size_t nthreads)
+{
+    pthread_t threads[MAX_THREADS];
+    uint64_t start;
+    uint64_t elapsed;
+    const size_t total = nthreads * _iterations;
+
+    _start = 0;
+
+    for (size_t i = 0; i < nthreads; i++)
+        assert(pthread_create(&threads[i], NULL, _thread_func, &n) == 0);
+
+    start = _nanos();
+    _start = 1;
+
+    for (size_t i = 0; i < nthreads; i++)
+        assert(pthread_join(threads[i], NULL) == 0);
+
+    elapsed = _nanos() - start;
+
+    printf(
+        "%s: threads=%2zu syscalls=%zu ns/syscall=%.1f syscalls/sec=%.0f\n",
+        n == SYS_getsid ? "getsid" : "getpgrp",
+        nthreads,
+        total,
+        (double)elapsed / (double)_iterations,
+        (double)total / ((double)elapsed / 1e9));
+}
+
+static double _latency(long n)
+{
+    uint64_t start = _nanos();
+
+    for (size_t i = 0; i < _iterations; i++)
+        assert(syscall(n, 0) > 0);
+
+    return (double)(_nanos() - start) / (double)_iterations;
+}
+
+/* getsid() takes the fast path of myst_syscall() while getpgrp(), which needs
+ * the calling thread, takes the full path through the kernel stack (both take
+ * the full path with --strace) */
+static void _bench_latency(void)
+{
+    printf("getsid: ns/syscall=%.1f\n", _latency(SYS_getsid));
+    printf("getpgrp: ns/syscall=%.1f\n", _latency(SYS_getpgrp));
+}
+
+int main(int argc, const char* argv[])
+{
+    size_t max_threads = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (argc == 2)
+        _iterations = strtoul(argv[1], NULL, 10);
+
+    if (max_threads > MAX_THREADS)
+        max_threads = MAX_THREADS;
+
+    _bench_latency();
+
+    /* getpgrp() contends for the kernel stacks, getsid() does not */
+    for (size_t n = 1; n <= max_threads; n *= 2)
+        _bench(SYS_getpgrp, n);
+
+    for (size_t n = 1; n <= max_threads; n *= 2)
+        _bench(SYS_getsid, n);
+
+    printf("=== passed test (%s)\n", argv[0]);
+
+    return 0;
+}
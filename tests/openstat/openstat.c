@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <assert.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_THREADS 16
+#define DEFAULT_ITERATIONS 20000
+
+static const char* _path;
+static size_t _iterations = DEFAULT_ITERATIONS;
+static volatile int _start;
+
+static void* _thread_func(void* arg)
+{
+    (void)arg;
+
+    while (!_start)
+        ;
+
+    for (size_t i = 0; i < _iterations; i++)
+    {
+        struct stat buf;
+        int fd;
+
+        /* open() resolves the mount table and assigns an fdtable entry */
+        assert((fd = open(_path, O_RDONLY)) >= 0);
+
+        /* fstat() looks up the fdtable entry */
+        assert(fstat(fd, &buf) == 0);
+        assert(S_ISREG(buf.st_mode));
+        assert(close(fd) == 0);
+
+        /* stat() resolves the mount table only */
+        assert(stat(_path, &buf) == 0);
+        assert(S_ISREG(buf.st_mode));
+    }
+
+    return NULL;
+}
+
+static double _now(void)
+{
+    struct timespec ts;
+    assert(clock_gettime(CLOCK_MONOTONIC, &ts) == 0);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void _bench(size_t nthreads)
+{
+    pthread_t threads[MAX_THREADS];
+    double start;
+    double elapsed;
+    double ops;
+
+    _start = 0;
+
+    for (size_t i = 0; i < nthreads; i++)
+        assert(pthread_create(&threads[i], NULL, _thread_func, NULL) == 0);
+
+    start = _now();
+    _start = 1;
+
+    for (size_t i = 0; i < nthreads; i++)
+        assert(pthread_join(threads[i], NULL) == 0);
+
+    elapsed = _now() - start;
+
+    /* each iteration is four syscalls: open, fstat, close, stat */
+    ops = (double)(nthreads * _iterations * 4);
+
+    printf(
+        "threads=%2zu ops=%.0f seconds=%.3f ops/sec=%.0f\n",
+        nthreads,
+        ops,
+        elapsed,
+        ops / elapsed);
+}
+
+int main(int argc, const char* argv[])
+{
+    _path = argv[0];
+
+    if (argc == 2)
+        _iterations = strtoul(argv[1], NULL, 10);
+
+    for (size_t n = 1; n <= MAX_THREADS; n *= 2)
+        _bench(n);
+
+    printf("=== passed test (%s)\n", argv[0]);
+
+    return 0;
+}
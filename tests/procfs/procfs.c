@@ -12,6 +12,7 @@
 #include <sys/mman.h>
 #include <sys/prctl.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <time.h>
@@ -226,6 +227,43 @@ int test_cpuinfo()
     close(fd);
 }
 
+void test_myst_syscalls()
+{
+    int fd;
+    static char buf[64 * 1024];
+    size_t len = 0;
+    ssize_t n;
+    const char* line;
+    unsigned long calls, total, avg, p50, p99, max;
+
+    /* getpgrp() needs the calling thread, so it takes the full, accounted
+     * syscall path (getpid() is answered by the C-runtime or the fast path) */
+    for (size_t i = 0; i < 100; i++)
+        assert(syscall(SYS_getpgrp) > 0);
+
+    fd = open("/proc/myst/syscalls", O_RDONLY);
+    assert(fd > 0);
+    while ((n = read(fd, buf + len, sizeof(buf) - len - 1)) > 0)
+        len += n;
+    close(fd);
+    buf[len] = '\0';
+
+    assert(strncmp(buf, "syscall", 7) == 0);
+    assert((line = strstr(buf, "\nSYS_getpgrp ")));
+    assert(
+        sscanf(
+            line,
+            " SYS_getpgrp %lu %lu %lu %lu %lu %lu",
+            &calls,
+            &total,
+            &avg,
+            &p50,
+            &p99,
+            &max) == 6);
+    assert(calls >= 100);
+    assert(p50 <= p99 && p99 <= max);
+}
+
 int test_fdatasync()
 {
     int fd;
@@ -349,6 +387,7 @@ int main(int argc, const char* argv[])
     test_readonly();
     test_maps();
     test_cpuinfo();
+    test_myst_syscalls();
     test_fdatasync();
     test_stat();
     test_stat_from_child();
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+static uint64_t _nanos(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000UL + (uint64_t)ts.tv_nsec;
+}
+
+/* burn CPU in user code; the profile should end in this function */
+__attribute__((noinline)) static uint64_t _spin(uint64_t n)
+{
+    volatile uint64_t x = 0;
+
+    for (uint64_t i = 0; i < n; i++)
+        x += i * i;
+
+    return x;
+}
+
+/* burn CPU in the kernel; the profile should show kernel frames */
+__attribute__((noinline)) static void _syscalls(uint64_t n)
+{
+    for (uint64_t i = 0; i < n; i++)
+        assert(syscall(SYS_getsid, 0) > 0);
+}
+
+int main(int argc, const char* argv[])
+{
+    uint64_t start = _nanos();
+
+    /* run each for about half a second */
+    while (_nanos() - start < 500000000UL)
+        _spin(1000000);
+
+    start = _nanos();
+
+    while (_nanos() - start < 500000000UL)
+        _syscalls(1000);
+
+    printf("=== passed test (%s)\n", argv[0]);
+
+    return 0;
+}
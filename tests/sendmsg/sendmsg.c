@@ -4,6 +4,7 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 
+#define _GNU_SOURCE
 #include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -226,11 +227,99 @@ static void* _cli_thread_func(void* arg)
     return NULL;
 }
 
+/* send a batch of datagrams with sendmmsg() and receive them with recvmmsg() */
+static void _test_mmsg(void)
+{
+    enum
+    {
+        NMSGS = 8
+    };
+    int rsock;
+    int ssock;
+    struct sockaddr_in addr;
+    socklen_t addrlen = sizeof(addr);
+    struct mmsghdr vec[NMSGS];
+    struct iovec iov[NMSGS][2];
+    struct sockaddr_in from[NMSGS];
+    char buf[NMSGS][sizeof(alpha)];
+
+    assert((rsock = socket(AF_INET, SOCK_DGRAM, 0)) >= 0);
+    assert((ssock = socket(AF_INET, SOCK_DGRAM, 0)) >= 0);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    assert(bind(rsock, (struct sockaddr*)&addr, sizeof(addr)) == 0);
+    assert(getsockname(rsock, (struct sockaddr*)&addr, &addrlen) == 0);
+
+    /* message i is the first i + 1 letters, split over two iovecs */
+    memset(vec, 0, sizeof(vec));
+
+    for (size_t i = 0; i < NMSGS; i++)
+    {
+        iov[i][0].iov_base = (void*)alpha;
+        iov[i][0].iov_len = 1;
+        iov[i][1].iov_base = (void*)(alpha + 1);
+        iov[i][1].iov_len = i;
+        vec[i].msg_hdr.msg_name = &addr;
+        vec[i].msg_hdr.msg_namelen = sizeof(addr);
+        vec[i].msg_hdr.msg_iov = iov[i];
+        vec[i].msg_hdr.msg_iovlen = 2;
+    }
+
+    assert(sendmmsg(ssock, vec, NMSGS, 0) == NMSGS);
+
+    for (size_t i = 0; i < NMSGS; i++)
+        assert(vec[i].msg_len == i + 1);
+
+    /* receive all of them, blocking for the first one only */
+    memset(vec, 0, sizeof(vec));
+    memset(buf, 0, sizeof(buf));
+
+    for (size_t i = 0; i < NMSGS; i++)
+    {
+        iov[i][0].iov_base = buf[i];
+        iov[i][0].iov_len = sizeof(buf[i]);
+        vec[i].msg_hdr.msg_name = &from[i];
+        vec[i].msg_hdr.msg_namelen = sizeof(from[i]);
+        vec[i].msg_hdr.msg_iov = iov[i];
+        vec[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    size_t n = 0;
+
+    while (n < NMSGS)
+    {
+        int r = recvmmsg(rsock, vec + n, NMSGS - n, MSG_WAITFORONE, NULL);
+        assert(r > 0);
+        n += r;
+    }
+
+    for (size_t i = 0; i < NMSGS; i++)
+    {
+        assert(vec[i].msg_len == i + 1);
+        assert(memcmp(buf[i], alpha, i + 1) == 0);
+        assert(vec[i].msg_hdr.msg_namelen == sizeof(from[i]));
+        assert(from[i].sin_family == AF_INET);
+        assert(from[i].sin_addr.s_addr == htonl(INADDR_LOOPBACK));
+    }
+
+    /* nothing is left, so a non-blocking receive fails */
+    assert(recvmmsg(rsock, vec, NMSGS, MSG_DONTWAIT, NULL) == -1);
+    assert(errno == EAGAIN);
+
+    assert(close(ssock) == 0);
+    assert(close(rsock) == 0);
+}
+
 int main(int argc, const char* argv[])
 {
     pthread_t srv_thread;
     pthread_t cli_thread;
 
+    _test_mmsg();
+
     assert(pthread_create(&srv_thread, NULL, _srv_thread_func, NULL) == 0);
     _sleep_msec(100);
     assert(pthread_create(&cli_thread, NULL, _cli_thread_func, NULL) == 0);
@@ -4,6 +4,7 @@
 #define _GNU_SOURCE
 #include <assert.h>
 #include <errno.h>
+#include <limits.h>
 #include <pthread.h>
 #include <semaphore.h>
 #include <signal.h>
@@ -295,6 +296,21 @@ void test_sig_zero()
     printf("=== : Test passed (%s)\n", __FUNCTION__);
 }
 
+void test_bad_tid()
+{
+    // negative and zero thread ids are invalid
+    assert(syscall(SYS_tgkill, getpid(), -5, SIGTERM) == -1);
+    assert(errno == EINVAL);
+    assert(syscall(SYS_tkill, -5, SIGTERM) == -1 && errno == EINVAL);
+    assert(syscall(SYS_tkill, INT_MIN, SIGTERM) == -1 && errno == EINVAL);
+    assert(syscall(SYS_tkill, 0, SIGTERM) == -1 && errno == EINVAL);
+
+    // check for non-existent thread
+    assert(syscall(SYS_tkill, 1000000, SIGTERM) == -1 && errno == ESRCH);
+
+    printf("=== : Test passed (%s)\n", __FUNCTION__);
+}
+
 static uint64_t _sigset_to_uint64(const sigset_t* set)
 {
     uint64_t* p = (uint64_t*)set;
@@ -432,6 +448,8 @@ int main(int argc, const char* argv[])
 
     test_sig_zero();
 
+    test_bad_tid();
+
     /* The nested altstack is not supported by the Linux target */
     if (target && strcmp(target, "linux") != 0)
         test_nested_altstack();
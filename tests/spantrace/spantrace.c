@@ -0,0 +1,20 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+int main(int argc, const char* argv[])
+{
+    int fd;
+
+    /* each of these should show up as a span */
+    assert((fd = open("/bin/spantrace", O_RDONLY)) >= 0);
+    assert(close(fd) == 0);
+
+    printf("=== passed test (%s)\n", argv[0]);
+
+    return 0;
+}
@@ -0,0 +1,173 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <myst/defs.h>
+#include <myst/spinlock.h>
+#include <myst/ticketlock.h>
+
+#define MAX_THREADS 64
+#define DEFAULT_ITERATIONS 2000
+
+typedef enum lock_type
+{
+    LOCK_SPIN,
+    LOCK_TICKET,
+} lock_type_t;
+
+static myst_spinlock_t _spin = MYST_SPINLOCK_INITIALIZER;
+static myst_ticketlock_t _ticket = MYST_TICKETLOCK_INITIALIZER;
+static lock_type_t _type;
+static size_t _iterations = DEFAULT_ITERATIONS;
+static volatile int _start;
+static volatile size_t _counter;
+
+typedef struct thread_arg
+{
+    uint64_t* waits;
+} thread_arg_t;
+
+static uint64_t _nanos(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000UL + (uint64_t)ts.tv_nsec;
+}
+
+static void _lock(void)
+{
+    if (_type == LOCK_SPIN)
+        myst_spin_lock(&_spin);
+    else
+        myst_ticket_lock(&_ticket);
+}
+
+static void _unlock(void)
+{
+    if (_type == LOCK_SPIN)
+        myst_spin_unlock(&_spin);
+    else
+        myst_ticket_unlock(&_ticket);
+}
+
+static void* _thread_func(void* arg)
+{
+    thread_arg_t* targ = (thread_arg_t*)arg;
+
+    while (!_start)
+        ;
+
+    for (size_t i = 0; i < _iterations; i++)
+    {
+        const uint64_t t0 = _nanos();
+        _lock();
+        targ->waits[i] = _nanos() - t0;
+
+        /* short critical section */
+        _counter++;
+
+        _unlock();
+    }
+
+    return NULL;
+}
+
+static int _compare(const void* lhs, const void* rhs)
+{
+    const uint64_t x = *(const uint64_t*)lhs;
+    const uint64_t y = *(const uint64_t*)rhs;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static void _bench(lock_type_t type, size_t nthreads)
+{
+    pthread_t threads[MAX_THREADS];
+    thread_arg_t args[MAX_THREADS];
+    const size_t total = nthreads * _iterations;
+    uint64_t* waits;
+    uint64_t start;
+    double seconds;
+
+    assert((waits = calloc(total, sizeof(uint64_t))));
+
+    _type = type;
+    _start = 0;
+    _counter = 0;
+
+    for (size_t i = 0; i < nthreads; i++)
+    {
+        args[i].waits = waits + (i * _iterations);
+        assert(pthread_create(&threads[i], NULL, _thread_func, &args[i]) == 0);
+    }
+
+    start = _nanos();
+    _start = 1;
+
+    for (size_t i = 0; i < nthreads; i++)
+        assert(pthread_join(threads[i], NULL) == 0);
+
+    seconds = (double)(_nanos() - start) / 1e9;
+
+    /* the lock must have provided mutual exclusion */
+    assert(_counter == total);
+
+    qsort(waits, total, sizeof(uint64_t), _compare);
+
+    printf(
+        "%-6s threads=%2zu ops/sec=%10.0f p50=%8luns p99=%10luns "
+        "max=%10luns\n",
+        type == LOCK_SPIN ? "spin" : "ticket",
+        nthreads,
+        (double)total / seconds,
+        waits[total / 2],
+        waits[(total * 99) / 100],
+        waits[total - 1]);
+
+    free(waits);
+}
+
+static void _test_ticket_trylock(void)
+{
+    myst_ticketlock_t t = MYST_TICKETLOCK_INITIALIZER;
+
+    assert(myst_ticket_trylock(&t));
+    assert(!myst_ticket_trylock(&t));
+    myst_ticket_unlock(&t);
+    assert(myst_ticket_trylock(&t));
+    myst_ticket_unlock(&t);
+
+    printf("=== passed test (%s)\n", __FUNCTION__);
+}
+
+int main(int argc, const char* argv[])
+{
+    size_t max_threads = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (argc == 2)
+        _iterations = strtoul(argv[1], NULL, 10);
+
+    /* spinning threads that outnumber the CPUs only measure preemption */
+    if (max_threads < 2)
+        max_threads = 2;
+    else if (max_threads > MAX_THREADS)
+        max_threads = MAX_THREADS;
+
+    _test_ticket_trylock();
+
+    for (size_t n = 2; n <= max_threads; n *= 2)
+    {
+        _bench(LOCK_SPIN, n);
+        _bench(LOCK_TICKET, n);
+    }
+
+    printf("=== passed test (%s)\n", argv[0]);
+
+    return 0;
+}
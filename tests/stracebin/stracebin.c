@@ -0,0 +1,20 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+int main(int argc, const char* argv[])
+{
+    /* leave a failing and a successful syscall for the decoder to find */
+    assert(open("/no/such/file", O_RDONLY) == -1 && errno == ENOENT);
+    assert(syscall(SYS_getppid) > 0);
+
+    printf("=== passed test (%s)\n", argv[0]);
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+/* each creator has one live child, so keep well below the enclave limit */
+#define MAX_CREATORS 4
+#define DEFAULT_ITERATIONS 2000
+
+static size_t _iterations = DEFAULT_ITERATIONS;
+static volatile int _start;
+
+static uint64_t _nanos(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000UL + (uint64_t)ts.tv_nsec;
+}
+
+static void* _child_func(void* arg)
+{
+    return arg;
+}
+
+static void* _creator_func(void* arg)
+{
+    const size_t n = (size_t)arg;
+
+    while (!_start)
+        ;
+
+    /* create and join as fast as possible */
+    for (size_t i = 0; i < n; i++)
+    {
+        pthread_t t;
+        void* ret = NULL;
+
+        assert(pthread_create(&t, NULL, _child_func, (void*)(i + 1)) == 0);
+        assert(pthread_join(t, &ret) == 0);
+        assert(ret == (void*)(i + 1));
+    }
+
+    return NULL;
+}
+
+static void _bench(size_t ncreators)
+{
+    pthread_t creators[MAX_CREATORS];
+    const size_t per_creator = _iterations / ncreators;
+    const size_t total = per_creator * ncreators;
+    uint64_t start;
+    uint64_t elapsed;
+
+    _start = 0;
+
+    for (size_t i = 0; i < ncreators; i++)
+    {
+        void* arg = (void*)per_creator;
+        assert(pthread_create(&creators[i], NULL, _creator_func, arg) == 0);
+    }
+
+    start = _nanos();
+    _start = 1;
+
+    for (size_t i = 0; i < ncreators; i++)
+        assert(pthread_join(creators[i], NULL) == 0);
+
+    elapsed = _nanos() - start;
+
+    printf(
+        "creators=%zu threads=%zu us/create+join=%.1f threads/sec=%.0f\n",
+        ncreators,
+        total,
+        (double)elapsed / 1000.0 / (double)per_creator,
+        (double)total / ((double)elapsed / 1e9));
+}
+
+int main(int argc, const char* argv[])
+{
+    size_t max_creators = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (argc == 2)
+        _iterations = strtoul(argv[1], NULL, 10);
+
+    if (max_creators > MAX_CREATORS)
+        max_creators = MAX_CREATORS;
+
+    for (size_t n = 1; n <= max_creators; n *= 2)
+        _bench(n);
+
+    printf("=== passed test (%s)\n", argv[0]);
+
+    return 0;
+}
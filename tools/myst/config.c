@@ -220,6 +220,29 @@ static json_result_t _json_read_callback(
 
                 parsed_data->max_affinity_cpus = (size_t)un->integer;
             }
+            else if (json_match(parser, "MNThreads") == JSON_OK)
+            {
+                if (type != JSON_TYPE_INTEGER)
+                    CONFIG_RAISE(JSON_TYPE_MISMATCH);
+
+                if (un->integer < 0)
+                    CONFIG_RAISE(JSON_OUT_OF_BOUNDS);
+
+                parsed_data->mn_threads = (size_t)un->integer;
+            }
+            else if (json_match(parser, "ConsoleBufferSize") == JSON_OK)
+            {
+                if (type != JSON_TYPE_INTEGER)
+                    CONFIG_RAISE(JSON_TYPE_MISMATCH);
+
+                if (un->integer < 0 ||
+                    un->integer > MYST_MAX_CONSOLE_BUFFER_SIZE)
+                {
+                    CONFIG_RAISE(JSON_OUT_OF_BOUNDS);
+                }
+
+                parsed_data->console_buffer_size = (size_t)un->integer;
+            }
             else if (json_match(parser, "NoBrk") == JSON_OK)
             {
                 if (type == JSON_TYPE_BOOLEAN)
@@ -81,6 +81,10 @@ typedef struct _config_parsed_data_t
     size_t thread_stack_size;
     /* maximum number of CPUs in the kernel (for thread affinity) */
     size_t max_affinity_cpus;
+    /* number of host threads that carry multiplexed threads (0 disables) */
+    size_t mn_threads;
+    /* size of the kernel buffer of stdout and stderr (0 disables) */
+    size_t console_buffer_size;
 
     // Internal data
     void* buffer;
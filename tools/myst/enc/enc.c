@@ -694,11 +694,23 @@ static long _enter(void* arg_)
                                      : MYST_PROCESS_INIT_STACK_SIZE;
         _kargs.thread_stack_size = final_options.base.thread_stack_size;
         _kargs.host_uds = final_options.base.host_uds;
+        _kargs.mn_threads = final_options.base.mn_threads;
+        _kargs.console_buffer_size = final_options.base.console_buffer_size;
+        _kargs.console_isatty = final_options.base.console_isatty;
+        _kargs.trace_spans = final_options.base.trace_spans;
+        memcpy(
+            _kargs.trace_spans_path,
+            final_options.base.trace_spans_path,
+            sizeof(_kargs.trace_spans_path));
 
         /* whether user-space FSGSBASE instructions are supported */
         _kargs.have_fsgsbase_instructions =
             final_options.base.have_fsgsbase_instructions;
 
+        /* whether RDTSC can be executed without trapping (SGX2) */
+        _kargs.have_rdtsc_instruction =
+            final_options.base.have_rdtsc_instruction;
+
         /* set ehdr and verify that the kernel is an ELF image */
         {
             ehdr = (const Elf64_Ehdr*)_kargs.kernel_data;
@@ -892,6 +904,16 @@ long myst_tcall_wake(uint64_t event)
     return retval;
 }
 
+long myst_tcall_wake_many(const uint64_t* events, size_t count)
+{
+    long retval = -EINVAL;
+
+    if (myst_wake_many_ocall(&retval, events, count) != OE_OK)
+        return -EINVAL;
+
+    return retval;
+}
+
 long myst_tcall_wake_wait(
     uint64_t waiter_event,
     uint64_t self_event,
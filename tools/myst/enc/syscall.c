@@ -5,6 +5,7 @@
 #include <limits.h>
 #include <net/if.h>
 #include <sched.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -15,8 +16,10 @@
 
 #include <myst/eraise.h>
 #include <myst/iov.h>
+#include <myst/mmsgbuf.h>
 #include <myst/syscall.h>
 #include <myst/tcall.h>
+#include <myst/tcallring.h>
 #include "myst_t.h"
 
 #define RETURN(EXPR) return ((EXPR) == OE_OK ? ret : -EINVAL)
@@ -61,6 +64,277 @@ done:
     return ret;
 }
 
+/*
+**==============================================================================
+**
+** host staging buffers:
+**
+**     Reads and writes (vectored or not) larger than MAX_BUFFER_SIZE use a
+**     host buffer that each enclave thread (TCS) obtains with its first large
+**     transfer and keeps for the life of the enclave. Since the ocall passes
+**     the buffer as a pointer, a transfer of up to STAGING_BUFFER_SIZE bytes
+**     takes one transition and one copy between the enclave and the host
+**     buffer (IO vectors are gathered into it or scattered from it). The
+**     buffers are found by the thread data of the TCS (gsbase), since the
+**     fsbase may belong to the application during a tcall.
+**
+**     When the host runs tcall workers (--tcall-workers), all non-blocking
+**     reads and writes use the staging buffer and are submitted to the host
+**     ring (see myst/tcallring.h) instead of making an OCALL. The request
+**     lives in host memory right after the staging buffer. The caller only
+**     leaves the enclave to wake a sleeping worker or to park when a worker
+**     takes longer than the spin budget.
+**
+**==============================================================================
+*/
+
+#define STAGING_BUFFER_SIZE (1024 * 1024)
+
+/* the staging buffer followed by the thread's ring request */
+#define STAGING_ALLOC_SIZE \
+    (STAGING_BUFFER_SIZE + sizeof(myst_tcall_request_t))
+
+/* bound the spin budget, which the host controls */
+#define MAX_RING_SPIN (1024 * 1024)
+
+typedef struct staging
+{
+    struct staging* next;
+    const void* td;
+    void* buf; /* null if the host did not provide a usable buffer */
+} staging_t;
+
+/* entries are only added (by the thread that owns them) and never removed */
+static staging_t* _stagings;
+
+static const void* _get_td(void)
+{
+    const void* td;
+    __asm__ volatile("mov %%gs:0, %0" : "=r"(td));
+    return td;
+}
+
+/* Get the staging buffer of the calling thread or null if there is none */
+static void* _get_staging_buffer(void)
+{
+    const void* td = _get_td();
+    staging_t* p;
+    void* buf = NULL;
+
+    for (p = __atomic_load_n(&_stagings, __ATOMIC_ACQUIRE); p; p = p->next)
+    {
+        if (p->td == td)
+            return p->buf;
+    }
+
+    if (!(p = calloc(1, sizeof(staging_t))))
+        return NULL;
+
+    /* a buffer that overlaps the enclave would let the host read or
+     * overwrite enclave memory, so remember that there is no buffer */
+    if (myst_staging_alloc_ocall(&buf, STAGING_ALLOC_SIZE) != OE_OK ||
+        !buf || !oe_is_outside_enclave(buf, STAGING_ALLOC_SIZE))
+    {
+        buf = NULL;
+    }
+
+    p->td = td;
+    p->buf = buf;
+    p->next = __atomic_load_n(&_stagings, __ATOMIC_RELAXED);
+
+    while (!__atomic_compare_exchange_n(
+        &_stagings, &p->next, p, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        ;
+
+    return buf;
+}
+
+/* Get the host ring of --tcall-workers or null if the host has none */
+static myst_tcall_ring_t* _get_ring(void)
+{
+    static myst_tcall_ring_t* _ring;
+    static bool _initialized;
+    void* ring = NULL;
+
+    if (__atomic_load_n(&_initialized, __ATOMIC_ACQUIRE))
+        return _ring;
+
+    /* a ring that overlaps the enclave would let the host overwrite enclave
+     * memory; racing threads all store the same result */
+    if (myst_tcall_ring_ocall(&ring) != OE_OK || !ring ||
+        !oe_is_outside_enclave(ring, sizeof(myst_tcall_ring_t)))
+    {
+        ring = NULL;
+    }
+
+    _ring = ring;
+    __atomic_store_n(&_initialized, true, __ATOMIC_RELEASE);
+
+    return _ring;
+}
+
+/* Submit the read or write n on the staging buffer to the host ring and wait
+ * for a worker to perform it. Return false if the ring is full or the worker
+ * handed the call back, in which case the caller makes the OCALL itself.
+ */
+static bool _ring_io(
+    myst_tcall_ring_t* ring,
+    void* staging,
+    long n,
+    int fd,
+    size_t count,
+    off_t offset,
+    long* retval)
+{
+    myst_tcall_request_t* request =
+        (myst_tcall_request_t*)((uint8_t*)staging + STAGING_BUFFER_SIZE);
+    int expected = MYST_TCALL_REQUEST_PENDING;
+    size_t spin = __atomic_load_n(&ring->spin, __ATOMIC_RELAXED);
+
+    request->n = n;
+    request->params[0] = fd;
+    request->params[1] = (long)staging;
+    request->params[2] = (long)count;
+    request->params[3] = (long)offset;
+    request->params[4] = 0;
+    request->params[5] = 0;
+    request->ret = 0;
+    request->declined = false;
+    request->state = MYST_TCALL_REQUEST_PENDING;
+
+    if (!myst_tcall_ring_enqueue(ring, request))
+        return false;
+
+    if (myst_tcall_ring_has_sleepers(ring))
+        myst_tcall_ring_wake_ocall();
+
+    if (spin > MAX_RING_SPIN)
+        spin = MAX_RING_SPIN;
+
+    for (size_t i = 0; i < spin; i++)
+    {
+        if (__atomic_load_n(&request->state, __ATOMIC_ACQUIRE) ==
+            MYST_TCALL_REQUEST_DONE)
+        {
+            break;
+        }
+
+        __asm__ __volatile__("pause" : : : "memory");
+    }
+
+    if (__atomic_compare_exchange_n(
+            &request->state,
+            &expected,
+            MYST_TCALL_REQUEST_WAITING,
+            false,
+            __ATOMIC_ACQ_REL,
+            __ATOMIC_ACQUIRE))
+    {
+        /* the host may return early, so check the state again */
+        while (__atomic_load_n(&request->state, __ATOMIC_ACQUIRE) ==
+               MYST_TCALL_REQUEST_WAITING)
+        {
+            myst_tcall_ring_wait_ocall(request);
+        }
+    }
+
+    if (__atomic_load_n(&request->declined, __ATOMIC_ACQUIRE))
+        return false;
+
+    /* read once; the caller checks the value like any OCALL result */
+    *retval = __atomic_load_n(&request->ret, __ATOMIC_RELAXED);
+
+    return true;
+}
+
+/* Perform the read or write n (SYS_read, SYS_write, SYS_pread64 or
+ * SYS_pwrite64) of count bytes (at most STAGING_BUFFER_SIZE) on the data
+ * that is already in the staging buffer.
+ */
+static long _staged_call(
+    void* staging,
+    long n,
+    int fd,
+    size_t count,
+    off_t offset,
+    bool block)
+{
+    long ret = 0;
+    long retval;
+    myst_tcall_ring_t* ring;
+    oe_result_t r;
+
+    /* blocking calls stay on this thread, which myst_interrupt_thread()
+     * signals */
+    if (!block && (ring = _get_ring()) &&
+        _ring_io(ring, staging, n, fd, count, offset, &retval))
+    {
+        r = OE_OK;
+    }
+    else if (block)
+    {
+        r = myst_staged_io_block_ocall(&retval, n, fd, staging, count);
+    }
+    else
+    {
+        r = myst_staged_io_ocall(&retval, n, fd, staging, count, offset);
+    }
+
+    if (r != OE_OK)
+    {
+        ret = -EINVAL;
+        goto done;
+    }
+
+    if (retval < 0)
+    {
+        ret = retval;
+        goto done;
+    }
+
+    /* guard against host setting the return value greater than count */
+    if (retval > (ssize_t)count)
+    {
+        ret = -EINVAL;
+        goto done;
+    }
+
+    ret = retval;
+
+done:
+    return ret;
+}
+
+/* Perform the read or write n (SYS_read, SYS_write, SYS_pread64 or
+ * SYS_pwrite64) on the staging buffer, transferring at most
+ * STAGING_BUFFER_SIZE bytes.
+ */
+static long _staged_io(
+    void* staging,
+    long n,
+    int fd,
+    void* buf,
+    size_t count,
+    off_t offset,
+    bool block)
+{
+    long ret;
+    const bool in = (n == SYS_read || n == SYS_pread64);
+
+    if (count > STAGING_BUFFER_SIZE)
+        count = STAGING_BUFFER_SIZE;
+
+    if (!in)
+        memcpy(staging, buf, count);
+
+    ret = _staged_call(staging, n, fd, count, offset, block);
+
+    if (in && ret > 0)
+        memcpy(buf, staging, (size_t)ret);
+
+    return ret;
+}
+
 static long _read(
     int fd,
     void* buf,
@@ -69,6 +343,8 @@ static long _read(
 {
     long ret = 0;
     long retval;
+    void* staging;
+    const bool block = (ocall != myst_read_ocall);
 
     if (fd < 0 || (!buf && count) || count > SSIZE_MAX)
     {
@@ -76,6 +352,13 @@ static long _read(
         goto done;
     }
 
+    if ((count > MAX_BUFFER_SIZE || (!block && _get_ring())) &&
+        (staging = _get_staging_buffer()))
+    {
+        ret = _staged_io(staging, SYS_read, fd, buf, count, 0, block);
+        goto done;
+    }
+
     ECHECK(_cap_size(fd, &count));
 
     if (ocall(&retval, fd, buf, count) != OE_OK)
@@ -111,6 +394,8 @@ static long _write(
 {
     long ret = 0;
     long retval;
+    void* staging;
+    const bool block = (ocall != myst_write_ocall);
 
     if (fd < 0 || (!buf && count) || count > SSIZE_MAX)
     {
@@ -118,6 +403,14 @@ static long _write(
         goto done;
     }
 
+    if ((count > MAX_BUFFER_SIZE || (!block && _get_ring())) &&
+        (staging = _get_staging_buffer()))
+    {
+        ret = _staged_io(
+            staging, SYS_write, fd, (void*)buf, count, 0, block);
+        goto done;
+    }
+
     ECHECK(_cap_size(fd, &count));
 
     if (ocall(&retval, fd, buf, count) != OE_OK)
@@ -145,6 +438,191 @@ done:
     return ret;
 }
 
+/* Copy at most len bytes of an IO vector, starting at the given offset into
+ * it, onto buf and return the number of bytes copied.
+ */
+static size_t _iov_copy(
+    const struct iovec* iov,
+    int iovcnt,
+    size_t offset,
+    void* buf,
+    size_t len)
+{
+    uint8_t* ptr = buf;
+    size_t count = 0;
+
+    for (int i = 0; i < iovcnt && count < len; i++)
+    {
+        const struct iovec* v = &iov[i];
+        size_t min;
+
+        if (offset >= v->iov_len)
+        {
+            offset -= v->iov_len;
+            continue;
+        }
+
+        min = v->iov_len - offset;
+
+        if (min > len - count)
+            min = len - count;
+
+        memcpy(ptr + count, (const uint8_t*)v->iov_base + offset, min);
+        count += min;
+        offset = 0;
+    }
+
+    return count;
+}
+
+/* Check the arguments of a vectored read or write and get the total length
+ * of the IO vector.
+ */
+static long _iov_len(int fd, const struct iovec* iov, int iovcnt, size_t* len)
+{
+    long ret = 0;
+    ssize_t n;
+
+    *len = 0;
+
+    if (fd < 0 || iovcnt < 0 || iovcnt > IOV_MAX || (!iov && iovcnt))
+    {
+        ret = -EINVAL;
+        goto done;
+    }
+
+    if (iovcnt == 0)
+        goto done;
+
+    if ((n = myst_iov_len(iov, iovcnt)) < 0)
+    {
+        ret = n;
+        goto done;
+    }
+
+    *len = (size_t)n;
+
+done:
+    return ret;
+}
+
+/* Allocate the flat buffer that carries the data of a vectored read or write
+ * across the enclave boundary when the thread has no staging buffer. Like the
+ * buffer of read() and write(), it is capped at MAX_BUFFER_SIZE, so long IO
+ * vectors are transferred partially rather than depleting the enclave heap.
+ */
+static long _iov_buffer(int fd, void** buf, size_t* len)
+{
+    long ret = 0;
+
+    *buf = NULL;
+
+    ECHECK(_cap_size(fd, len));
+
+    if (*len && !(*buf = malloc(*len)))
+    {
+        ret = -ENOMEM;
+        goto done;
+    }
+
+done:
+    return ret;
+}
+
+/* Perform the vectored read or write n (SYS_read, SYS_write, SYS_pread64 or
+ * SYS_pwrite64) on the staging buffer, gathering the IO vector into it or
+ * scattering the data read from it, transferring at most STAGING_BUFFER_SIZE
+ * bytes.
+ */
+static long _staged_iov(
+    void* staging,
+    long n,
+    int fd,
+    const struct iovec* iov,
+    int iovcnt,
+    size_t len,
+    off_t offset)
+{
+    long ret;
+    const bool in = (n == SYS_read || n == SYS_pread64);
+
+    if (len > STAGING_BUFFER_SIZE)
+        len = STAGING_BUFFER_SIZE;
+
+    if (!in)
+        _iov_copy(iov, iovcnt, 0, staging, len);
+
+    ret = _staged_call(staging, n, fd, len, offset, false);
+
+    if (in && ret > 0)
+    {
+        long r;
+
+        if ((r = myst_iov_scatter(iov, iovcnt, staging, (size_t)ret)) < 0)
+            ret = r;
+    }
+
+    return ret;
+}
+
+static long _readv(int fd, const struct iovec* iov, int iovcnt)
+{
+    long ret = 0;
+    void* buf = NULL;
+    void* staging;
+    size_t len;
+
+    ECHECK(_iov_len(fd, iov, iovcnt, &len));
+
+    if ((len > MAX_BUFFER_SIZE || _get_ring()) &&
+        (staging = _get_staging_buffer()))
+    {
+        ret = _staged_iov(staging, SYS_read, fd, iov, iovcnt, len, 0);
+        goto done;
+    }
+
+    ECHECK(_iov_buffer(fd, &buf, &len));
+    ECHECK(ret = _read(fd, buf, len, myst_read_ocall));
+
+    if (ret > 0)
+        ECHECK(myst_iov_scatter(iov, iovcnt, buf, (size_t)ret));
+
+done:
+
+    if (buf)
+        free(buf);
+
+    return ret;
+}
+
+static long _writev(int fd, const struct iovec* iov, int iovcnt)
+{
+    long ret = 0;
+    void* buf = NULL;
+    void* staging;
+    size_t len;
+
+    ECHECK(_iov_len(fd, iov, iovcnt, &len));
+
+    if ((len > MAX_BUFFER_SIZE || _get_ring()) &&
+        (staging = _get_staging_buffer()))
+    {
+        ret = _staged_iov(staging, SYS_write, fd, iov, iovcnt, len, 0);
+        goto done;
+    }
+
+    ECHECK(_iov_buffer(fd, &buf, &len));
+    _iov_copy(iov, iovcnt, 0, buf, len);
+    ret = _write(fd, buf, len, myst_write_ocall);
+
+done:
+
+    if (buf)
+        free(buf);
+
+    return ret;
+}
+
 static long _nanosleep(const struct timespec* req, struct timespec* rem)
 {
     long ret;
@@ -398,6 +876,8 @@ static long _sendmsg(
     long ret = 0;
     long retval = 0;
     oe_result_t oeret;
+    uint8_t* chunk = NULL;
+    size_t total;
 
     if (sockfd < 0 || !msg)
     {
@@ -405,17 +885,39 @@ static long _sendmsg(
         goto done;
     }
 
-    /* The kernel pre-flattens the IO vector into a single iov[] element */
+    /* The kernel pre-flattens the IO vector of sendmsg() into a single iov[]
+     * element, but a blocking writev() passes its own IO vector, which is
+     * gathered one capped chunk at a time */
     if (msg->msg_iovlen != 1)
     {
-        ret = -EINVAL;
-        goto done;
+        ssize_t n;
+        size_t cap;
+
+        if ((n = myst_iov_len(msg->msg_iov, (int)msg->msg_iovlen)) < 0)
+        {
+            ret = n;
+            goto done;
+        }
+
+        total = (size_t)n;
+        cap = total;
+        ECHECK(_cap_size(sockfd, &cap));
+
+        if (cap && !(chunk = malloc(cap)))
+        {
+            ret = -ENOMEM;
+            goto done;
+        }
+    }
+    else
+    {
+        total = msg->msg_iov[0].iov_len;
     }
 
     /* repeat operation when recvmsg() returns a short count */
     {
-        const uint8_t* buf = msg->msg_iov[0].iov_base;
-        size_t len = msg->msg_iov[0].iov_len;
+        const uint8_t* buf = chunk ? chunk : msg->msg_iov[0].iov_base;
+        size_t len = total;
         size_t count = 0;
 
         while (len > 0)
@@ -423,6 +925,13 @@ static long _sendmsg(
             size_t cap = len;
             ECHECK(_cap_size(sockfd, &cap));
 
+            if (chunk)
+            {
+                _iov_copy(
+                    msg->msg_iov, (int)msg->msg_iovlen, count, chunk, cap);
+                buf = chunk;
+            }
+
             if ((oeret = ocall(
                      &retval,
                      sockfd,
@@ -464,7 +973,7 @@ static long _sendmsg(
     }
 
     /* guard against host returning a size bigger than buffer */
-    if ((size_t)retval > msg->msg_iov[0].iov_len)
+    if ((size_t)retval > total)
     {
         ret = -EINVAL;
         goto done;
@@ -474,6 +983,9 @@ static long _sendmsg(
 
 done:
 
+    if (chunk)
+        free(chunk);
+
     return ret;
 }
 
@@ -607,6 +1119,365 @@ done:
     return ret;
 }
 
+/* The most data (names, control data and payloads) that one sendmmsg() or
+ * recvmmsg() OCALL carries. Like the buffers of read() and write(), larger
+ * message vectors are transferred partially.
+ */
+#define MAX_MMSG_BUFFER_SIZE (64 * 1024)
+
+/* Fill in the flattened headers (see myst/mmsgbuf.h) of as many of the
+ * leading messages as fit into MAX_MMSG_BUFFER_SIZE. Return their number
+ * and the size of their data buffer.
+ */
+static unsigned int _mmsg_batch(
+    const struct mmsghdr* msgvec,
+    unsigned int vlen,
+    struct myst_mmsgbuf_hdr* hdrs,
+    size_t* size_out)
+{
+    size_t size = 0;
+    unsigned int n;
+
+    for (n = 0; n < vlen && n < MYST_MMSGBUF_MAX_VLEN; n++)
+    {
+        const struct msghdr* msg = &msgvec[n].msg_hdr;
+        struct myst_mmsgbuf_hdr* hdr = &hdrs[n];
+        ssize_t len = myst_iov_len(msg->msg_iov, (int)msg->msg_iovlen);
+        size_t msize;
+
+        /* errors are reported by the single message path */
+        if (len < 0 || len > MAX_MMSG_BUFFER_SIZE ||
+            msg->msg_controllen > MAX_MMSG_BUFFER_SIZE)
+        {
+            break;
+        }
+
+        memset(hdr, 0, sizeof(*hdr));
+        hdr->len = (uint64_t)len;
+        hdr->namelen = msg->msg_name ? msg->msg_namelen : 0;
+        hdr->controllen = msg->msg_control ? msg->msg_controllen : 0;
+
+        msize = myst_mmsgbuf_align(hdr->namelen) +
+                myst_mmsgbuf_align(hdr->controllen) +
+                myst_mmsgbuf_align(hdr->len);
+
+        if (msize > MAX_MMSG_BUFFER_SIZE - size)
+            break;
+
+        size += msize;
+    }
+
+    *size_out = size;
+    return n;
+}
+
+/* Allocate the headers (followed by a copy that the host cannot modify) and
+ * the data buffer of a batch of messages. Return the number of messages or
+ * zero if the first message should be transferred on its own.
+ */
+static long _mmsg_alloc(
+    const struct mmsghdr* msgvec,
+    unsigned int vlen,
+    struct myst_mmsgbuf_hdr** hdrs_out,
+    uint8_t** data_out,
+    size_t* size_out)
+{
+    long ret = 0;
+    struct myst_mmsgbuf_hdr* hdrs = NULL;
+    uint8_t* data = NULL;
+    unsigned int n;
+    size_t size;
+
+    if (vlen > MYST_MMSGBUF_MAX_VLEN)
+        vlen = MYST_MMSGBUF_MAX_VLEN;
+
+    if (!(hdrs = calloc(2 * vlen, sizeof(struct myst_mmsgbuf_hdr))))
+    {
+        ret = -ENOMEM;
+        goto done;
+    }
+
+    if ((n = _mmsg_batch(msgvec, vlen, hdrs, &size)) == 0)
+        goto done;
+
+    /* keep the capacities to check the lengths the host returns */
+    memcpy(hdrs + n, hdrs, n * sizeof(struct myst_mmsgbuf_hdr));
+
+    if (!(data = calloc(1, size ? size : 1)))
+    {
+        ret = -ENOMEM;
+        goto done;
+    }
+
+    *hdrs_out = hdrs;
+    *data_out = data;
+    *size_out = size;
+    hdrs = NULL;
+    data = NULL;
+    ret = n;
+
+done:
+
+    if (hdrs)
+        free(hdrs);
+
+    if (data)
+        free(data);
+
+    return ret;
+}
+
+/* Send as many messages as fit into one flattened buffer with one OCALL.
+ * Only a message too large for the buffer is sent on its own.
+ */
+static long _sendmmsg(
+    int sockfd,
+    struct mmsghdr* msgvec,
+    unsigned int vlen,
+    int flags,
+    bool block)
+{
+    long ret = 0;
+    long retval;
+    struct myst_mmsgbuf_hdr* hdrs = NULL;
+    struct myst_mmsgbuf_hdr* caps;
+    uint8_t* data = NULL;
+    size_t size = 0;
+    size_t offset = 0;
+    long n;
+    oe_result_t r;
+
+    if (sockfd < 0 || (!msgvec && vlen))
+    {
+        ret = -EINVAL;
+        goto done;
+    }
+
+    if (vlen == 0)
+        goto done;
+
+    ECHECK(n = _mmsg_alloc(msgvec, vlen, &hdrs, &data, &size));
+
+    if (n == 0)
+    {
+        ECHECK(
+            retval = _sendmsg(
+                sockfd,
+                &msgvec[0].msg_hdr,
+                flags,
+                block ? myst_sendmsg_block_ocall : myst_sendmsg_ocall));
+        msgvec[0].msg_len = (unsigned int)retval;
+        ret = 1;
+        goto done;
+    }
+
+    caps = hdrs + n;
+
+    /* gather the names, control data and payloads */
+    for (long i = 0; i < n; i++)
+    {
+        const struct msghdr* msg = &msgvec[i].msg_hdr;
+        long name = myst_mmsgbuf_take(size, &offset, caps[i].namelen);
+        long control = myst_mmsgbuf_take(size, &offset, caps[i].controllen);
+        long payload = myst_mmsgbuf_take(size, &offset, caps[i].len);
+
+        if (caps[i].namelen)
+            memcpy(data + name, msg->msg_name, caps[i].namelen);
+
+        if (caps[i].controllen)
+            memcpy(data + control, msg->msg_control, caps[i].controllen);
+
+        _iov_copy(
+            msg->msg_iov,
+            (int)msg->msg_iovlen,
+            0,
+            data + payload,
+            caps[i].len);
+    }
+
+    if (block)
+        r = myst_sendmmsg_block_ocall(
+            &retval, sockfd, hdrs, (unsigned int)n, data, size, flags);
+    else
+        r = myst_sendmmsg_ocall(
+            &retval, sockfd, hdrs, (unsigned int)n, data, size, flags);
+
+    if (r != OE_OK)
+    {
+        ret = -EINVAL;
+        goto done;
+    }
+
+    if (retval < 0)
+    {
+        ret = retval;
+        goto done;
+    }
+
+    /* guard against the host returning too large a count or size */
+    if (retval > n)
+    {
+        ret = -EINVAL;
+        goto done;
+    }
+
+    for (long i = 0; i < retval; i++)
+    {
+        if (hdrs[i].len > caps[i].len)
+        {
+            ret = -EINVAL;
+            goto done;
+        }
+
+        msgvec[i].msg_len = (unsigned int)hdrs[i].len;
+    }
+
+    ret = retval;
+
+done:
+
+    if (hdrs)
+        free(hdrs);
+
+    if (data)
+        free(data);
+
+    return ret;
+}
+
+/* Receive as many messages as fit into one flattened buffer with one OCALL.
+ * Only a message too large for the buffer is received on its own.
+ */
+static long _recvmmsg(
+    int sockfd,
+    struct mmsghdr* msgvec,
+    unsigned int vlen,
+    int flags,
+    bool block)
+{
+    long ret = 0;
+    long retval;
+    struct myst_mmsgbuf_hdr* hdrs = NULL;
+    struct myst_mmsgbuf_hdr* caps;
+    uint8_t* data = NULL;
+    size_t size = 0;
+    size_t offset = 0;
+    long n;
+    oe_result_t r;
+
+    if (sockfd < 0 || (!msgvec && vlen))
+    {
+        ret = -EINVAL;
+        goto done;
+    }
+
+    if (vlen == 0)
+        goto done;
+
+    ECHECK(n = _mmsg_alloc(msgvec, vlen, &hdrs, &data, &size));
+
+    if (n == 0)
+    {
+        ECHECK(
+            retval = _recvmsg(
+                sockfd,
+                &msgvec[0].msg_hdr,
+                flags,
+                block ? myst_recvmsg_block_ocall : myst_recvmsg_ocall));
+        msgvec[0].msg_len = (unsigned int)retval;
+        ret = 1;
+        goto done;
+    }
+
+    caps = hdrs + n;
+
+    if (block)
+        r = myst_recvmmsg_block_ocall(
+            &retval, sockfd, hdrs, (unsigned int)n, data, size, flags);
+    else
+        r = myst_recvmmsg_ocall(
+            &retval, sockfd, hdrs, (unsigned int)n, data, size, flags);
+
+    if (r != OE_OK)
+    {
+        ret = -EINVAL;
+        goto done;
+    }
+
+    if (retval < 0)
+    {
+        ret = retval;
+        goto done;
+    }
+
+    /* guard against the host returning too large a count */
+    if (retval > n)
+    {
+        ret = -EINVAL;
+        goto done;
+    }
+
+    /* scatter the received messages, locating them by the capacities */
+    for (long i = 0; i < retval; i++)
+    {
+        struct msghdr* msg = &msgvec[i].msg_hdr;
+        long name = myst_mmsgbuf_take(size, &offset, caps[i].namelen);
+        long control = myst_mmsgbuf_take(size, &offset, caps[i].controllen);
+        long payload = myst_mmsgbuf_take(size, &offset, caps[i].len);
+        socklen_t namelen = hdrs[i].namelen;
+        size_t controllen = hdrs[i].controllen;
+        int msg_flags = hdrs[i].flags;
+
+        // ATTN: as in _recvmsg(), a length greater than the buffer length
+        // is treated as an error, although recvmmsg() allows it.
+        if (hdrs[i].len > caps[i].len ||
+            namelen > sizeof(struct sockaddr_storage))
+        {
+            ret = -EINVAL;
+            goto done;
+        }
+
+        /* note: the lengths may legitimately be bigger due to truncation */
+        if (namelen > caps[i].namelen)
+            namelen = caps[i].namelen;
+
+        if (controllen > caps[i].controllen)
+        {
+            controllen = caps[i].controllen;
+            msg_flags |= MSG_CTRUNC;
+        }
+
+        if (namelen)
+            memcpy(msg->msg_name, data + name, namelen);
+
+        if (controllen)
+            memcpy(msg->msg_control, data + control, controllen);
+
+        ECHECK(myst_iov_scatter(
+            msg->msg_iov,
+            (int)msg->msg_iovlen,
+            data + payload,
+            (size_t)hdrs[i].len));
+
+        msg->msg_namelen = msg->msg_name ? namelen : 0;
+        msg->msg_controllen = msg->msg_control ? controllen : 0;
+        msg->msg_flags = msg_flags;
+        msgvec[i].msg_len = (unsigned int)hdrs[i].len;
+    }
+
+    ret = retval;
+
+done:
+
+    if (hdrs)
+        free(hdrs);
+
+    if (data)
+        free(data);
+
+    return ret;
+}
+
 static long _shutdown(int sockfd, int how)
 {
     long ret;
@@ -1112,6 +1983,7 @@ static long _pread64(int fd, void* buf, size_t count, off_t offset)
 {
     long ret = 0;
     long retval;
+    void* staging;
 
     if (fd < 0 || (!buf && count) || count > SSIZE_MAX)
     {
@@ -1119,6 +1991,13 @@ static long _pread64(int fd, void* buf, size_t count, off_t offset)
         goto done;
     }
 
+    if ((count > MAX_BUFFER_SIZE || _get_ring()) &&
+        (staging = _get_staging_buffer()))
+    {
+        ret = _staged_io(staging, SYS_pread64, fd, buf, count, offset, false);
+        goto done;
+    }
+
     ECHECK(_cap_size(fd, &count));
 
     if (myst_pread64_ocall(&retval, fd, buf, count, offset) != OE_OK)
@@ -1152,6 +2031,7 @@ static long _pwrite64(int fd, const void* buf, size_t count, off_t offset)
 {
     long ret = 0;
     long retval;
+    void* staging;
 
     if (fd < 0 || (!buf && count) || count > SSIZE_MAX)
     {
@@ -1159,6 +2039,14 @@ static long _pwrite64(int fd, const void* buf, size_t count, off_t offset)
         goto done;
     }
 
+    if ((count > MAX_BUFFER_SIZE || _get_ring()) &&
+        (staging = _get_staging_buffer()))
+    {
+        ret = _staged_io(
+            staging, SYS_pwrite64, fd, (void*)buf, count, offset, false);
+        goto done;
+    }
+
     ECHECK(_cap_size(fd, &count));
 
     if (myst_pwrite64_ocall(&retval, fd, buf, count, offset) != OE_OK)
@@ -1187,6 +2075,68 @@ done:
 }
 #endif
 
+#ifdef MYST_ENABLE_HOSTFS
+static long _preadv(int fd, const struct iovec* iov, int iovcnt, off_t offset)
+{
+    long ret = 0;
+    void* buf = NULL;
+    void* staging;
+    size_t len;
+
+    ECHECK(_iov_len(fd, iov, iovcnt, &len));
+
+    if ((len > MAX_BUFFER_SIZE || _get_ring()) &&
+        (staging = _get_staging_buffer()))
+    {
+        ret = _staged_iov(staging, SYS_pread64, fd, iov, iovcnt, len, offset);
+        goto done;
+    }
+
+    ECHECK(_iov_buffer(fd, &buf, &len));
+    ECHECK(ret = _pread64(fd, buf, len, offset));
+
+    if (ret > 0)
+        ECHECK(myst_iov_scatter(iov, iovcnt, buf, (size_t)ret));
+
+done:
+
+    if (buf)
+        free(buf);
+
+    return ret;
+}
+#endif
+
+#ifdef MYST_ENABLE_HOSTFS
+static long _pwritev(int fd, const struct iovec* iov, int iovcnt, off_t offset)
+{
+    long ret = 0;
+    void* buf = NULL;
+    void* staging;
+    size_t len;
+
+    ECHECK(_iov_len(fd, iov, iovcnt, &len));
+
+    if ((len > MAX_BUFFER_SIZE || _get_ring()) &&
+        (staging = _get_staging_buffer()))
+    {
+        ret = _staged_iov(staging, SYS_pwrite64, fd, iov, iovcnt, len, offset);
+        goto done;
+    }
+
+    ECHECK(_iov_buffer(fd, &buf, &len));
+    _iov_copy(iov, iovcnt, 0, buf, len);
+    ret = _pwrite64(fd, buf, len, offset);
+
+done:
+
+    if (buf)
+        free(buf);
+
+    return ret;
+}
+#endif
+
 #ifdef MYST_ENABLE_HOSTFS
 static long _link(const char* oldpath, const char* newpath)
 {
@@ -1929,6 +2879,14 @@ long myst_handle_tcall(long n, long params[6])
             return _write(
                 (int)a, (const void*)b, (size_t)c, myst_write_block_ocall);
         }
+        case SYS_readv:
+        {
+            return _readv((int)a, (const struct iovec*)b, (int)c);
+        }
+        case SYS_writev:
+        {
+            return _writev((int)a, (const struct iovec*)b, (int)c);
+        }
         case SYS_close:
         {
             return _close((int)a);
@@ -2056,6 +3014,42 @@ long myst_handle_tcall(long n, long params[6])
             return _recvmsg(
                 (int)a, (struct msghdr*)b, (int)c, myst_recvmsg_block_ocall);
         }
+        case SYS_sendmmsg:
+        {
+            return _sendmmsg(
+                (int)a,
+                (struct mmsghdr*)b,
+                (unsigned int)c,
+                (int)d,
+                false);
+        }
+        case MYST_TCALL_SENDMMSG_BLOCK:
+        {
+            return _sendmmsg(
+                (int)a,
+                (struct mmsghdr*)b,
+                (unsigned int)c,
+                (int)d,
+                true);
+        }
+        case SYS_recvmmsg:
+        {
+            return _recvmmsg(
+                (int)a,
+                (struct mmsghdr*)b,
+                (unsigned int)c,
+                (int)d,
+                false);
+        }
+        case MYST_TCALL_RECVMMSG_BLOCK:
+        {
+            return _recvmmsg(
+                (int)a,
+                (struct mmsghdr*)b,
+                (unsigned int)c,
+                (int)d,
+                true);
+        }
         case SYS_shutdown:
         {
             return _shutdown((int)a, (int)b);
@@ -2144,6 +3138,14 @@ long myst_handle_tcall(long n, long params[6])
         {
             return _pwrite64((int)a, (const void*)b, (size_t)c, (off_t)d);
         }
+        case SYS_preadv:
+        {
+            return _preadv((int)a, (const struct iovec*)b, (int)c, (off_t)d);
+        }
+        case SYS_pwritev:
+        {
+            return _pwritev((int)a, (const struct iovec*)b, (int)c, (off_t)d);
+        }
         case SYS_link:
         {
             return _link((const char*)a, (const char*)b);
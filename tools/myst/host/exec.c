@@ -3,6 +3,7 @@
 
 #define _GNU_SOURCE
 #include <assert.h>
+#include <cpuid.h>
 #include <errno.h>
 #include <libgen.h>
 #include <limits.h>
@@ -46,6 +47,8 @@
 #include "regions.h"
 #include "roothash.h"
 #include "strace.h"
+#include "tcallring.h"
+#include "threadpool.h"
 #include "utils.h"
 
 // This is a default enclave configuration that we use when overriding the
@@ -87,6 +90,20 @@ static void _sleep_msec(uint64_t msec)
         req = &rem;
 }
 
+/* RDTSC is legal inside enclaves on processors that support SGX2 */
+static bool _have_sgx2(void)
+{
+    uint32_t eax = 0;
+    uint32_t ebx = 0;
+    uint32_t ecx = 0;
+    uint32_t edx = 0;
+
+    if (!__get_cpuid_count(0x12, 0, &eax, &ebx, &ecx, &edx))
+        return false;
+
+    return (eax & 0x2) ? true : false;
+}
+
 static size_t _count_args(const char* args[])
 {
     size_t n = 0;
@@ -105,14 +122,16 @@ static __thread int _thread_event;
 /* the number of enclave threads (excluding the main thread) */
 static _Atomic(size_t) _num_child_enclave_threads;
 
-static void* _thread_func(void* arg)
+static void _run_thread(uint64_t cookie)
 {
-    uint64_t cookie = (uint64_t)arg;
     uint64_t event = (uint64_t)&_thread_event;
     pid_t target_tid = (pid_t)syscall(SYS_gettid);
     oe_result_t res;
     long retval = -1;
 
+    /* discard any wake left over from a previous thread on this host thread */
+    _thread_event = 0;
+
     /* block MYST_INTERRUPT_THREAD_SIGNAL when inside the enclave */
     sigset_t set;
     sigemptyset(&set);
@@ -136,18 +155,11 @@ static void* _thread_func(void* arg)
     }
 
     _num_child_enclave_threads--;
-    return NULL;
 }
 
 long myst_create_thread_ocall(uint64_t cookie)
 {
-    pthread_t t;
-    pthread_attr_t attr;
-
-    pthread_attr_init(&attr);
-    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
-    long ret = -pthread_create(&t, &attr, _thread_func, (void*)cookie);
-    pthread_attr_destroy(&attr);
+    long ret = thread_pool_create_thread(_run_thread, cookie);
 
     if (ret == 0)
         _num_child_enclave_threads++;
@@ -166,6 +178,11 @@ long myst_wake_ocall(uint64_t event)
     return myst_tcall_wake(event);
 }
 
+long myst_wake_many_ocall(const uint64_t* events, size_t count)
+{
+    return myst_tcall_wake_many(events, count);
+}
+
 long myst_wake_wait_ocall(
     uint64_t waiter_event,
     uint64_t self_event,
@@ -289,6 +306,16 @@ int exec_launch_enclave(
             _err("failed to serialize mapping parameter stings");
     }
 
+    /* start the workers before the enclave asks for the ring */
+    if (options->tcall_workers)
+    {
+        long ret = tcall_ring_start(
+            options->tcall_workers, options->tcall_spin, tcall_ring_syscall);
+
+        if (ret != 0)
+            _err("failed to start tcall workers: %ld", ret);
+    }
+
     /* Get clock times right before entering the enclave */
     shm_create_clock(&shared_memory, CLOCK_TICK);
 
@@ -321,6 +348,12 @@ int exec_launch_enclave(
     if (r != OE_OK)
         _err("failed to enter enclave: result=%s", oe_result_str(r));
 
+    if (options->perf)
+    {
+        thread_pool_dump_stats(stdout);
+        tcall_ring_dump_stats(stdout);
+    }
+
     /* unblock MYST_INTERRUPT_THREAD_SIGNAL when outside the enclave */
     sigprocmask(SIG_UNBLOCK, &set, NULL);
 
@@ -385,6 +418,20 @@ Options:\n\
                             it encounters an unimplemented syscall\n\
                             'true' implies the syscall would not terminate\n\
                             and instead return ENOSYS.\n\
+    --mn-threads <num>   -- multiplex application threads onto at most\n\
+                            <num> enclave threads (0 disables)\n\
+    --console-buffer-size <size>\n\
+                         -- buffer up to <size> bytes of standard output\n\
+                            and standard error in the kernel (0 disables)\n\
+    --trace-spans <path> -- write the boot phases, execs, tcalls, file system\n\
+                            operations and syscalls to the host file <path>\n\
+                            as a Chrome trace (chrome://tracing)\n\
+    --tcall-workers <num>\n\
+                         -- perform host reads and writes on <num> worker\n\
+                            threads fed through a ring in host memory,\n\
+                            without leaving the enclave (0 disables)\n\
+    --tcall-spin <num>   -- how many times callers and idle workers poll\n\
+                            the ring before they sleep (default 4096)\n\
 \n"
 
 int exec_action(int argc, const char* argv[], const char* envp[])
@@ -466,6 +513,64 @@ int exec_action(int argc, const char* argv[], const char* envp[])
         if (cli_getopt(&argc, argv, "--report-native-tids", NULL) == 0)
             options.report_native_tids = true;
 
+        /* Get --trace-spans option */
+        {
+            const char* arg = NULL;
+
+            if (cli_getopt(&argc, argv, "--trace-spans", &arg) == 0 && arg)
+            {
+                const size_t n = sizeof(options.trace_spans_path);
+
+                if (myst_strlcpy(options.trace_spans_path, arg, n) >= n)
+                    _err("--trace-spans path is too long");
+
+                options.trace_spans = true;
+            }
+        }
+
+        /* SGX hides the interrupted context of enclave threads */
+        {
+            const char* arg;
+
+            if (cli_getopt(&argc, argv, "--profile", &arg) == 0 ||
+                cli_getopt(&argc, argv, "--profile-hz", &arg) == 0)
+            {
+                _err("--profile is only supported by the linux target");
+            }
+        }
+
+        /* Get --tcall-workers option */
+        {
+            const char* arg = NULL;
+
+            if (cli_getopt(&argc, argv, "--tcall-workers", &arg) == 0)
+            {
+                char* end = NULL;
+                size_t val = strtoull(arg, &end, 10);
+
+                if (!end || *end != '\0' || val > 1024)
+                    _err("bad --tcall-workers=%s option", arg);
+
+                options.tcall_workers = val;
+            }
+        }
+
+        /* Get --tcall-spin option */
+        {
+            const char* arg = NULL;
+
+            if (cli_getopt(&argc, argv, "--tcall-spin", &arg) == 0)
+            {
+                char* end = NULL;
+                size_t val = strtoull(arg, &end, 10);
+
+                if (!end || *end != '\0' || val == 0)
+                    _err("bad --tcall-spin=%s option", arg);
+
+                options.tcall_spin = val;
+            }
+        }
+
         /* Get --host-uds option */
         if (cli_getopt(&argc, argv, "--host-uds", NULL) == 0)
             options.host_uds = true;
@@ -493,6 +598,52 @@ int exec_action(int argc, const char* argv[], const char* envp[])
             }
         }
 
+        /* Get --mn-threads */
+        {
+            const char* arg = NULL;
+
+            if ((cli_getopt(&argc, argv, "--mn-threads", &arg) == 0))
+            {
+                char* end = NULL;
+                size_t val = strtoull(arg, &end, 10);
+
+                if (!end || *end != '\0')
+                {
+                    fprintf(
+                        stderr,
+                        "%s: bad --mn-threads=%s option\n",
+                        argv[0],
+                        arg);
+                    return 1;
+                }
+
+                options.mn_threads = val;
+            }
+        }
+
+        /* Get --console-buffer-size */
+        {
+            const char* arg = NULL;
+
+            if ((cli_getopt(&argc, argv, "--console-buffer-size", &arg) == 0))
+            {
+                char* end = NULL;
+                size_t val = strtoull(arg, &end, 10);
+
+                if (!end || *end != '\0' || val > MYST_MAX_CONSOLE_BUFFER_SIZE)
+                {
+                    fprintf(
+                        stderr,
+                        "%s: bad --console-buffer-size=%s option\n",
+                        argv[0],
+                        arg);
+                    return 1;
+                }
+
+                options.console_buffer_size = val;
+            }
+        }
+
         if (get_fork_mode_opts(&argc, argv, &options.fork_mode) != 0)
         {
             fprintf(
@@ -663,6 +814,12 @@ int exec_action(int argc, const char* argv[], const char* envp[])
     if (test_user_space_fsgsbase() == 0)
         options.have_fsgsbase_instructions = true;
 
+    /* check whether the enclave can execute RDTSC without trapping */
+    options.have_rdtsc_instruction = _have_sgx2();
+
+    /* buffered console output is flushed per line on a terminal */
+    options.console_isatty = isatty(STDOUT_FILENO);
+
     assert(myst_validate_file_path(commandline_config));
     if (extract_roothashes_from_ext2_images(
             rootfs, &mount_mapping, &roothash_buf) != 0)
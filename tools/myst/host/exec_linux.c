@@ -11,8 +11,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/mman.h>
+#include <sys/time.h>
 #include <syscall.h>
 #include <time.h>
+#include <unistd.h>
 
 #include <myst/args.h>
 #include <myst/cpio.h>
@@ -23,6 +25,7 @@
 #include <myst/kernel.h>
 #include <myst/options.h>
 #include <myst/process.h>
+#include <myst/profile.h>
 #include <myst/regions.h>
 #include <myst/reloc.h>
 #include <myst/round.h>
@@ -41,6 +44,8 @@
 #include "regions.h"
 #include "roothash.h"
 #include "strace.h"
+#include "tcallring.h"
+#include "threadpool.h"
 #include "utils.h"
 
 #define USAGE_FORMAT \
@@ -82,6 +87,24 @@ Options:\n\
                             it encounters an unimplemented syscall\n\
                             'true' implies the syscall would not terminate\n\
                             and instead return ENOSYS.\n\
+    --mn-threads <num>   -- multiplex application threads onto at most\n\
+                            <num> host threads (0 disables)\n\
+    --console-buffer-size <size>\n\
+                         -- buffer up to <size> bytes of standard output\n\
+                            and standard error in the kernel (0 disables)\n\
+    --trace-spans <path> -- write the boot phases, execs, tcalls, file system\n\
+                            operations and syscalls to the host file <path>\n\
+                            as a Chrome trace (chrome://tracing)\n\
+    --profile <path>     -- sample the running threads and write their\n\
+                            stacks to the host file <path> in the folded\n\
+                            format used by flamegraph.pl\n\
+    --profile-hz <num>   -- samples per second of CPU time (default 997)\n\
+    --tcall-workers <num>\n\
+                         -- perform host file and socket calls on <num>\n\
+                            worker threads fed through a shared ring\n\
+                            (0 disables, the default)\n\
+    --tcall-spin <num>   -- how many times callers and idle workers poll\n\
+                            the ring before they sleep (default 4096)\n\
 \n\
 "
 
@@ -153,6 +176,84 @@ static void _get_options(
     if (cli_getopt(argc, argv, "--report-native-tids", NULL) == 0)
         opts->report_native_tids = true;
 
+    /* Get --trace-spans option */
+    {
+        const char* arg = NULL;
+
+        if (cli_getopt(argc, argv, "--trace-spans", &arg) == 0 && arg)
+        {
+            const size_t n = sizeof(opts->trace_spans_path);
+
+            if (myst_strlcpy(opts->trace_spans_path, arg, n) >= n)
+                _err("--trace-spans path is too long");
+
+            opts->trace_spans = true;
+        }
+    }
+
+    /* Get --profile option */
+    {
+        const char* arg = NULL;
+
+        if (cli_getopt(argc, argv, "--profile", &arg) == 0 && arg)
+        {
+            const size_t n = sizeof(opts->profile_path);
+
+            if (myst_strlcpy(opts->profile_path, arg, n) >= n)
+                _err("--profile path is too long");
+
+            opts->profile = true;
+        }
+    }
+
+    /* Get --profile-hz option */
+    {
+        const char* arg = NULL;
+
+        if (cli_getopt(argc, argv, "--profile-hz", &arg) == 0)
+        {
+            char* end = NULL;
+            size_t val = strtoull(arg, &end, 10);
+
+            if (!end || *end != '\0' || val == 0 || val > 1000000)
+                _err("bad --profile-hz=%s option", arg);
+
+            opts->profile_hz = val;
+        }
+    }
+
+    /* Get --tcall-workers option */
+    {
+        const char* arg = NULL;
+
+        if (cli_getopt(argc, argv, "--tcall-workers", &arg) == 0)
+        {
+            char* end = NULL;
+            size_t val = strtoull(arg, &end, 10);
+
+            if (!end || *end != '\0' || val > 1024)
+                _err("bad --tcall-workers=%s option", arg);
+
+            opts->tcall_workers = val;
+        }
+    }
+
+    /* Get --tcall-spin option */
+    {
+        const char* arg = NULL;
+
+        if (cli_getopt(argc, argv, "--tcall-spin", &arg) == 0)
+        {
+            char* end = NULL;
+            size_t val = strtoull(arg, &end, 10);
+
+            if (!end || *end != '\0' || val == 0)
+                _err("bad --tcall-spin=%s option", arg);
+
+            opts->tcall_spin = val;
+        }
+    }
+
     /* Get --nobrk option */
     if (cli_getopt(argc, argv, "--host-uds", NULL) == 0)
         opts->nobrk = true;
@@ -180,6 +281,38 @@ static void _get_options(
         }
     }
 
+    /* Get --mn-threads */
+    {
+        const char* arg = NULL;
+
+        if ((cli_getopt(argc, argv, "--mn-threads", &arg) == 0))
+        {
+            char* end = NULL;
+            size_t val = strtoull(arg, &end, 10);
+
+            if (!end || *end != '\0')
+                _err("bad --mn-threads=%s option", arg);
+
+            opts->mn_threads = val;
+        }
+    }
+
+    /* Get --console-buffer-size */
+    {
+        const char* arg = NULL;
+
+        if ((cli_getopt(argc, argv, "--console-buffer-size", &arg) == 0))
+        {
+            char* end = NULL;
+            size_t val = strtoull(arg, &end, 10);
+
+            if (!end || *end != '\0' || val > MYST_MAX_CONSOLE_BUFFER_SIZE)
+                _err("bad --console-buffer-size=%s option", arg);
+
+            opts->console_buffer_size = val;
+        }
+    }
+
     /* determine whether debug symbols are needed */
     {
         int r;
@@ -327,6 +460,58 @@ static void _sigaction_handler(int sig, siginfo_t* si, void* context)
     kernel_args.myst_handle_host_signal(si, mcontext);
 }
 
+/* called by the profiling timer; must not use thread-local storage since
+ * the fs register may hold the thread descriptor of the application */
+static void _profile_handler(int sig, siginfo_t* si, void* context)
+{
+    ucontext_t* ucontext = (ucontext_t*)context;
+    pid_t tid = (pid_t)syscall(SYS_gettid);
+
+    (void)sig;
+    (void)si;
+
+    if (kernel_args.myst_profile_sample)
+        kernel_args.myst_profile_sample(&ucontext->uc_mcontext, tid);
+}
+
+/* sample the threads consuming CPU time with ITIMER_PROF */
+static void _start_profile_timer(size_t hz)
+{
+    struct sigaction sa;
+    struct itimerval it;
+    size_t usec;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_sigaction = _profile_handler;
+
+    if (sigaction(SIGPROF, &sa, NULL) == -1)
+        _err("Failed to register SIGPROF signal handler\n");
+
+    if (hz == 0)
+        hz = MYST_PROFILE_DEFAULT_HZ;
+
+    /* --profile-hz is at most 1000000, so the period is at least 1us */
+    usec = 1000000 / hz;
+
+    memset(&it, 0, sizeof(it));
+    it.it_interval.tv_sec = (time_t)(usec / 1000000);
+    it.it_interval.tv_usec = (suseconds_t)(usec % 1000000);
+    it.it_value = it.it_interval;
+
+    if (setitimer(ITIMER_PROF, &it, NULL) == -1)
+        _err("Failed to start the profiling timer\n");
+}
+
+static void _stop_profile_timer(void)
+{
+    struct itimerval it;
+
+    memset(&it, 0, sizeof(it));
+    setitimer(ITIMER_PROF, &it, NULL);
+}
+
 static void _install_signal_handlers()
 {
     struct sigaction sa;
@@ -502,11 +687,29 @@ static int _enter_kernel(
     kernel_args.exec_stack = final_options.base.exec_stack;
     kernel_args.perf = final_options.base.perf;
     kernel_args.host_uds = final_options.base.host_uds;
+    kernel_args.mn_threads = final_options.base.mn_threads;
+    kernel_args.console_buffer_size = final_options.base.console_buffer_size;
+    kernel_args.trace_spans = final_options.base.trace_spans;
+    memcpy(
+        kernel_args.trace_spans_path,
+        final_options.base.trace_spans_path,
+        sizeof(kernel_args.trace_spans_path));
+    kernel_args.profile = final_options.base.profile;
+    memcpy(
+        kernel_args.profile_path,
+        final_options.base.profile_path,
+        sizeof(kernel_args.profile_path));
 
     /* check whether FSGSBASE instructions are supported */
     if (test_user_space_fsgsbase() == 0)
         kernel_args.have_fsgsbase_instructions = true;
 
+    /* RDTSC never traps outside of an enclave */
+    kernel_args.have_rdtsc_instruction = true;
+
+    /* buffered console output is flushed per line on a terminal */
+    kernel_args.console_isatty = isatty(STDOUT_FILENO);
+
     /* pass the start time into the kernel */
     {
         struct timespec start_time;
@@ -542,8 +745,28 @@ static int _enter_kernel(
 
     _install_signal_handlers();
 
+    if (final_options.base.tcall_workers)
+    {
+        long r = tcall_ring_start(
+            final_options.base.tcall_workers,
+            final_options.base.tcall_spin,
+            myst_tcall);
+
+        if (r != 0)
+        {
+            snprintf(err, err_size, "failed to start tcall workers: %ld", r);
+            ERAISE(-EINVAL);
+        }
+    }
+
+    if (kernel_args.profile)
+        _start_profile_timer(final_options.base.profile_hz);
+
     *return_status = (*entry)(&kernel_args);
 
+    if (kernel_args.profile)
+        _stop_profile_timer();
+
 done:
 
     cleanup_alt_stack();
@@ -559,6 +782,10 @@ done:
 
 __attribute__((__unused__)) static long _tcall(long n, long params[6])
 {
+    /* hand host file and socket calls to the workers of --tcall-workers */
+    if (tcall_ring_accepts(n))
+        return tcall_ring_call(n, params);
+
     return myst_tcall(n, params);
 }
 
@@ -704,6 +931,12 @@ int exec_linux_action(int argc, const char* argv[], const char* envp[])
         _err("%s", err);
     }
 
+    if (opts.perf)
+    {
+        thread_pool_dump_stats(stdout);
+        tcall_ring_dump_stats(stdout);
+    }
+
     /* unblock MYST_INTERRUPT_THREAD_SIGNAL when outside the enclave */
     sigprocmask(SIG_UNBLOCK, &set, NULL);
 
@@ -728,11 +961,13 @@ int exec_linux_action(int argc, const char* argv[], const char* envp[])
 **==============================================================================
 */
 
-static void* _thread_func(void* arg)
+static void _run_thread(uint64_t cookie)
 {
-    uint64_t cookie = (uint64_t)arg;
     uint64_t event = (uint64_t)&_thread_event;
 
+    /* discard any wake left over from a previous thread on this host thread */
+    _thread_event = 0;
+
     /* Setup thread specific alt stack for handling SIGSEGV signals */
     setup_alt_stack();
 
@@ -753,26 +988,9 @@ static void* _thread_func(void* arg)
 
     /* unblock MYST_INTERRUPT_THREAD_SIGNAL when outside the enclave */
     sigprocmask(SIG_UNBLOCK, &set, NULL);
-
-    return NULL;
 }
 
 long myst_tcall_create_thread(uint64_t cookie)
 {
-    long ret = 0;
-    pthread_t t;
-    pthread_attr_t attr;
-
-    pthread_attr_init(&attr);
-    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
-
-    if (pthread_create(&t, &attr, _thread_func, (void*)cookie) != 0)
-    {
-        ret = -EINVAL;
-        goto done;
-    }
-
-done:
-    pthread_attr_destroy(&attr);
-    return ret;
+    return thread_pool_create_thread(_run_thread, cookie);
 }
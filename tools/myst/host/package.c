@@ -838,6 +838,9 @@ int _exec_package(
     options.nobrk = parsed_data.no_brk;
     options.exec_stack = parsed_data.exec_stack;
     options.host_uds = parsed_data.host_uds;
+    options.mn_threads = parsed_data.mn_threads;
+    options.console_buffer_size = parsed_data.console_buffer_size;
+    options.console_isatty = isatty(STDOUT_FILENO);
 
     if ((details = create_region_details_from_package(
              &sections, parsed_data.heap_pages)) == NULL)
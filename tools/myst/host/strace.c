@@ -15,9 +15,24 @@ int myst_parse_strace_config(
 {
     int ret = -1;
     const char* filter = NULL;
+    const char* binary_path = NULL;
     char** tokens = NULL;
     size_t num_tokens = 0;
 
+    /* record syscalls in binary form (decode with strace-decode) */
+    if (cli_getopt(argc, argv, "--strace-binary", &binary_path) == 0 &&
+        binary_path)
+    {
+        const size_t n = sizeof(strace_config->binary_path);
+
+        if (myst_strlcpy(strace_config->binary_path, binary_path, n) >= n)
+        {
+            fprintf(stderr, "--strace-binary path is too long\n");
+            abort();
+        }
+        strace_config->binary = 1;
+    }
+
     if (cli_getopt(argc, argv, "--strace-failing", NULL) == 0)
     {
         strace_config->trace_failing = 1;
@@ -4,19 +4,23 @@
 #include <myst/assume.h>
 #include <myst/defs.h>
 #include <myst/eraise.h>
+#include <myst/mmsgbuf.h>
 #include <myst/syscall.h>
 #include <myst/tcall.h>
 #include <sched.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <sys/syscall.h>
 #include <unistd.h>
 
 #include "myst_u.h"
+#include "tcallring.h"
 
 #define RETURN(EXPR)                     \
     do                                   \
@@ -108,6 +112,61 @@ long myst_write_block_ocall(int fd, const void* buf, size_t count)
         SYS_write, fd, POLLOUT, true, fd, buf, count);
 }
 
+void* myst_staging_alloc_ocall(size_t size)
+{
+    void* addr = mmap(
+        NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    return (addr == MAP_FAILED) ? NULL : addr;
+}
+
+long myst_staged_io_ocall(
+    long n,
+    int fd,
+    void* buf,
+    size_t count,
+    off_t offset)
+{
+    switch (n)
+    {
+        case SYS_read:
+            RETURN(read(fd, buf, count));
+        case SYS_write:
+            RETURN(write(fd, buf, count));
+        case SYS_pread64:
+            RETURN(pread(fd, buf, count, offset));
+        case SYS_pwrite64:
+            RETURN(pwrite(fd, buf, count, offset));
+        default:
+            return -ENOSYS;
+    }
+}
+
+long myst_staged_io_block_ocall(long n, int fd, void* buf, size_t count)
+{
+    if (n != SYS_read && n != SYS_write)
+        return -ENOSYS;
+
+    return myst_interruptible_syscall(
+        n, fd, (n == SYS_read) ? POLLIN : POLLOUT, true, fd, buf, count);
+}
+
+void* myst_tcall_ring_ocall(void)
+{
+    return tcall_ring_get();
+}
+
+void myst_tcall_ring_wake_ocall(void)
+{
+    tcall_ring_wake();
+}
+
+void myst_tcall_ring_wait_ocall(void* request)
+{
+    if (request)
+        tcall_ring_wait((myst_tcall_request_t*)request);
+}
+
 long myst_close_ocall(int fd)
 {
     RETURN(close(fd));
@@ -480,6 +539,202 @@ done:
     return ret;
 }
 
+/* Point a message vector at the regions of a flattened data buffer (see
+ * myst/mmsgbuf.h). The caller frees *msgvec_out.
+ */
+static long _mmsgbuf_to_msgvec(
+    const struct myst_mmsgbuf_hdr* hdrs,
+    unsigned int vlen,
+    const void* data,
+    size_t size,
+    struct mmsghdr** msgvec_out)
+{
+    long ret = 0;
+    struct mmsghdr* msgvec = NULL;
+    struct iovec* iov;
+    uint8_t* base = (uint8_t*)data;
+    size_t offset = 0;
+
+    *msgvec_out = NULL;
+
+    if (!hdrs || vlen == 0 || vlen > MYST_MMSGBUF_MAX_VLEN)
+    {
+        ret = -EINVAL;
+        goto done;
+    }
+
+    /* the IO vectors follow the message vector in the same allocation */
+    if (!(msgvec = calloc(vlen, sizeof(struct mmsghdr) + sizeof(struct iovec))))
+    {
+        ret = -ENOMEM;
+        goto done;
+    }
+
+    iov = (struct iovec*)(msgvec + vlen);
+
+    for (unsigned int i = 0; i < vlen; i++)
+    {
+        struct msghdr* msg = &msgvec[i].msg_hdr;
+        long name = myst_mmsgbuf_take(size, &offset, hdrs[i].namelen);
+        long control = myst_mmsgbuf_take(size, &offset, hdrs[i].controllen);
+        long payload = myst_mmsgbuf_take(size, &offset, hdrs[i].len);
+
+        if (name < 0 || control < 0 || payload < 0)
+        {
+            ret = -EINVAL;
+            goto done;
+        }
+
+        iov[i].iov_base = base + payload;
+        iov[i].iov_len = hdrs[i].len;
+        msg->msg_name = hdrs[i].namelen ? base + name : NULL;
+        msg->msg_namelen = hdrs[i].namelen;
+        msg->msg_iov = &iov[i];
+        msg->msg_iovlen = 1;
+        msg->msg_control = hdrs[i].controllen ? base + control : NULL;
+        msg->msg_controllen = hdrs[i].controllen;
+    }
+
+    *msgvec_out = msgvec;
+    msgvec = NULL;
+
+done:
+
+    if (msgvec)
+        free(msgvec);
+
+    return ret;
+}
+
+static long _sendmmsg(
+    int sockfd,
+    struct myst_mmsgbuf_hdr* hdrs,
+    unsigned int vlen,
+    const void* data,
+    size_t size,
+    int flags,
+    bool block)
+{
+    long ret = 0;
+    struct mmsghdr* msgvec = NULL;
+
+    if ((ret = _mmsgbuf_to_msgvec(hdrs, vlen, data, size, &msgvec)) < 0)
+        goto done;
+
+    if (block)
+    {
+        /* Don't retry EAGAIN|EINPPROGRESS if this flag is present */
+        const bool retry = !(flags & MSG_DONTWAIT);
+
+        ret = myst_interruptible_syscall(
+            SYS_sendmmsg, sockfd, POLLOUT, retry, sockfd, msgvec, vlen, flags);
+    }
+    else if ((ret = sendmmsg(sockfd, msgvec, vlen, flags)) < 0)
+    {
+        ret = -errno;
+    }
+
+    for (long i = 0; i < ret; i++)
+        hdrs[i].len = msgvec[i].msg_len;
+
+done:
+
+    if (msgvec)
+        free(msgvec);
+
+    return ret;
+}
+
+static long _recvmmsg(
+    int sockfd,
+    struct myst_mmsgbuf_hdr* hdrs,
+    unsigned int vlen,
+    void* data,
+    size_t size,
+    int flags,
+    bool block)
+{
+    long ret = 0;
+    struct mmsghdr* msgvec = NULL;
+
+    if ((ret = _mmsgbuf_to_msgvec(hdrs, vlen, data, size, &msgvec)) < 0)
+        goto done;
+
+    if (block)
+    {
+        /* Don't retry EAGAIN|EINPPROGRESS if these flags are present */
+        const bool retry = !(flags & (MSG_ERRQUEUE | MSG_DONTWAIT));
+
+        ret = myst_interruptible_syscall(
+            SYS_recvmmsg, sockfd, POLLIN, retry, sockfd, msgvec, vlen, flags);
+    }
+    else if ((ret = recvmmsg(sockfd, msgvec, vlen, flags, NULL)) < 0)
+    {
+        ret = -errno;
+    }
+
+    for (long i = 0; i < ret; i++)
+    {
+        const struct msghdr* msg = &msgvec[i].msg_hdr;
+
+        hdrs[i].len = msgvec[i].msg_len;
+        hdrs[i].namelen = msg->msg_namelen;
+        hdrs[i].controllen = msg->msg_controllen;
+        hdrs[i].flags = msg->msg_flags;
+    }
+
+done:
+
+    if (msgvec)
+        free(msgvec);
+
+    return ret;
+}
+
+long myst_sendmmsg_ocall(
+    int sockfd,
+    struct myst_mmsgbuf_hdr* hdrs,
+    unsigned int vlen,
+    const void* data,
+    size_t size,
+    int flags)
+{
+    return _sendmmsg(sockfd, hdrs, vlen, data, size, flags, false);
+}
+
+long myst_sendmmsg_block_ocall(
+    int sockfd,
+    struct myst_mmsgbuf_hdr* hdrs,
+    unsigned int vlen,
+    const void* data,
+    size_t size,
+    int flags)
+{
+    return _sendmmsg(sockfd, hdrs, vlen, data, size, flags, true);
+}
+
+long myst_recvmmsg_ocall(
+    int sockfd,
+    struct myst_mmsgbuf_hdr* hdrs,
+    unsigned int vlen,
+    void* data,
+    size_t size,
+    int flags)
+{
+    return _recvmmsg(sockfd, hdrs, vlen, data, size, flags, false);
+}
+
+long myst_recvmmsg_block_ocall(
+    int sockfd,
+    struct myst_mmsgbuf_hdr* hdrs,
+    unsigned int vlen,
+    void* data,
+    size_t size,
+    int flags)
+{
+    return _recvmmsg(sockfd, hdrs, vlen, data, size, flags, true);
+}
+
 long myst_shutdown_ocall(int sockfd, int how)
 {
     RETURN(shutdown(sockfd, how));
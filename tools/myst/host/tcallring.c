@@ -0,0 +1,424 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <myst/tcall.h>
+
+#include "tcallring.h"
+
+/*
+**==============================================================================
+**
+** switchless tcalls:
+**
+**     Callers place a request in the ring (see myst/tcallring.h). A worker
+**     that dequeues a request performs the tcall and marks the request done;
+**     the caller polls for this and parks on the request's state if the
+**     worker takes longer than the spin budget. Idle workers poll the queue
+**     for the same budget and then park on wake_seq, which callers bump when
+**     workers are asleep. Linux-target callers keep their request on their
+**     own stack; enclave callers keep theirs in host memory and park and wake
+**     the workers through tcall_ring_wait() and tcall_ring_wake() (OCALLs).
+**
+**     A worker must never block on behalf of a caller: myst_interrupt_thread()
+**     signals the caller's thread, which would leave the worker stuck (and
+**     taken) until the host fd became ready. So a worker declines reads and
+**     writes on fds that are neither in non-blocking mode nor regular files
+**     (or block devices) and the caller performs them itself. Mystikos puts
+**     host sockets in non-blocking mode, so these are mostly the pipes, FIFOs
+**     and terminals opened through hostfs.
+**
+**==============================================================================
+*/
+
+_Static_assert(
+    (MYST_TCALL_RING_SIZE & MYST_TCALL_RING_MASK) == 0,
+    "not a power of two");
+
+static myst_tcall_ring_t _ring;
+
+static size_t _num_workers;
+static long (*_handler)(long n, long params[6]);
+
+static _Atomic(size_t) _num_full;
+static _Atomic(size_t) _num_declined;
+static _Atomic(size_t) _num_caller_parks;
+static _Atomic(size_t) _num_worker_parks;
+
+static void _pause(void)
+{
+    __asm__ __volatile__("pause" : : : "memory");
+}
+
+static void _futex_wait(int* uaddr, int val)
+{
+    syscall(SYS_futex, uaddr, FUTEX_WAIT_PRIVATE, val, NULL);
+}
+
+static void _futex_wake(int* uaddr)
+{
+    syscall(SYS_futex, uaddr, FUTEX_WAKE_PRIVATE, 1);
+}
+
+static myst_tcall_request_t* _dequeue(void)
+{
+    size_t pos = __atomic_load_n(&_ring.dequeue_pos, __ATOMIC_RELAXED);
+    myst_tcall_request_t* request;
+    myst_tcall_ring_cell_t* cell;
+
+    for (;;)
+    {
+        cell = &_ring.cells[pos & MYST_TCALL_RING_MASK];
+        size_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+        if (diff == 0)
+        {
+            if (__atomic_compare_exchange_n(
+                    &_ring.dequeue_pos,
+                    &pos,
+                    pos + 1,
+                    true,
+                    __ATOMIC_RELAXED,
+                    __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            /* the ring is empty */
+            return NULL;
+        }
+        else
+        {
+            pos = __atomic_load_n(&_ring.dequeue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    request = cell->request;
+    __atomic_store_n(
+        &cell->seq, pos + MYST_TCALL_RING_SIZE, __ATOMIC_RELEASE);
+
+    return request;
+}
+
+/* whether the tcall may wait for its host fd to become ready */
+static bool _may_block(long n, long params[6])
+{
+    int flags;
+    struct stat st;
+
+    switch (n)
+    {
+        case SYS_read:
+        case SYS_write:
+        case SYS_readv:
+        case SYS_writev:
+        case SYS_recvfrom:
+        case SYS_sendto:
+        case SYS_recvmsg:
+        case SYS_sendmsg:
+        case SYS_recvmmsg:
+        case SYS_sendmmsg:
+            break;
+        default:
+            return false;
+    }
+
+    /* on failure, let the caller perform the call and report the error */
+    if ((flags = fcntl((int)params[0], F_GETFL)) < 0)
+        return true;
+
+    if (flags & O_NONBLOCK)
+        return false;
+
+    /* regular files and block devices are always ready */
+    if (fstat((int)params[0], &st) != 0)
+        return true;
+
+    return !S_ISREG(st.st_mode) && !S_ISBLK(st.st_mode);
+}
+
+static void _complete(myst_tcall_request_t* request)
+{
+    int* state = &request->state;
+
+    if (_may_block(request->n, request->params))
+    {
+        _num_declined++;
+        request->declined = true;
+    }
+    else
+    {
+        request->ret = (*_handler)(request->n, request->params);
+    }
+
+    /* The caller may return as soon as it sees the request done, so the futex
+     * wake may hit a stack slot that was reused; the host futex waiters all
+     * recheck their condition, so a stray wake is harmless. */
+    if (__atomic_exchange_n(state, MYST_TCALL_REQUEST_DONE, __ATOMIC_ACQ_REL) ==
+        MYST_TCALL_REQUEST_WAITING)
+    {
+        _futex_wake(state);
+    }
+}
+
+static myst_tcall_request_t* _poll(void)
+{
+    myst_tcall_request_t* request;
+
+    for (size_t i = 0; i < _ring.spin; i++)
+    {
+        if ((request = _dequeue()))
+            return request;
+
+        _pause();
+    }
+
+    return _dequeue();
+}
+
+static void* _worker_func(void* arg)
+{
+    (void)arg;
+
+    for (;;)
+    {
+        myst_tcall_request_t* request;
+        int seq;
+
+        if ((request = _poll()))
+        {
+            _complete(request);
+            continue;
+        }
+
+        /* announce the sleep before the last check of the queue so that a
+         * caller either sees the sleeper or the worker sees its request */
+        __atomic_fetch_add(&_ring.num_sleeping, 1, __ATOMIC_SEQ_CST);
+        seq = __atomic_load_n(&_ring.wake_seq, __ATOMIC_SEQ_CST);
+
+        if ((request = _dequeue()))
+        {
+            __atomic_fetch_sub(&_ring.num_sleeping, 1, __ATOMIC_SEQ_CST);
+            _complete(request);
+            continue;
+        }
+
+        _num_worker_parks++;
+        _futex_wait(&_ring.wake_seq, seq);
+        __atomic_fetch_sub(&_ring.num_sleeping, 1, __ATOMIC_SEQ_CST);
+    }
+
+    return NULL;
+}
+
+long tcall_ring_start(
+    size_t num_workers,
+    size_t spin,
+    long (*handler)(long n, long params[6]))
+{
+    pthread_attr_t attr;
+    sigset_t set;
+    sigset_t old;
+    long ret = 0;
+
+    for (size_t i = 0; i < MYST_TCALL_RING_SIZE; i++)
+        _ring.cells[i].seq = i;
+
+    _ring.spin = spin ? spin : TCALL_RING_DEFAULT_SPIN;
+    _handler = handler;
+
+    /* host signals (such as the profiling timer) target the kernel threads,
+     * so the workers inherit a mask that blocks all of them */
+    sigfillset(&set);
+    pthread_sigmask(SIG_SETMASK, &set, &old);
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    for (size_t i = 0; i < num_workers; i++)
+    {
+        pthread_t t;
+        int r;
+
+        if ((r = pthread_create(&t, &attr, _worker_func, NULL)) != 0)
+        {
+            ret = -r;
+            break;
+        }
+
+        __atomic_fetch_add(&_num_workers, 1, __ATOMIC_RELEASE);
+    }
+
+    pthread_attr_destroy(&attr);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    return ret;
+}
+
+myst_tcall_ring_t* tcall_ring_get(void)
+{
+    return __atomic_load_n(&_num_workers, __ATOMIC_ACQUIRE) ? &_ring : NULL;
+}
+
+bool tcall_ring_accepts(long n)
+{
+    if (_num_workers == 0)
+        return false;
+
+    /* The blocking variants (MYST_TCALL_READ_BLOCK and friends) stay on the
+     * caller's thread since myst_interrupt_thread() signals that thread.
+     * So do calls whose result depends on the caller's thread, such as
+     * the ones performed under the caller's identity (open, stat). Reads
+     * and writes are accepted here but declined by the worker if their fd
+     * could block (see _may_block()). */
+    switch (n)
+    {
+        case SYS_read:
+        case SYS_write:
+        case SYS_pread64:
+        case SYS_pwrite64:
+        case SYS_preadv:
+        case SYS_pwritev:
+        case SYS_readv:
+        case SYS_writev:
+        case SYS_lseek:
+        case SYS_fstat:
+        case SYS_fstatfs:
+        case SYS_ftruncate:
+        case SYS_fsync:
+        case SYS_fdatasync:
+        case SYS_getdents64:
+        case SYS_close:
+        case SYS_recvfrom:
+        case SYS_sendto:
+        case SYS_recvmsg:
+        case SYS_sendmsg:
+        case SYS_recvmmsg:
+        case SYS_sendmmsg:
+        case SYS_bind:
+        case SYS_listen:
+        case SYS_shutdown:
+        case SYS_getsockname:
+        case SYS_getpeername:
+        case SYS_setsockopt:
+        case SYS_getsockopt:
+        case SYS_epoll_ctl:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void tcall_ring_wake(void)
+{
+    __atomic_fetch_add(&_ring.wake_seq, 1, __ATOMIC_SEQ_CST);
+    _futex_wake(&_ring.wake_seq);
+}
+
+void tcall_ring_wait(myst_tcall_request_t* request)
+{
+    _num_caller_parks++;
+
+    while (__atomic_load_n(&request->state, __ATOMIC_ACQUIRE) ==
+           MYST_TCALL_REQUEST_WAITING)
+    {
+        _futex_wait(&request->state, MYST_TCALL_REQUEST_WAITING);
+    }
+}
+
+long tcall_ring_call(long n, long params[6])
+{
+    myst_tcall_request_t request = {.n = n};
+    int expected = MYST_TCALL_REQUEST_PENDING;
+
+    for (size_t i = 0; i < 6; i++)
+        request.params[i] = params[i];
+
+    if (!myst_tcall_ring_enqueue(&_ring, &request))
+    {
+        _num_full++;
+        return myst_tcall(n, params);
+    }
+
+    if (myst_tcall_ring_has_sleepers(&_ring))
+        tcall_ring_wake();
+
+    for (size_t i = 0; i < _ring.spin; i++)
+    {
+        if (__atomic_load_n(&request.state, __ATOMIC_ACQUIRE) ==
+            MYST_TCALL_REQUEST_DONE)
+        {
+            break;
+        }
+
+        _pause();
+    }
+
+    if (__atomic_compare_exchange_n(
+            &request.state,
+            &expected,
+            MYST_TCALL_REQUEST_WAITING,
+            false,
+            __ATOMIC_ACQ_REL,
+            __ATOMIC_ACQUIRE))
+    {
+        tcall_ring_wait(&request);
+    }
+
+    if (request.declined)
+        return myst_tcall(n, params);
+
+    return request.ret;
+}
+
+long tcall_ring_syscall(long n, long params[6])
+{
+    long ret;
+
+    /* the calls that enclave threads submit (see _ring_io() in the enclave) */
+    switch (n)
+    {
+        case SYS_read:
+        case SYS_write:
+        case SYS_pread64:
+        case SYS_pwrite64:
+            break;
+        default:
+            return -ENOSYS;
+    }
+
+    ret = syscall(n, params[0], params[1], params[2], params[3]);
+
+    return (ret < 0) ? -errno : ret;
+}
+
+void tcall_ring_dump_stats(FILE* stream)
+{
+    if (_num_workers == 0)
+        return;
+
+    fprintf(
+        stream,
+        "=== tcall ring: workers=%zu spin=%zu full=%zu declined=%zu "
+        "caller_parks=%zu worker_parks=%zu\n",
+        _num_workers,
+        _ring.spin,
+        (size_t)_num_full,
+        (size_t)_num_declined,
+        (size_t)_num_caller_parks,
+        (size_t)_num_worker_parks);
+}
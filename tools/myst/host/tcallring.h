@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef _MYST_HOST_TCALLRING_H
+#define _MYST_HOST_TCALLRING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include <myst/tcallring.h>
+
+/* How many times a caller polls for the completion of its request (and an
+ * idle worker polls for new requests) before parking on a futex. Override
+ * with the --tcall-spin option. Polling only pays off when the workers have
+ * cores of their own; on a loaded host a small value parks sooner.
+ */
+#define TCALL_RING_DEFAULT_SPIN 4096
+
+// Start num_workers host threads that perform the submitted tcalls with
+// handler (myst_tcall() on the linux target, tcall_ring_syscall() on the SGX
+// target). Waiting callers and idle workers poll spin times before they park.
+// Returns 0 on success or -errno on failure.
+long tcall_ring_start(
+    size_t num_workers,
+    size_t spin,
+    long (*handler)(long n, long params[6]));
+
+// Return the ring if it has workers or null otherwise.
+myst_tcall_ring_t* tcall_ring_get(void);
+
+// Return true if the ring is running and tcall n may be performed by one of
+// its workers. These are the non-blocking host file, socket and epoll calls
+// that do not depend on the identity or thread-local state of the caller.
+// Reads and writes that could wait for their fd (not in non-blocking mode
+// and not a regular file) are handed back to the caller by the worker.
+bool tcall_ring_accepts(long n);
+
+// Submit tcall n to the ring and wait for a worker to complete it. Returns
+// the result of the tcall.
+long tcall_ring_call(long n, long params[6]);
+
+// Wake a parked worker after a request was added to the ring.
+void tcall_ring_wake(void);
+
+// Park until a worker completes a request in the waiting state.
+void tcall_ring_wait(myst_tcall_request_t* request);
+
+// Perform a read or write submitted by an enclave thread on a host buffer
+// (SYS_read, SYS_write, SYS_pread64 or SYS_pwrite64). Returns the result or
+// -errno.
+long tcall_ring_syscall(long n, long params[6]);
+
+// Print how often callers and workers parked, how often the ring was full and
+// how often a worker handed a call back to its caller.
+void tcall_ring_dump_stats(FILE* stream);
+
+#endif /* _MYST_HOST_TCALLRING_H */
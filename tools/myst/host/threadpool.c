@@ -0,0 +1,211 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "threadpool.h"
+
+/* latency buckets: [0,1), [1,2), [2,4), ... microseconds */
+#define NUM_BUCKETS 24
+
+typedef struct worker
+{
+    struct worker* next;
+    thread_pool_run_t run;
+    uint64_t cookie;
+
+    /* when the thread was requested (nanoseconds) */
+    uint64_t start;
+
+    /* affinity of the creating thread (reused workers must inherit it) */
+    cpu_set_t affinity;
+    bool have_affinity;
+
+    /* set to non-zero when a new cookie is handed to a parked worker */
+    volatile int futex;
+} worker_t;
+
+static pthread_mutex_t _lock = PTHREAD_MUTEX_INITIALIZER;
+static worker_t* _idle;
+static size_t _num_idle;
+static size_t _max_idle = THREAD_POOL_DEFAULT_SIZE;
+static pthread_once_t _once = PTHREAD_ONCE_INIT;
+
+static _Atomic(size_t) _num_created;
+static _Atomic(size_t) _num_reused;
+static _Atomic(size_t) _histogram[NUM_BUCKETS];
+
+static void _init(void)
+{
+    const char* env;
+
+    if ((env = getenv("MYST_THREAD_POOL_SIZE")))
+    {
+        char* end = NULL;
+        size_t val = strtoul(env, &end, 10);
+
+        if (end && *end == '\0')
+            _max_idle = val;
+    }
+}
+
+static uint64_t _now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000UL + (uint64_t)ts.tv_nsec;
+}
+
+static void _record_latency(uint64_t start)
+{
+    uint64_t usecs = (_now() - start) / 1000;
+    size_t i = 0;
+
+    while (usecs && i < NUM_BUCKETS - 1)
+    {
+        usecs >>= 1;
+        i++;
+    }
+
+    _histogram[i]++;
+}
+
+/* park the worker on the idle list; returns false if the pool is full */
+static bool _park(worker_t* worker)
+{
+    bool parked = false;
+
+    pthread_mutex_lock(&_lock);
+    {
+        if (_num_idle < _max_idle)
+        {
+            worker->futex = 0;
+            worker->next = _idle;
+            _idle = worker;
+            _num_idle++;
+            parked = true;
+        }
+    }
+    pthread_mutex_unlock(&_lock);
+
+    if (!parked)
+        return false;
+
+    while (__atomic_load_n(&worker->futex, __ATOMIC_ACQUIRE) == 0)
+        syscall(SYS_futex, &worker->futex, FUTEX_WAIT_PRIVATE, 0, NULL);
+
+    return true;
+}
+
+static void* _worker_func(void* arg)
+{
+    worker_t* worker = (worker_t*)arg;
+
+    do
+    {
+        /* a parked worker may still carry the last guest thread's pinning */
+        if (worker->have_affinity)
+        {
+            sched_setaffinity(0, sizeof(cpu_set_t), &worker->affinity);
+            worker->have_affinity = false;
+        }
+
+        _record_latency(worker->start);
+        (*worker->run)(worker->cookie);
+    } while (_park(worker));
+
+    free(worker);
+    return NULL;
+}
+
+long thread_pool_create_thread(thread_pool_run_t run, uint64_t cookie)
+{
+    const uint64_t start = _now();
+    worker_t* worker;
+    pthread_t t;
+    pthread_attr_t attr;
+    int r;
+
+    pthread_once(&_once, _init);
+
+    /* reuse a parked worker if any */
+    pthread_mutex_lock(&_lock);
+    {
+        if ((worker = _idle))
+        {
+            _idle = worker->next;
+            _num_idle--;
+        }
+    }
+    pthread_mutex_unlock(&_lock);
+
+    if (worker)
+    {
+        worker->run = run;
+        worker->cookie = cookie;
+        worker->start = start;
+        worker->have_affinity =
+            sched_getaffinity(0, sizeof(cpu_set_t), &worker->affinity) == 0;
+        __atomic_store_n(&worker->futex, 1, __ATOMIC_RELEASE);
+        syscall(SYS_futex, &worker->futex, FUTEX_WAKE_PRIVATE, 1);
+        _num_reused++;
+        return 0;
+    }
+
+    if (!(worker = calloc(1, sizeof(worker_t))))
+        return -ENOMEM;
+
+    worker->run = run;
+    worker->cookie = cookie;
+    worker->start = start;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    r = pthread_create(&t, &attr, _worker_func, worker);
+    pthread_attr_destroy(&attr);
+
+    if (r != 0)
+    {
+        free(worker);
+        return -r;
+    }
+
+    _num_created++;
+    return 0;
+}
+
+void thread_pool_dump_stats(FILE* stream)
+{
+    fprintf(
+        stream,
+        "=== thread pool: created=%zu reused=%zu max_idle=%zu\n",
+        (size_t)_num_created,
+        (size_t)_num_reused,
+        _max_idle);
+
+    fprintf(stream, "=== thread create latency (usecs):\n");
+
+    for (size_t i = 0; i < NUM_BUCKETS; i++)
+    {
+        const size_t lo = i == 0 ? 0 : (1UL << (i - 1));
+        const size_t count = _histogram[i];
+
+        if (count == 0)
+            continue;
+
+        if (i == NUM_BUCKETS - 1)
+            fprintf(stream, "    [%zu, inf): %zu\n", lo, count);
+        else
+            fprintf(stream, "    [%zu, %zu): %zu\n", lo, 1UL << i, count);
+    }
+}
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef _MYST_HOST_THREADPOOL_H
+#define _MYST_HOST_THREADPOOL_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* runs a single enclave thread to completion on the calling host thread */
+typedef void (*thread_pool_run_t)(uint64_t cookie);
+
+/* The maximum number of idle host threads kept parked for reuse. Override
+ * with the MYST_THREAD_POOL_SIZE environment variable (0 disables reuse).
+ */
+#define THREAD_POOL_DEFAULT_SIZE 16
+
+// Run the enclave thread given by cookie on a parked host thread if one is
+// available, else on a newly created (detached) host thread. When the enclave
+// thread exits, the host thread parks itself until it is handed another
+// cookie (or exits if the pool is already full). Returns 0 on success or
+// -errno on failure.
+long thread_pool_create_thread(thread_pool_run_t run, uint64_t cookie);
+
+// Print the number of created versus reused host threads and the thread
+// creation latency distribution (from request until the thread starts).
+void thread_pool_dump_stats(FILE* stream);
+
+#endif /* _MYST_HOST_THREADPOOL_H */
@@ -57,6 +57,11 @@ long determine_final_options(
         cmdline_opts->host_enc_uid_gid_mappings;
     final_opts->base.have_fsgsbase_instructions =
         cmdline_opts->have_fsgsbase_instructions;
+    final_opts->base.have_rdtsc_instruction =
+        cmdline_opts->have_rdtsc_instruction;
+    final_opts->base.tcall_workers = cmdline_opts->tcall_workers;
+    final_opts->base.tcall_spin = cmdline_opts->tcall_spin;
+    final_opts->base.console_isatty = cmdline_opts->console_isatty;
 
     // Config always wins, even if it is the default value from config
     if (have_config)
@@ -64,6 +69,9 @@ long determine_final_options(
         final_opts->cwd = parsed_config->cwd;
         final_opts->hostname = parsed_config->hostname;
         final_opts->base.max_affinity_cpus = parsed_config->max_affinity_cpus;
+        final_opts->base.mn_threads = parsed_config->mn_threads;
+        final_opts->base.console_buffer_size =
+            parsed_config->console_buffer_size;
         final_opts->base.main_stack_size = parsed_config->main_stack_size;
         final_opts->base.thread_stack_size = parsed_config->thread_stack_size;
         final_opts->base.fork_mode = parsed_config->fork_mode;
@@ -79,9 +87,20 @@ long determine_final_options(
             final_opts->base.strace_config = cmdline_opts->strace_config;
             final_opts->base.trace_errors = cmdline_opts->trace_errors;
             final_opts->base.trace_times = cmdline_opts->trace_times;
+            final_opts->base.trace_spans = cmdline_opts->trace_spans;
+            memcpy(
+                final_opts->base.trace_spans_path,
+                cmdline_opts->trace_spans_path,
+                sizeof(final_opts->base.trace_spans_path));
             final_opts->base.debug_symbols = cmdline_opts->debug_symbols;
             final_opts->base.memcheck = cmdline_opts->memcheck;
             final_opts->base.perf = cmdline_opts->perf;
+            final_opts->base.profile = cmdline_opts->profile;
+            final_opts->base.profile_hz = cmdline_opts->profile_hz;
+            memcpy(
+                final_opts->base.profile_path,
+                cmdline_opts->profile_path,
+                sizeof(final_opts->base.profile_path));
             final_opts->base.report_native_tids =
                 cmdline_opts->report_native_tids;
         }
@@ -93,9 +112,11 @@ long determine_final_options(
                 sizeof(final_opts->base.strace_config));
             final_opts->base.trace_errors = false;
             final_opts->base.trace_times = false;
+            final_opts->base.trace_spans = false;
             final_opts->base.debug_symbols = false;
             final_opts->base.memcheck = false;
             final_opts->base.perf = false;
+            final_opts->base.profile = false;
             final_opts->base.report_native_tids = false;
         }
     }
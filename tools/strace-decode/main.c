@@ -0,0 +1,255 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <myst/errno.h>
+#include <myst/getopt.h>
+#include <myst/stracebin.h>
+#include <myst/strings.h>
+#include <myst/syscall.h>
+#include <myst/syscallext.h>
+
+static const char _usage[] =
+    "\n"
+    "Usage: %s [options] <strace-file>\n"
+    "\n"
+    "Renders the records written by 'myst exec --strace-binary=<strace-file>'\n"
+    "as strace-style text.\n"
+    "\n"
+    "Options:\n"
+    "    --strace-filter <name:...>  only show the given syscalls\n"
+    "    --strace-failing            only show failing syscalls (combines\n"
+    "                                with --strace-filter)\n"
+    "    --times                     show when each syscall was entered and\n"
+    "                                how long it took\n"
+    "\n";
+
+static const char* _arg0;
+static bool _filter;
+static bool _failing;
+static bool _times;
+static bool _trace[MYST_MAX_SYSCALLS];
+
+static uint64_t _ticks_mult;
+
+__attribute__((format(printf, 1, 2))) static void _err(const char* fmt, ...)
+{
+    va_list ap;
+
+    fprintf(stderr, "%s: ", _arg0);
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    fprintf(stderr, "\n");
+    exit(1);
+}
+
+static void _get_options(int* argc, const char* argv[])
+{
+    char err[128];
+    const char* filter = NULL;
+    int r;
+
+    if ((r = myst_getopt(
+             argc, argv, "--strace-filter", &filter, err, sizeof(err))) < 0)
+    {
+        _err("%s", err);
+    }
+
+    if (r == 0)
+    {
+        char** tokens = NULL;
+        size_t num_tokens = 0;
+
+        if (myst_strsplit(filter, ":", &tokens, &num_tokens) != 0)
+            _err("invalid --strace-filter '%s'", filter);
+
+        for (size_t i = 0; i < num_tokens; i++)
+        {
+            long num = myst_syscall_num(tokens[i]);
+
+            if (num < 0 || num >= MYST_MAX_SYSCALLS)
+                _err("unknown syscall %s in --strace-filter", tokens[i]);
+
+            _trace[num] = true;
+        }
+
+        free(tokens);
+        _filter = true;
+    }
+
+    if (myst_getopt(argc, argv, "--strace-failing", NULL, err, sizeof(err)) ==
+        0)
+    {
+        _failing = true;
+        _filter = true;
+    }
+
+    if (myst_getopt(argc, argv, "--times", NULL, err, sizeof(err)) == 0)
+        _times = true;
+}
+
+/* same rules as _trace_syscall() and _trace_syscall_return() in the kernel */
+static bool _show(const myst_strace_record_t* r)
+{
+    if (!_filter)
+        return true;
+
+    if (r->n >= 0 && r->n < MYST_MAX_SYSCALLS && _trace[r->n])
+        return true;
+
+    if (_failing && r->ret < 0 && myst_error_name(-r->ret))
+        return true;
+
+    return false;
+}
+
+static double _ticks_to_secs(uint64_t ticks)
+{
+    if (_ticks_mult)
+        ticks = (uint64_t)(((__uint128_t)ticks * _ticks_mult) >> 32);
+
+    return (double)ticks / 1e9;
+}
+
+static void _print_arg(long arg)
+{
+    /* small values are most likely integers, others addresses or flags */
+    if (arg > -4096 && arg < 65536)
+        printf("%ld", arg);
+    else
+        printf("0x%lx", arg);
+}
+
+static void _print_record(const myst_strace_record_t* r, uint64_t start_ticks)
+{
+    const char* name = myst_syscall_name(r->n);
+    size_t nparams = 6;
+
+    /* parameters are not typed, so omit the trailing zero ones */
+    while (nparams > 0 && r->params[nparams - 1] == 0)
+        nparams--;
+
+    printf("[pid %5d] ", r->tid);
+
+    if (_times)
+        printf("%.6f ", _ticks_to_secs(r->enter_ticks - start_ticks));
+
+    if (name && strncmp(name, "SYS_", 4) == 0)
+        name += 4;
+
+    if (name)
+        printf("%s(", name);
+    else
+        printf("syscall_%ld(", r->n);
+
+    for (size_t i = 0; i < nparams; i++)
+    {
+        if (i)
+            printf(", ");
+
+        _print_arg(r->params[i]);
+    }
+
+    printf(")");
+
+    if (r->ret < 0 && myst_error_name(-r->ret))
+    {
+        const char* ename = myst_error_name(-r->ret);
+        printf(" = -1 %s (%s)", ename, strerror((int)-r->ret));
+    }
+    else
+    {
+        printf(" = %ld", r->ret);
+    }
+
+    if (_times)
+    {
+        uint64_t lapsed = 0;
+
+        if (r->leave_ticks > r->enter_ticks)
+            lapsed = r->leave_ticks - r->enter_ticks;
+
+        printf(" <%.6f>", _ticks_to_secs(lapsed));
+    }
+
+    printf("\n");
+}
+
+int main(int argc, const char* argv[])
+{
+    FILE* is;
+    myst_strace_header_t header;
+    myst_strace_record_t* records;
+    uint64_t start_ticks = UINT64_MAX;
+
+    _arg0 = argv[0];
+
+    _get_options(&argc, argv);
+
+    if (argc != 2)
+    {
+        fprintf(stderr, _usage, argv[0]);
+        exit(1);
+    }
+
+    if (!(is = fopen(argv[1], "rb")))
+        _err("failed to open %s", argv[1]);
+
+    if (fread(&header, sizeof(header), 1, is) != 1)
+        _err("%s: failed to read header", argv[1]);
+
+    if (header.magic != MYST_STRACE_MAGIC)
+        _err("%s: not a binary strace file", argv[1]);
+
+    if (header.version != MYST_STRACE_VERSION ||
+        header.record_size != sizeof(myst_strace_record_t))
+    {
+        _err("%s: unsupported version: %u", argv[1], header.version);
+    }
+
+    _ticks_mult = header.ticks_mult;
+
+    if (!(records = calloc(header.num_records + 1, sizeof(*records))))
+        _err("out of memory");
+
+    if (fread(records, sizeof(*records), header.num_records, is) !=
+        header.num_records)
+    {
+        _err("%s: truncated file", argv[1]);
+    }
+
+    /* records are in the order the syscalls returned, so times are shown
+     * relative to the earliest entry */
+    for (uint64_t i = 0; i < header.num_records; i++)
+    {
+        if (records[i].enter_ticks < start_ticks)
+            start_ticks = records[i].enter_ticks;
+    }
+
+    for (uint64_t i = 0; i < header.num_records; i++)
+    {
+        if (_show(&records[i]))
+            _print_record(&records[i], start_ticks);
+    }
+
+    if (header.num_dropped)
+    {
+        fprintf(
+            stderr,
+            "%s: %lu older records were overwritten\n",
+            argv[0],
+            header.num_dropped);
+    }
+
+    free(records);
+    fclose(is);
+
+    return 0;
+}
@@ -361,6 +361,7 @@ static const myst_syscall_pair_t _pairs[] = {
     PAIR(SYS_fspick),
     PAIR(SYS_pidfd_open),
     PAIR(SYS_clone3),
+    PAIR(SYS_futex_waitv),
     PAIR(SYS_myst_trace),
     PAIR(SYS_myst_trace_ptr),
     PAIR(SYS_myst_dump_stack),
@@ -381,6 +382,8 @@ static const myst_syscall_pair_t _pairs[] = {
     PAIR(SYS_myst_get_exec_stack_option),
     PAIR(SYS_myst_interrupt_thread),
     PAIR(SYS_myst_pre_launch_hook),
+    PAIR(SYS_myst_get_vdso),
+    PAIR(SYS_myst_batch),
     /* add new entries here! */
     {0, NULL},
 };
@@ -412,6 +415,8 @@ __attribute__((__unused__)) static void _check_myst_syscalls(void)
         case SYS_myst_get_exec_stack_option:
         case SYS_myst_interrupt_thread:
         case SYS_myst_pre_launch_hook:
+        case SYS_myst_get_vdso:
+        case SYS_myst_batch:
             break;
     }
 }